@@ -0,0 +1,116 @@
+/**
+ *  @file Append2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Append2D.hpp"
+#include <iostream>
+
+/**
+ *  Size of an entry in internal nodes (rectangle + hash).
+ */
+#define ENTRY_SIZE_2D (4*sizeof(int32_t) + SHA256_DIGEST_LENGTH)
+
+/**
+ *  Writes the entry of a child as make_internal_2d does.
+ */
+static void put_entry_2d(Buffer &buf, const Node2D *child) {
+  Rectangle r = child->getRect();
+  hash_t h = child->getHash();
+  buf.put(r.lx).put(r.ly).put(r.ux).put(r.uy).put_bytes(h.data(), h.size());
+}
+
+/**
+ *  Creates an empty tree.
+ */
+AppendTree2D::AppendTree2D(size_t capacity, const AttributeStore *attrs)
+: capacity(capacity), attrs(attrs), stats{0, 0, 0} {}
+
+/**
+ *  Frees the tree.
+ */
+AppendTree2D::~AppendTree2D() {
+  if (!spine.empty()) delete_2d_tree(spine.back().node);
+}
+
+/**
+ *  Starts a new right-most leaf once the current one is full.
+ *  The lowest spine node with room seals its last child into its midstate
+ *  and gets a new chain of nodes down to the new leaf; if the whole spine
+ *  is full, the tree grows a new root first.
+ */
+void AppendTree2D::openLeaf() {
+  size_t level = 1;
+  while (level < spine.size() &&
+         static_cast<IntNode2D*>(spine[level].node)->size() == capacity) level++;
+  if (level == spine.size()) {
+    Node2D *old = spine.back().node;
+    spine.push_back({new IntNode2D(old->getRect(), hash_t{}, std::vector<Node2D*>(1, old)), Sha256State()});
+  }
+
+  Buffer buf(ENTRY_SIZE_2D);
+  put_entry_2d(buf, spine[level - 1].node);
+  spine[level].state.update(buf);
+  stats.hashed_bytes += buf.size();
+
+  IntNode2D *parent = static_cast<IntNode2D*>(spine[level].node);
+  for (size_t l = level; l-- > 0;) {
+    Node2D *node = (l == 0) ? (Node2D *) new LeafNode2D(EMPTY_RECT, hash_t{}, std::vector<Point2D>())
+                            : (Node2D *) new IntNode2D(EMPTY_RECT, hash_t{}, std::vector<Node2D*>());
+    parent->children.push_back(node);
+    spine[l] = {node, Sha256State()};
+    if (l > 0) parent = static_cast<IntNode2D*>(node);
+  }
+}
+
+/**
+ *  Appends a point to the last leaf and refreshes the digests of the spine.
+ */
+bool AppendTree2D::append(const Point2D &p) {
+  if (capacity < 2) {
+    std::cerr << "Error: the capacity of an append tree must be at least 2" << std::endl;
+    return false;
+  }
+  if (spine.empty()) {
+    spine.push_back({new LeafNode2D(EMPTY_RECT, hash_t{}, std::vector<Point2D>()), Sha256State()});
+  } else if (static_cast<LeafNode2D*>(spine[0].node)->size() == capacity) {
+    openLeaf();
+  }
+
+  // The points of a leaf never change, so its midstate covers all of them.
+  LeafNode2D *leaf = static_cast<LeafNode2D*>(spine[0].node);
+  Buffer buf(sizeof(uint32_t) + 2 * sizeof(int32_t) + (attrs ? SHA256_DIGEST_LENGTH : 0));
+  if (attrs) {
+    leaf->digests.push_back(attrs->getDigest(p.id));
+    put_point2d(buf, p, leaf->digests.back());
+  } else {
+    put_point2d(buf, p);
+  }
+  leaf->points.push_back(p);
+  leaf->rect = enlarge(leaf->rect, p.loc);
+  leaf->hash = spine[0].state.update(buf).digest();
+  stats.hashed_bytes += buf.size();
+
+  // Each spine node hashes its sealed children's midstate plus its last child.
+  for (size_t l = 1; l < spine.size(); l++) {
+    Node2D *node = spine[l].node;
+    Buffer entry(ENTRY_SIZE_2D);
+    put_entry_2d(entry, spine[l - 1].node);
+    node->rect = enlarge(node->rect, p.loc);
+    node->hash = Sha256State(spine[l].state).update(entry).digest();
+    stats.hashed_bytes += entry.size();
+  }
+  stats.digests += spine.size();
+  stats.appends++;
+  return true;
+}
+
+/**
+ *  Appends a batch of points in order.
+ */
+bool AppendTree2D::append(const std::vector<Point2D> &points) {
+  for (const Point2D &p : points) {
+    if (!append(p)) return false;
+  }
+  return true;
+}
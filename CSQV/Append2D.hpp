@@ -0,0 +1,98 @@
+/**
+ *  @file Append2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Append-only MR-tree with resumable digests along the right spine.
+ *
+ *  Points are appended in arrival order (for instance by time) to the
+ *  right-most leaf. The leaf keeps the SHA-256 midstate of the points it
+ *  already holds, and every internal node on the right spine keeps the
+ *  midstate of its sealed children, i.e. all but the last one. An append
+ *  therefore hashes only the new point and one entry per level, instead
+ *  of rehashing the leaf and every spine node from scratch. The tree is
+ *  always the one build_sorted_2d_tree builds from the points appended
+ *  so far, so its VOs verify with verify_2d.
+ */
+
+#ifndef APPEND2D_H
+#define APPEND2D_H
+
+#include "Node2D.hpp"
+#include <vector>
+
+/**
+ *  Hashing work done by appends.
+ */
+struct AppendStats2D {
+  uint64_t appends;      ///< Points appended
+  uint64_t hashed_bytes; ///< Bytes fed to SHA-256
+  uint64_t digests;      ///< Digests finalized
+};
+
+/**
+ *  Append-only MR-tree.
+ */
+class AppendTree2D {
+private:
+  /**
+   *  A node of the right spine and the midstate of its sealed content.
+   */
+  struct SpineNode2D {
+    Node2D *node;
+    Sha256State state;
+  };
+
+  size_t capacity;                 ///< Maximum number of points per leaf and children per node
+  const AttributeStore *attrs;     ///< Optional attribute store the leaves commit to
+  std::vector<SpineNode2D> spine;  ///< Right spine, from the last leaf up to the root
+  AppendStats2D stats;
+
+  void openLeaf();
+
+public:
+  /**
+   *  Creates an empty tree.
+   *  @param capacity the maximum number of points per leaf and children per node (at least 2)
+   *  @param attrs optional attribute store whose payloads the leaves commit to
+   */
+  AppendTree2D(size_t capacity, const AttributeStore *attrs = nullptr);
+
+  /**
+   *  Frees the tree.
+   */
+  ~AppendTree2D();
+
+  AppendTree2D(const AppendTree2D &) = delete;
+  AppendTree2D &operator=(const AppendTree2D &) = delete;
+
+  /**
+   *  Appends a point to the last leaf, starting a new one if it is full.
+   *  @param p the point
+   *  @return false if the capacity is invalid
+   */
+  bool append(const Point2D &p);
+
+  /**
+   *  Appends a batch of points in order.
+   *  @param points the points
+   *  @return false if the capacity is invalid
+   */
+  bool append(const std::vector<Point2D> &points);
+
+  /**
+   *  Returns the root, or nullptr if the tree is empty. The tree stays
+   *  owned by the AppendTree2D and changes with the next append.
+   */
+  Node2D *getRoot() const { return spine.empty() ? nullptr : spine.back().node; }
+
+  /**
+   *  Returns the root digest.
+   */
+  hash_t getHash() const { return spine.empty() ? hash_t{} : spine.back().node->getHash(); }
+
+  uint64_t size() const { return stats.appends; }
+  uint32_t getHeight() const { return (uint32_t) spine.size(); }
+  const AppendStats2D &getStats() const { return stats; }
+};
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ *  @file Attributes2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Attributes2D.hpp"
+#include "csv.hpp"
+#include <iostream>
+
+/**
+ *  Computes the digest of a column value.
+ */
+hash_t column_digest(uint32_t col, const std::string &value) {
+  Buffer buf(sizeof(uint32_t) + value.size());
+  buf.put(col).put_bytes((uint8_t *) value.data(), value.size());
+  return sha256(buf);
+}
+
+/**
+ *  Computes the payload digest of a record from its column digests.
+ */
+hash_t payload_digest(const std::vector<hash_t> &col_digests) {
+  // An empty buffer has no storage, so hash the empty record as a string.
+  if (col_digests.empty()) return sha256(std::string());
+  Buffer buf(col_digests.size() * SHA256_DIGEST_LENGTH);
+  for (hash_t h : col_digests) buf.put_bytes(h.data(), h.size());
+  return sha256(buf);
+}
+
+/**
+ *  Computes the payload digest of a full record.
+ */
+hash_t payload_digest(const std::vector<std::string> &values) {
+  std::vector<hash_t> col_digests;
+  col_digests.reserve(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    col_digests.push_back(column_digest(i, values[i]));
+  }
+  return payload_digest(col_digests);
+}
+
+/**
+ *  Creates an empty store with the given columns.
+ */
+AttributeStore::AttributeStore(std::vector<std::string> columns)
+: columns(std::move(columns)) {
+  if (this->columns.size() > MAX_COLUMNS) this->columns.resize(MAX_COLUMNS);
+  empty_digest = payload_digest(std::vector<hash_t>());
+}
+
+/**
+ *  Stores the record of a point, replacing any previous one.
+ *  Records are padded or truncated to the number of columns.
+ */
+void AttributeStore::put(uint32_t id, std::vector<std::string> values) {
+  values.resize(columns.size());
+  if (id >= records.size()) {
+    records.resize(id + 1);
+    digests.resize(id + 1, empty_digest);
+  }
+  digests[id] = payload_digest(values);
+  records[id] = std::move(values);
+}
+
+/**
+ *  Returns true if the store holds a record for the given point.
+ */
+bool AttributeStore::has(uint32_t id) const {
+  return id < records.size() && !records[id].empty();
+}
+
+/**
+ *  Returns the record of a point, or an empty record if there is none.
+ */
+const std::vector<std::string> &AttributeStore::get(uint32_t id) const {
+  static const std::vector<std::string> none;
+  return (id < records.size()) ? records[id] : none;
+}
+
+/**
+ *  Returns the payload digest of a point.
+ */
+const hash_t &AttributeStore::getDigest(uint32_t id) const {
+  return (id < digests.size()) ? digests[id] : empty_digest;
+}
+
+/**
+ *  Builds a column mask from a list of column names.
+ */
+ColumnMask AttributeStore::mask(const std::vector<std::string> &names) const {
+  ColumnMask m = 0;
+  for (const std::string &name : names) {
+    for (size_t i = 0; i < columns.size(); i++) {
+      if (columns[i] == name) m |= (ColumnMask(1) << i);
+    }
+  }
+  return m;
+}
+
+/**
+ *  Projects the record of a point on a set of columns.
+ */
+ProjectedRecord project_record(const AttributeStore &attrs, uint32_t id, ColumnMask mask) {
+  ProjectedRecord rec;
+  rec.id = id;
+  rec.mask = mask;
+  const std::vector<std::string> &values = attrs.get(id);
+  for (size_t i = 0; i < values.size(); i++) {
+    if (mask & (ColumnMask(1) << i)) {
+      rec.values.push_back(values[i]);
+    } else {
+      rec.digests.push_back(column_digest(i, values[i]));
+    }
+  }
+  return rec;
+}
+
+/**
+ *  Reconstructs the payload digest of a projected record by merging
+ *  projected values and column digests back in column order.
+ */
+hash_t projected_digest(const ProjectedRecord &rec) {
+  size_t ncols = rec.values.size() + rec.digests.size();
+  if (ncols > MAX_COLUMNS) return hash_t{};
+
+  std::vector<hash_t> col_digests;
+  col_digests.reserve(ncols);
+  size_t v = 0, d = 0;
+  for (size_t i = 0; i < ncols; i++) {
+    if (rec.mask & (ColumnMask(1) << i)) {
+      if (v >= rec.values.size()) return hash_t{};
+      col_digests.push_back(column_digest(i, rec.values[v++]));
+    } else {
+      if (d >= rec.digests.size()) return hash_t{};
+      col_digests.push_back(rec.digests[d++]);
+    }
+  }
+  return payload_digest(col_digests);
+}
+
+/**
+ *  Parses a CSV file into 2D points and their attribute records.
+ */
+AttributeStore load_records_file(const std::string &path, std::vector<Point2D> &points) {
+  points.clear();
+
+  try {
+    csv::CSVReader reader(path);
+    std::vector<std::string> names = reader.get_col_names();
+
+    int x_col = reader.index_of("x"), y_col = reader.index_of("y");
+    if (x_col < 0 || y_col < 0) {
+      std::cerr << "Error loading records file: missing x/y columns" << std::endl;
+      return AttributeStore();
+    }
+
+    std::vector<std::string> columns;
+    for (size_t i = 0; i < names.size(); i++) {
+      if ((int) i != x_col && (int) i != y_col) columns.push_back(names[i]);
+    }
+    AttributeStore attrs(columns);
+
+    uint32_t id = 0;
+    for (csv::CSVRow& row : reader) {
+      std::vector<std::string> values;
+      values.reserve(columns.size());
+      for (size_t i = 0; i < row.size(); i++) {
+        if ((int) i != x_col && (int) i != y_col) values.push_back(row[i].get<std::string>());
+      }
+
+      Point2D point(id, row[x_col].get<int32_t>(), row[y_col].get<int32_t>());
+      points.push_back(point);
+      attrs.put(id, std::move(values));
+      id++;
+    }
+
+    std::cout << "Loaded " << points.size() << " 2D points with "
+              << columns.size() << " attributes from " << path << std::endl;
+    return attrs;
+
+  } catch (const std::exception& e) {
+    std::cerr << "Error loading records file: " << e.what() << std::endl;
+  }
+
+  points.clear();
+  return AttributeStore();
+}
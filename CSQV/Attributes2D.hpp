@@ -0,0 +1,164 @@
+/**
+ *  @file Attributes2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Out-of-line attribute payloads for 2D points.
+ *
+ *  Each point may carry a record of string attributes, stored outside the
+ *  tree and indexed by point ID. A record is committed by its payload
+ *  digest, the hash of the digests of its columns. Leaves of a tree built
+ *  with an attribute store hash (id, x, y, payload digest) for each point,
+ *  so a query may return any subset of the columns (a projection) and
+ *  replace the remaining ones by their column digests.
+ */
+
+#ifndef ATTRIBUTES2D_H
+#define ATTRIBUTES2D_H
+
+#include "Buffer.hpp"
+#include "Hash.hpp"
+#include "Point2D.hpp"
+#include <string>
+#include <vector>
+
+/**
+ *  Set of projected columns: bit i selects column i.
+ */
+typedef uint64_t ColumnMask;
+
+/**
+ *  Maximum number of columns of an attribute store.
+ */
+#define MAX_COLUMNS 64
+
+/**
+ *  Computes the digest of a column value.
+ *  The column index is part of the digest, so columns cannot be swapped.
+ *  @param col the column index
+ *  @param value the column value
+ *  @return the column digest
+ */
+hash_t column_digest(uint32_t col, const std::string &value);
+
+/**
+ *  Computes the payload digest of a record from its column digests.
+ *  @param col_digests the digests of all columns, in column order
+ *  @return the payload digest
+ */
+hash_t payload_digest(const std::vector<hash_t> &col_digests);
+
+/**
+ *  Computes the payload digest of a full record.
+ *  @param values the column values, in column order
+ *  @return the payload digest
+ */
+hash_t payload_digest(const std::vector<std::string> &values);
+
+/**
+ *  Stores the attribute records of the points, indexed by point ID,
+ *  together with their payload digests.
+ */
+class AttributeStore {
+private:
+  std::vector<std::string> columns;              ///< Column names
+  std::vector<std::vector<std::string>> records; ///< Records indexed by point ID
+  std::vector<hash_t> digests;                   ///< Payload digests indexed by point ID
+  hash_t empty_digest;                           ///< Payload digest of an empty record
+
+public:
+  /**
+   *  Creates an empty store with the given columns.
+   *  @param columns the column names (at most MAX_COLUMNS)
+   */
+  AttributeStore(std::vector<std::string> columns = {});
+
+  /**
+   *  Stores the record of a point, replacing any previous one.
+   *  @param id the point ID
+   *  @param values the column values, one per column
+   */
+  void put(uint32_t id, std::vector<std::string> values);
+
+  /**
+   *  Returns true if the store holds a record for the given point.
+   */
+  bool has(uint32_t id) const;
+
+  /**
+   *  Returns the record of a point, or an empty record if there is none.
+   */
+  const std::vector<std::string> &get(uint32_t id) const;
+
+  /**
+   *  Returns the payload digest of a point. Points without a record
+   *  have the digest of the empty record.
+   */
+  const hash_t &getDigest(uint32_t id) const;
+
+  /**
+   *  Returns the column names.
+   */
+  const std::vector<std::string> &getColumns() const { return columns; }
+
+  /**
+   *  Returns the number of records.
+   */
+  size_t size() const { return records.size(); }
+
+  /**
+   *  Builds a column mask from a list of column names.
+   *  Unknown names are ignored.
+   *  @param names the column names
+   *  @return the mask selecting the named columns
+   */
+  ColumnMask mask(const std::vector<std::string> &names) const;
+};
+
+/**
+ *  A record whose non-projected columns are replaced by their digests.
+ */
+struct ProjectedRecord {
+  uint32_t id;                      ///< ID of the point
+  ColumnMask mask;                  ///< Projected columns
+  std::vector<std::string> values;  ///< Values of the projected columns, in column order
+  std::vector<hash_t> digests;      ///< Digests of the other columns, in column order
+};
+
+/**
+ *  Projects the record of a point on a set of columns.
+ *  @param attrs the attribute store
+ *  @param id the point ID
+ *  @param mask the projected columns
+ *  @return the projected record
+ */
+ProjectedRecord project_record(const AttributeStore &attrs, uint32_t id, ColumnMask mask);
+
+/**
+ *  Reconstructs the payload digest of a projected record.
+ *  @param rec the projected record
+ *  @return the payload digest, or a zero digest if the record is malformed
+ */
+hash_t projected_digest(const ProjectedRecord &rec);
+
+/**
+ *  Inserts a 2D point and its payload digest into a buffer for hashing.
+ *  @param buf the buffer
+ *  @param p the 2D point
+ *  @param digest the payload digest of the point
+ */
+static inline void put_point2d(Buffer &buf, const Point2D &p, const hash_t &digest) {
+  put_point2d(buf, p);
+  buf.put_bytes(const_cast<uint8_t*>(digest.data()), digest.size());
+}
+
+/**
+ *  Parses a CSV file into 2D points and their attribute records.
+ *  Columns x and y give the location; all other columns become attributes.
+ *  Generates sequential IDs for points.
+ *  @param path full path of the input file
+ *  @param points output list of 2D points
+ *  @return the attribute store
+ */
+AttributeStore load_records_file(const std::string &path, std::vector<Point2D> &points);
+
+#endif
@@ -42,7 +42,7 @@ size_t Buffer::size() const {
  */
 Buffer &Buffer::put_bytes(uint8_t *data, size_t length) {
   if (data) {
-    for (size_t i = 0; i < length; i++) buf.push_back(data[i]);
+    buf.insert(buf.end(), data, data + length);
   }
   return *this;
 }
@@ -56,7 +56,7 @@ public:
   template<typename T>
   Buffer &put(const T &x) {
     const uint8_t *ptr = reinterpret_cast<const uint8_t*>(&x);
-    for (size_t i = 0; i < sizeof(T); i++) buf.push_back(ptr[i]);
+    buf.insert(buf.end(), ptr, ptr + sizeof(T));
     return *this;
   }
 
@@ -0,0 +1,138 @@
+/**
+ *  @file Delta2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Delta2D.hpp"
+
+/**
+ *  Recursive step of the delta query. in_prev is true if all ancestors of
+ *  root overlap the previous window, i.e. if a leaf reached here was
+ *  shipped for that window.
+ */
+static VObject2D *range_query_delta_2d(Node2D *root, const Rectangle &query,
+                                       const Rectangle &prev, bool in_prev,
+                                       QueryStats2D *stats) {
+  if (stats) stats->nodes_visited++;
+  
+  if (root->getType() == N2D_LEAF) {
+    LeafNode2D *leaf = static_cast<LeafNode2D*>(root);
+    if (in_prev) return new VPruned2D(leaf->getRect(), leaf->getHash());
+    if (stats) stats->points_examined += leaf->size();
+    return ship_leaf_2d(leaf);
+  }
+  
+  Rectangle node_rect = root->getRect();
+  if (!overlap(node_rect, query)) {
+    if (stats) stats->nodes_pruned++;
+    return new VPruned2D(node_rect, root->getHash());
+  }
+  
+  in_prev = in_prev && overlap(node_rect, prev);
+  VContainer2D *container = new VContainer2D();
+  for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+    container->append(range_query_delta_2d(child, query, prev, in_prev, stats));
+  }
+  return container;
+}
+
+/**
+ *  Performs a 2D range query for a client holding the leaves of a previous window.
+ */
+VObject2D *range_query_delta_2d(Node2D *root, const Rectangle &query,
+                                const Rectangle &prev, const hash_t &prev_root,
+                                QueryStats2D *stats) {
+  if (!root) return nullptr;
+  bool held = prev_root == root->getHash() && overlap(root->getRect(), prev);
+  return range_query_delta_2d(root, query, prev, held, stats);
+}
+
+/**
+ *  Sets a new trusted root and drops the cached window.
+ */
+void ViewportClient2D::setRoot(const hash_t &trusted_root) {
+  root = trusted_root;
+  has_prev = false;
+  prev = EMPTY_RECT;
+  leaves.clear();
+}
+
+/**
+ *  State of one verification of a delta VO.
+ */
+struct DeltaVerify2D {
+  const Rectangle &query;
+  const std::unordered_map<hash_t, std::vector<Point2D>, DigestHash2D> &cache;
+  std::unordered_map<hash_t, std::vector<Point2D>, DigestHash2D> used; ///< Leaves of the new window
+  std::vector<Point2D> points;                                         ///< Matching points
+  bool complete;                                                       ///< False if a needed leaf is missing
+  QueryStats2D *stats;
+};
+
+/**
+ *  Recursive step of the delta verification: returns the MBR and digest of
+ *  a subtree, collecting matching points and the leaves of the window.
+ */
+static void verify_delta_2d(VObject2D *vo, DeltaVerify2D &state, Rectangle &rect, hash_t &hash) {
+  switch (vo->getType()) {
+    case V2D_LEAF: {
+      VLeaf2D *leaf = static_cast<VLeaf2D*>(vo);
+      VResult2D *res = verify_2d(leaf, state.query, state.stats);
+      rect = res->getRect();
+      hash = res->getHash();
+      state.points.insert(state.points.end(), res->getPoints().begin(), res->getPoints().end());
+      state.used[hash] = leaf->getPoints();
+      delete res;
+      return;
+    }
+    
+    case V2D_PRUNED: {
+      VPruned2D *pruned = static_cast<VPruned2D*>(vo);
+      rect = pruned->getRect();
+      hash = pruned->getHash();
+      
+      // A pruned node overlapping the window must be a leaf the client holds.
+      // Held leaves outside the window are kept too: the server counts them
+      // as shipped since their parent overlaps the window.
+      auto it = state.cache.find(hash);
+      if (it == state.cache.end()) {
+        if (overlap(rect, state.query)) state.complete = false;
+        return;
+      }
+      for (const Point2D &p : it->second) {
+        if (contains(p, state.query)) {
+          state.points.push_back(p);
+          if (state.stats) state.stats->points_returned++;
+        }
+      }
+      state.used[hash] = it->second;
+      return;
+    }
+    
+    case V2D_CONTAINER: {
+      VContainer2D *container = static_cast<VContainer2D*>(vo);
+      verify_children_2d(container, [&](size_t i, Rectangle &child_rect, hash_t &child_hash) {
+        verify_delta_2d(container->get(i), state, child_rect, child_hash);
+      }, rect, hash);
+      return;
+    }
+  }
+}
+
+/**
+ *  Verifies a full or delta VO for a new window.
+ */
+VResult2D *ViewportClient2D::verify(VObject2D *vo, const Rectangle &query, QueryStats2D *stats) {
+  if (!vo) return nullptr;
+  
+  DeltaVerify2D state{query, leaves, {}, {}, true, stats};
+  Rectangle rect;
+  hash_t hash;
+  verify_delta_2d(vo, state, rect, hash);
+  if (!state.complete || hash != root) return nullptr;
+  
+  leaves = std::move(state.used);
+  prev = query;
+  has_prev = true;
+  return new VResult2D(rect, hash, std::move(state.points));
+}
@@ -0,0 +1,89 @@
+/**
+ *  @file Delta2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Delta verification objects for panning and zooming viewport queries.
+ *
+ *  A client keeps the leaves of its last verified window. Given that window
+ *  and the root digest it was verified against, the server builds the VO of
+ *  the new window but replaces every leaf the client already holds with a
+ *  VPruned2D entry (MBR and digest), so only newly exposed leaves are
+ *  shipped. The client resolves those entries from its leaf cache by digest,
+ *  checks that every other pruned node lies outside the window, rebuilds
+ *  the root and, on success, keeps the leaves of the new window.
+ */
+
+#ifndef DELTA2D_H
+#define DELTA2D_H
+
+#include "Query2D.hpp"
+#include <cstring>
+#include <unordered_map>
+
+/**
+ *  Performs a 2D range query for a client holding the leaves of a previous
+ *  window. If prev_root is not the current root or prev does not overlap
+ *  the tree (e.g. EMPTY_RECT for a client without a window), a full VO is
+ *  returned. Nodes touching a window border count as overlapping it.
+ *  @param root the root of the 2D MR-tree
+ *  @param query the new query rectangle
+ *  @param prev the previous query rectangle
+ *  @param prev_root the root digest the previous window was verified against
+ *  @param stats optional statistics collector
+ *  @return the delta verification object
+ */
+VObject2D *range_query_delta_2d(Node2D *root, const Rectangle &query,
+                                const Rectangle &prev, const hash_t &prev_root,
+                                QueryStats2D *stats = nullptr);
+
+/**
+ *  Hash functor for digests (their first bytes are already uniform).
+ */
+struct DigestHash2D {
+  size_t operator()(const hash_t &h) const {
+    size_t x;
+    std::memcpy(&x, h.data(), sizeof(x));
+    return x;
+  }
+};
+
+/**
+ *  Client of viewport queries, holding the leaves of its last verified window.
+ */
+class ViewportClient2D {
+private:
+  hash_t root;                                                          ///< Trusted root digest
+  bool has_prev;                                                        ///< True after a verified window
+  Rectangle prev;                                                       ///< Last verified window
+  std::unordered_map<hash_t, std::vector<Point2D>, DigestHash2D> leaves; ///< Leaves of that window by digest
+
+public:
+  /**
+   *  Creates a client with no cached window.
+   *  @param trusted_root the trusted root digest
+   */
+  ViewportClient2D(const hash_t &trusted_root) : root(trusted_root), has_prev(false), prev(EMPTY_RECT) {}
+
+  /**
+   *  Sets a new trusted root (e.g. after an update) and drops the cached window.
+   */
+  void setRoot(const hash_t &trusted_root);
+
+  bool hasPrevious() const { return has_prev; }
+  Rectangle getPrevious() const { return prev; }
+  const hash_t &getRoot() const { return root; }
+  size_t countCachedLeaves() const { return leaves.size(); }
+
+  /**
+   *  Verifies a full or delta VO for a new window. On success, the window
+   *  and its leaves replace the cached ones.
+   *  @param vo the verification object
+   *  @param query the new query rectangle
+   *  @param stats optional statistics collector
+   *  @return the verification result, or nullptr if the VO is incomplete or
+   *          does not rebuild the trusted root
+   */
+  VResult2D *verify(VObject2D *vo, const Rectangle &query, QueryStats2D *stats = nullptr);
+};
+
+#endif
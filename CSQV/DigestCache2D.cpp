@@ -0,0 +1,95 @@
+/**
+ *  @file DigestCache2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "DigestCache2D.hpp"
+#include <cstring>
+#include <random>
+
+/**
+ *  Creates an empty cache. The fingerprint seed is random, so a server
+ *  cannot aim colliding encodings at a client's cache.
+ */
+DigestCache2D::DigestCache2D(size_t capacity)
+: capacity(capacity), bytes(0), hits(0), misses(0), evictions(0) {
+  std::random_device rd;
+  seed = ((uint64_t) rd() << 32) | rd();
+}
+
+/**
+ *  Computes the fingerprint of some bytes: two independent multiply-xorshift
+ *  lanes over 16-byte blocks, then the tail, then a final mix.
+ */
+uint64_t DigestCache2D::fingerprint(const uint8_t *data, size_t size) const {
+  const uint64_t K = 0x9E3779B97F4A7C15ULL;
+  uint64_t a = seed ^ size, b = ~seed;
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    uint64_t x, y;
+    std::memcpy(&x, data + i, sizeof(x));
+    std::memcpy(&y, data + i + 8, sizeof(y));
+    a = (a ^ x) * K;
+    a ^= a >> 29;
+    b = (b ^ y) * K;
+    b ^= b >> 29;
+  }
+  if (i + 8 <= size) {
+    uint64_t x;
+    std::memcpy(&x, data + i, sizeof(x));
+    a = (a ^ x) * K;
+    a ^= a >> 29;
+    i += 8;
+  }
+  uint64_t tail = 0;
+  if (i < size) std::memcpy(&tail, data + i, size - i);
+  uint64_t h = ((a ^ tail) * K) ^ (b * 0xFF51AFD7ED558CCDULL);
+  h ^= h >> 32;
+  h *= K;
+  return h ^ (h >> 29);
+}
+
+/**
+ *  Looks up the digest of some content.
+ */
+bool DigestCache2D::lookup(const uint8_t *data, size_t size, hash_t &digest) {
+  auto it = entries.find(fingerprint(data, size));
+  if (it == entries.end() || it->second.content.size() != size ||
+      std::memcmp(it->second.content.data(), data, size) != 0) {
+    misses++;
+    return false;
+  }
+  hits++;
+  order.splice(order.begin(), order, it->second.pos);
+  digest = it->second.digest;
+  return true;
+}
+
+/**
+ *  Inserts the verified digest of some content, evicting the least
+ *  recently used entries if needed. Content whose fingerprint is taken
+ *  by other bytes is not cached.
+ */
+void DigestCache2D::insert(const uint8_t *data, size_t size, const hash_t &digest) {
+  uint64_t key = fingerprint(data, size);
+  if (cost(size) > capacity || entries.count(key)) return;
+  while (!order.empty() && bytes + cost(size) > capacity) {
+    auto victim = entries.find(order.back());
+    bytes -= cost(victim->second.content.size());
+    order.pop_back();
+    entries.erase(victim);
+    evictions++;
+  }
+  order.push_front(key);
+  entries.emplace(key, Entry{std::vector<uint8_t>(data, data + size), digest, order.begin()});
+  bytes += cost(size);
+}
+
+/**
+ *  Removes all entries.
+ */
+void DigestCache2D::clear() {
+  entries.clear();
+  order.clear();
+  bytes = 0;
+}
@@ -0,0 +1,82 @@
+/**
+ *  @file DigestCache2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Client-side cache of verified digests.
+ *
+ *  Verifying a VO hashes the encoding of every shipped leaf and opened node.
+ *  The cache maps those encodings to their digests, so a leaf or subtree seen
+ *  in an earlier verified answer is checked by a lookup and a comparison of
+ *  its bytes instead of SHA-256. Entries are found by a fast seeded 64-bit
+ *  fingerprint of the bytes, computed in place without copying them; the
+ *  stored bytes decide equality, so a fingerprint collision is only a miss.
+ *  Since the digest of given bytes never changes, entries stay correct
+ *  across root updates; they are only added once the whole VO has verified
+ *  against the trusted root, and the least recently used ones are evicted
+ *  to respect a byte budget.
+ */
+
+#ifndef DIGESTCACHE2D_H
+#define DIGESTCACHE2D_H
+
+#include "Hash.hpp"
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+class DigestCache2D {
+private:
+  struct Entry {
+    std::vector<uint8_t> content;                   ///< The encoded leaf or node
+    hash_t digest;                                  ///< Digest of the content
+    std::list<uint64_t>::iterator pos;              ///< Position in the LRU list
+  };
+
+  size_t capacity;                                  ///< Byte budget
+  size_t bytes;                                     ///< Bytes currently used
+  uint64_t seed;                                    ///< Seed of the fingerprints
+  std::unordered_map<uint64_t, Entry> entries;      ///< Entries by fingerprint of their content
+  std::list<uint64_t> order;                        ///< Fingerprints, most recently used first
+  size_t hits, misses, evictions;
+
+  static size_t cost(size_t size) { return size + sizeof(Entry) + 64; }
+  uint64_t fingerprint(const uint8_t *data, size_t size) const;
+
+public:
+  /**
+   *  Creates an empty cache.
+   *  @param capacity the byte budget
+   */
+  DigestCache2D(size_t capacity);
+
+  /**
+   *  Looks up the digest of some content.
+   *  @param data the encoded leaf or node
+   *  @param size its size in bytes
+   *  @param digest output digest, set on a hit
+   *  @return true on a hit
+   */
+  bool lookup(const uint8_t *data, size_t size, hash_t &digest);
+
+  /**
+   *  Inserts the verified digest of some content.
+   *  @param data the encoded leaf or node
+   *  @param size its size in bytes
+   *  @param digest its digest
+   */
+  void insert(const uint8_t *data, size_t size, const hash_t &digest);
+
+  /**
+   *  Removes all entries (counters are kept).
+   */
+  void clear();
+
+  size_t size() const { return entries.size(); }
+  size_t sizeInBytes() const { return bytes; }
+  size_t getHits() const { return hits; }
+  size_t getMisses() const { return misses; }
+  size_t getEvictions() const { return evictions; }
+  double hitRate() const { return (hits + misses) ? (double) hits / (hits + misses) : 0.0; }
+};
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ *  @file Exists2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Exists2D.hpp"
+
+/**
+ *  Searches for a leaf with a matching point, stopping at the first one.
+ *  @return the leaf, or nullptr if none
+ */
+static Node2D *find_witness_2d(Node2D *root, const Rectangle &query, QueryStats2D *stats) {
+  if (stats) stats->nodes_visited++;
+  if (!overlap(root->getRect(), query)) return nullptr;
+  
+  if (root->getType() == N2D_LEAF) {
+    LeafNode2D *leaf = static_cast<LeafNode2D*>(root);
+    for (const Point2D &p : leaf->getPoints()) {
+      if (stats) stats->points_examined++;
+      if (contains(p, query)) return leaf;
+    }
+    return nullptr;
+  }
+  
+  for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+    Node2D *leaf = find_witness_2d(child, query, stats);
+    if (leaf) return leaf;
+  }
+  return nullptr;
+}
+
+/**
+ *  Builds the proof of existence: the path to the witness leaf.
+ *  @return the verification object, and true in found if it holds the witness
+ */
+static VObject2D *exists_path_2d(Node2D *root, Node2D *witness, bool &found) {
+  if (root == witness) {
+    found = true;
+    return ship_leaf_2d(static_cast<LeafNode2D*>(root));
+  }
+  if (root->getType() == N2D_LEAF || !contains(root->getRect(), witness->getRect())) {
+    return new VPruned2D(root->getRect(), root->getHash());
+  }
+  
+  // MBRs may overlap, so a child containing the witness MBR may not hold it.
+  VContainer2D *container = new VContainer2D();
+  bool below = false;
+  for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+    if (below) {
+      container->append(new VPruned2D(child->getRect(), child->getHash()));
+    } else {
+      container->append(exists_path_2d(child, witness, below));
+    }
+  }
+  if (!below) {
+    delete_vo_2d(container);
+    return new VPruned2D(root->getRect(), root->getHash());
+  }
+  found = true;
+  return container;
+}
+
+/**
+ *  Builds the proof of emptiness: nodes overlapping the query are opened.
+ */
+static VObject2D *empty_proof_2d(Node2D *root, const Rectangle &query, QueryStats2D *stats) {
+  if (!overlap(root->getRect(), query)) {
+    if (stats) stats->nodes_pruned++;
+    return new VPruned2D(root->getRect(), root->getHash());
+  }
+  if (root->getType() == N2D_LEAF) return ship_leaf_2d(static_cast<LeafNode2D*>(root));
+  
+  VContainer2D *container = new VContainer2D();
+  for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+    container->append(empty_proof_2d(child, query, stats));
+  }
+  return container;
+}
+
+/**
+ *  Performs a 2D existence query.
+ */
+VObject2D *exists_query_2d(Node2D *root, const Rectangle &query, QueryStats2D *stats) {
+  if (!root) return nullptr;
+  
+  Node2D *witness = find_witness_2d(root, query, stats);
+  if (!witness) return empty_proof_2d(root, query, stats);
+  bool found = false;
+  return exists_path_2d(root, witness, found);
+}
+
+/**
+ *  Recursive step of the verification of an existence query.
+ */
+static void verify_exists_2d(VObject2D *vo, const Rectangle &query, std::vector<Point2D> &witness,
+                             bool &unproven, Rectangle &rect, hash_t &hash, QueryStats2D *stats) {
+  switch (vo->getType()) {
+    case V2D_LEAF: {
+      VResult2D *res = verify_2d(vo, query, nullptr);
+      rect = res->getRect();
+      hash = res->getHash();
+      if (witness.empty() && res->count() > 0) {
+        witness.push_back(res->getPoints()[0]);
+        if (stats) stats->points_returned++;
+      }
+      delete res;
+      return;
+    }
+    
+    case V2D_PRUNED: {
+      VPruned2D *pruned = static_cast<VPruned2D*>(vo);
+      rect = pruned->getRect();
+      hash = pruned->getHash();
+      if (overlap(rect, query)) unproven = true;
+      return;
+    }
+    
+    case V2D_CONTAINER: {
+      VContainer2D *container = static_cast<VContainer2D*>(vo);
+      verify_children_2d(container, [&](size_t i, Rectangle &child_rect, hash_t &child_hash) {
+        verify_exists_2d(container->get(i), query, witness, unproven, child_rect, child_hash, stats);
+      }, rect, hash);
+      return;
+    }
+  }
+}
+
+/**
+ *  Verifies a 2D existence query.
+ */
+VResult2D *verify_exists_2d(VObject2D *vo, const Rectangle &query, QueryStats2D *stats) {
+  if (!vo) return nullptr;
+  
+  std::vector<Point2D> witness;
+  bool unproven = false;
+  Rectangle rect;
+  hash_t hash;
+  verify_exists_2d(vo, query, witness, unproven, rect, hash, stats);
+  if (witness.empty() && unproven) return nullptr;
+  return new VResult2D(rect, hash, std::move(witness));
+}
@@ -0,0 +1,41 @@
+/**
+ *  @file Exists2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Verified existence (emptiness) queries on the 2D MR-tree.
+ *
+ *  The server first searches for a matching point with early exit. If one
+ *  exists, the proof is the path to its leaf: the leaf is shipped and every
+ *  other node is pruned. Otherwise the proof opens every node overlapping
+ *  the query and ships the overlapping leaves, none of which has a match.
+ */
+
+#ifndef EXISTS2D_H
+#define EXISTS2D_H
+
+#include "Query2D.hpp"
+
+/**
+ *  Performs a 2D existence query.
+ *  @param root the root of the 2D MR-tree
+ *  @param query the query rectangle
+ *  @param stats optional statistics collector
+ *  @return the verification object: one leaf path, or a proof of emptiness
+ */
+VObject2D *exists_query_2d(Node2D *root, const Rectangle &query,
+                           QueryStats2D *stats = nullptr);
+
+/**
+ *  Verifies a 2D existence query.
+ *  The caller must compare the reconstructed hash with the trusted root.
+ *  @param vo the verification object
+ *  @param query the query rectangle
+ *  @param stats optional statistics collector
+ *  @return the verification result with one matching point (the witness)
+ *          or none, or nullptr if a pruned node overlapping the query
+ *          leaves emptiness unproven
+ */
+VResult2D *verify_exists_2d(VObject2D *vo, const Rectangle &query,
+                            QueryStats2D *stats = nullptr);
+
+#endif
@@ -0,0 +1,295 @@
+/**
+ *  @file ExternalBuild2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "ExternalBuild2D.hpp"
+#include "TreeBuilder2D.hpp"
+#include "csv.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+/**
+ *  Size of a point in a run file (id, x, y).
+ */
+#define RUN_POINT_SIZE (sizeof(uint32_t) + 2 * sizeof(int32_t))
+
+/**
+ *  File descriptors kept free for other uses than runs during a merge
+ *  (standard streams, the merge output, the page file).
+ */
+#define RUN_RESERVED_FILES 16
+
+/**
+ *  Sequential reader of a run file, one block at a time.
+ */
+class RunReader2D {
+private:
+  std::ifstream file;
+  std::vector<uint8_t> block;
+  size_t n;    ///< Points in the block
+  size_t pos;  ///< Next point of the block
+  bool failed; ///< True if the run cannot be opened or read
+
+public:
+  RunReader2D(const std::string &path, size_t block_points) : file(path, std::ios::binary),
+    block(block_points * RUN_POINT_SIZE), n(0), pos(0), failed(!file) {}
+
+  bool good() const { return !failed; }
+
+  /**
+   *  Reads the next point.
+   *  @return false at the end of the run or on error
+   */
+  bool next(Point2D &p) {
+    if (failed) return false;
+    if (pos == n) {
+      file.read(reinterpret_cast<char*>(block.data()), block.size());
+      size_t got = file.gcount();
+      if (file.bad() || got % RUN_POINT_SIZE != 0) {
+        failed = true;
+        return false;
+      }
+      n = got / RUN_POINT_SIZE;
+      pos = 0;
+      if (n == 0) return false;
+    }
+    uint32_t id;
+    int32_t x, y;
+    const uint8_t *b = &block[pos++ * RUN_POINT_SIZE];
+    std::memcpy(&id, b, sizeof(id));
+    std::memcpy(&x, b + sizeof(id), sizeof(x));
+    std::memcpy(&y, b + sizeof(id) + sizeof(x), sizeof(y));
+    p = Point2D(id, x, y);
+    return true;
+  }
+};
+
+/**
+ *  Sequential writer of a run file, one block at a time.
+ */
+class RunWriter2D {
+private:
+  std::ofstream file;
+  std::vector<uint8_t> block;
+  size_t block_bytes;
+  uint64_t written;
+
+public:
+  RunWriter2D(const std::string &path, size_t block_points)
+  : file(path, std::ios::binary | std::ios::trunc), block_bytes(block_points * RUN_POINT_SIZE), written(0) {
+    block.reserve(block_bytes);
+  }
+
+  bool good() const { return (bool) file; }
+  uint64_t bytes() const { return written; }
+
+  bool add(const Point2D &p) {
+    const uint8_t *id = reinterpret_cast<const uint8_t*>(&p.id);
+    const uint8_t *x = reinterpret_cast<const uint8_t*>(&p.loc.x);
+    const uint8_t *y = reinterpret_cast<const uint8_t*>(&p.loc.y);
+    block.insert(block.end(), id, id + sizeof(uint32_t));
+    block.insert(block.end(), x, x + sizeof(int32_t));
+    block.insert(block.end(), y, y + sizeof(int32_t));
+    return block.size() < block_bytes || flush();
+  }
+
+  bool flush() {
+    file.write(reinterpret_cast<const char*>(block.data()), block.size());
+    written += block.size();
+    block.clear();
+    return (bool) file;
+  }
+};
+
+/**
+ *  Returns the path of a temporary run file.
+ */
+static std::string run_path_2d(const std::string &dir, size_t pass, size_t run) {
+  return (dir.empty() ? std::string(".") : dir) + "/csqv-run-" +
+         std::to_string(pass) + "-" + std::to_string(run) + ".bin";
+}
+
+/**
+ *  Returns the number of runs that may be merged at once: at most
+ *  EXTERNAL_MAX_FAN_IN, and within the limit on open files.
+ */
+static size_t max_fan_in_2d() {
+  size_t limit = EXTERNAL_MAX_FAN_IN;
+#ifndef _WIN32
+  struct rlimit rl;
+  if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY) {
+    size_t open = (size_t) rl.rlim_cur;
+    limit = std::min(limit, open > RUN_RESERVED_FILES + 2 ? open - RUN_RESERVED_FILES : (size_t) 2);
+  }
+#endif
+  return limit;
+}
+
+/**
+ *  Merges runs into a sink, k ways with a heap.
+ *  @param merged receives the number of points passed to the sink
+ *  @return false if a run cannot be read or the sink fails
+ */
+template <typename Sink>
+static bool merge_runs_2d(const std::vector<std::string> &runs, size_t block_points, Sink &sink,
+                          uint64_t &merged) {
+  typedef std::pair<Point2D, size_t> Head;
+  auto greater = [](const Head &a, const Head &b) { return external_less_2d(b.first, a.first); };
+  std::priority_queue<Head, std::vector<Head>, decltype(greater)> heap(greater);
+  std::vector<RunReader2D*> readers;
+  bool ok = true;
+  merged = 0;
+  for (size_t i = 0; i < runs.size(); i++) {
+    readers.push_back(new RunReader2D(runs[i], block_points));
+    Point2D p;
+    if (readers[i]->next(p)) heap.push({p, i});
+  }
+  while (ok && !heap.empty()) {
+    Head h = heap.top();
+    heap.pop();
+    if (!sink.add(h.first)) {
+      std::cerr << "Error: Cannot write merged points" << std::endl;
+      ok = false;
+      break;
+    }
+    merged++;
+    Point2D p;
+    if (readers[h.second]->next(p)) heap.push({p, h.second});
+  }
+  for (size_t i = 0; i < runs.size(); i++) {
+    if (!readers[i]->good()) {
+      std::cerr << "Error: Cannot read run file " << runs[i] << std::endl;
+      ok = false;
+    }
+    delete readers[i];
+  }
+  return ok;
+}
+
+/**
+ *  Builds a paged MR-tree from a points file.
+ */
+bool external_build_2d(const std::string &data_file, const std::string &page_file,
+                       const ExternalBuildConfig2D &config,
+                       ExternalBuildStats2D *stats) {
+  ExternalBuildStats2D st{0, 0, 0, 0, 0};
+  if (config.capacity < 2) return false;
+  
+  // Blocks shrink with the budget so that 16 runs and the output block fit
+  // in it; the fan-in is the number of blocks left for the runs, bounded by
+  // the number of files that may be open at once.
+  size_t run_points = std::max<size_t>(config.memory / sizeof(Point2D), config.capacity);
+  size_t block_points = std::min<size_t>(EXTERNAL_BLOCK_POINTS,
+                                         std::max<size_t>(1, config.memory / (17 * RUN_POINT_SIZE)));
+  size_t block_bytes = block_points * RUN_POINT_SIZE;
+  size_t fan_in = std::max<size_t>(2, std::min(config.memory / block_bytes - 1, max_fan_in_2d()));
+  
+  // Run generation: sort chunks of the input and spill them.
+  std::vector<std::string> runs;
+  std::vector<Point2D> buf;
+  bool ok = true;
+  auto spill = [&]() {
+    std::sort(buf.begin(), buf.end(), external_less_2d);
+    std::string path = run_path_2d(config.tmp_dir, 0, runs.size());
+    RunWriter2D run(path, block_points);
+    for (size_t i = 0; i < buf.size() && run.add(buf[i]); i++) {}
+    if (!run.flush()) {
+      std::cerr << "Error: Cannot write run file " << path << std::endl;
+      ok = false;
+    }
+    st.spilled_bytes += run.bytes();
+    st.peak_bytes = std::max(st.peak_bytes, buf.capacity() * sizeof(Point2D));
+    runs.push_back(path);
+    buf.clear();
+  };
+  try {
+    csv::CSVReader reader(data_file);
+    uint32_t id = 0;
+    for (csv::CSVRow &row : reader) {
+      if (buf.size() == buf.capacity()) buf.reserve(std::min(run_points, std::max<size_t>(2 * buf.size(), 1024)));
+      buf.emplace_back(id++, row[0].get<int32_t>(), row[1].get<int32_t>());
+      if (buf.size() == run_points) spill();
+      if (!ok) break;
+    }
+    if (ok && !buf.empty() && !runs.empty()) spill();
+    st.points = id;
+  } catch (const std::exception &e) {
+    std::cerr << "Error loading points file: " << e.what() << std::endl;
+    ok = false;
+  }
+  st.runs = runs.size();
+  
+  // Input that fits in one run is not spilled.
+  if (ok && runs.empty() && !buf.empty()) {
+    std::sort(buf.begin(), buf.end(), external_less_2d);
+    st.peak_bytes = buf.capacity() * sizeof(Point2D);
+    PageWriter2D writer;
+    ok = writer.open(page_file, config.page_size);
+    if (ok) {
+      TreeBuilder2D<PageSink2D> builder(PageSink2D(writer), config.capacity);
+      ok = builder.add(buf) && builder.finish();
+    }
+    if (stats) *stats = st;
+    return ok;
+  }
+  std::vector<Point2D>().swap(buf);
+  
+  // Checks that a merge carried every point over; a short count means a run
+  // was lost or cut short.
+  auto check_count = [&](uint64_t count) {
+    if (count == st.points) return true;
+    std::cerr << "Error: Merged " << count << " of " << st.points << " points" << std::endl;
+    return false;
+  };
+  
+  // Intermediate passes until the runs can be merged at once.
+  for (size_t pass = 1; ok && runs.size() > fan_in; pass++) {
+    std::vector<std::string> merged;
+    uint64_t count = 0;
+    for (size_t i = 0; ok && i < runs.size(); i += fan_in) {
+      std::vector<std::string> group(runs.begin() + i, runs.begin() + std::min(runs.size(), i + fan_in));
+      std::string path = run_path_2d(config.tmp_dir, pass, merged.size());
+      RunWriter2D out(path, block_points);
+      uint64_t n;
+      ok = merge_runs_2d(group, block_points, out, n);
+      if (!out.flush()) {
+        std::cerr << "Error: Cannot write run file " << path << std::endl;
+        ok = false;
+      }
+      count += n;
+      st.spilled_bytes += out.bytes();
+      st.peak_bytes = std::max(st.peak_bytes, (group.size() + 1) * block_bytes);
+      for (const std::string &r : group) std::remove(r.c_str());
+      merged.push_back(path);
+    }
+    // Runs not reached after an error are still removed below.
+    if (!ok) merged.insert(merged.end(), runs.begin() + std::min(runs.size(), merged.size() * fan_in), runs.end());
+    runs = std::move(merged);
+    ok = ok && check_count(count);
+    st.merge_passes++;
+  }
+  
+  // Final pass straight into the page file.
+  if (ok && !runs.empty()) {
+    PageWriter2D writer;
+    ok = writer.open(page_file, config.page_size);
+    if (ok) {
+      TreeBuilder2D<PageSink2D> builder(PageSink2D(writer), config.capacity);
+      uint64_t count;
+      ok = merge_runs_2d(runs, block_points, builder, count) && check_count(count) && builder.finish();
+      st.peak_bytes = std::max(st.peak_bytes, runs.size() * block_bytes);
+    }
+  }
+  for (const std::string &r : runs) std::remove(r.c_str());
+  
+  if (stats) *stats = st;
+  return ok && st.points > 0;
+}
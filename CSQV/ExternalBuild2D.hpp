@@ -0,0 +1,83 @@
+/**
+ *  @file ExternalBuild2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  External-memory bulk build of a paged MR-tree.
+ *
+ *  Points are streamed from the input file into sorted runs of at most the
+ *  memory budget, spilled to temporary files, and merged k ways (in several
+ *  passes if there are more runs than the budget allows to merge at once).
+ *  The merged stream goes straight into a PageWriter2D through a
+ *  TreeBuilder2D, so neither the points nor the tree are ever held whole.
+ *  Points are sorted as in build_2d_tree, ties broken by ID, and grouped
+ *  into the same nodes: the tree is the one build_2d_tree builds from
+ *  points in that order.
+ */
+
+#ifndef EXTERNALBUILD2D_H
+#define EXTERNALBUILD2D_H
+
+#include "PageFile2D.hpp"
+#include <string>
+
+/**
+ *  Default memory budget of an external build, in bytes.
+ */
+#define DEFAULT_BUILD_MEMORY (64 << 20)
+
+/**
+ *  Maximum number of points read or written per block when merging runs.
+ */
+#define EXTERNAL_BLOCK_POINTS 4096
+
+/**
+ *  Maximum number of runs merged at once. The fan-in is also kept within
+ *  the limit on open files of the process.
+ */
+#define EXTERNAL_MAX_FAN_IN 256
+
+/**
+ *  Parameters of an external build.
+ */
+struct ExternalBuildConfig2D {
+  size_t capacity;     ///< Maximum number of points per leaf and children per node
+  size_t memory;       ///< Memory budget in bytes for sorting and merging
+  std::string tmp_dir; ///< Directory of the temporary run files
+  uint32_t page_size;  ///< Page size of the output file
+};
+
+/**
+ *  Statistics of an external build.
+ */
+struct ExternalBuildStats2D {
+  uint64_t points;       ///< Points indexed
+  size_t runs;           ///< Initial sorted runs
+  size_t merge_passes;   ///< Merge passes before the final one
+  size_t peak_bytes;     ///< Largest memory held by sort or merge buffers
+  uint64_t spilled_bytes; ///< Bytes written to run files
+};
+
+/**
+ *  Orders points as build_2d_tree does, breaking ties by ID.
+ */
+static inline bool external_less_2d(const Point2D &a, const Point2D &b) {
+  if (a < b) return true;
+  if (b < a) return false;
+  return a.id < b.id;
+}
+
+/**
+ *  Builds a paged MR-tree from a points file (x,y columns with a header,
+ *  as for load_points_file; IDs are assigned sequentially).
+ *  @param data_file the input CSV file
+ *  @param page_file the output page file
+ *  @param config the parameters
+ *  @param stats optional statistics
+ *  @return false on error, including a run file that cannot be written
+ *          or read back in full
+ */
+bool external_build_2d(const std::string &data_file, const std::string &page_file,
+                       const ExternalBuildConfig2D &config,
+                       ExternalBuildStats2D *stats = nullptr);
+
+#endif
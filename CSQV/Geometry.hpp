@@ -70,6 +70,28 @@ static inline bool intersect(const Rectangle &r, const Rectangle &s) {
   return !(above || below || left || right);
 }
 
+/**
+ *  Returns true if and only if the second rectangle lies inside the first one.
+ *  @param r the outer rectangle
+ *  @param s the inner rectangle
+ *  @return true if s is inside r, false otherwise
+ */
+static inline bool contains(const Rectangle &r, const Rectangle &s) {
+  return (r.lx <= s.lx && s.ux <= r.ux && r.ly <= s.ly && s.uy <= r.uy);
+}
+
+/**
+ *  Returns true if and only if two rectangles share at least one point.
+ *  Unlike intersect, the test is closed: rectangles touching along an edge
+ *  or at a corner overlap, as points on a query border match the query.
+ *  @param r the first rectangle
+ *  @param s the second rectangle
+ *  @return true if r and s share a point, false otherwise
+ */
+static inline bool overlap(const Rectangle &r, const Rectangle &s) {
+  return (r.lx <= s.ux && s.lx <= r.ux && r.ly <= s.uy && s.ly <= r.uy);
+}
+
 /**
  *  Computes the minimum bounding rectangle of a list of points.
  *  @param pts list of points
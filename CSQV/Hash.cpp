@@ -43,6 +43,54 @@ hash_t sha256(const std::string &s) {
   return sha256((const uint8_t *) s.c_str(), s.size());
 }
 
+/**
+ *  Starts a new computation.
+ */
+Sha256State::Sha256State() : ctx(EVP_MD_CTX_new()) {
+  assert(ctx != NULL);
+  EVP_DigestInit_ex(ctx, EVP_sha256(), NULL);
+}
+
+/**
+ *  Copies the midstate of another computation.
+ */
+Sha256State::Sha256State(const Sha256State &other) : ctx(EVP_MD_CTX_new()) {
+  assert(ctx != NULL);
+  EVP_MD_CTX_copy_ex(ctx, other.ctx);
+}
+
+Sha256State::~Sha256State() {
+  EVP_MD_CTX_free(ctx);
+}
+
+/**
+ *  Appends raw bytes to the message.
+ */
+Sha256State &Sha256State::update(const uint8_t *buf, size_t size) {
+  EVP_DigestUpdate(ctx, buf, size);
+  return *this;
+}
+
+/**
+ *  Appends the content of a buffer to the message.
+ */
+Sha256State &Sha256State::update(const Buffer &buf) {
+  return update(buf.data(), buf.size());
+}
+
+/**
+ *  Finalizes a copy of the state, so that more bytes can still be appended.
+ */
+hash_t Sha256State::digest() const {
+  hash_t h;
+  EVP_MD_CTX *copy = EVP_MD_CTX_new();
+  assert(copy != NULL);
+  EVP_MD_CTX_copy_ex(copy, ctx);
+  EVP_DigestFinal_ex(copy, h.data(), NULL);
+  EVP_MD_CTX_free(copy);
+  return h;
+}
+
 /**
  *  Converts an array of bytes to a human-readable hexadecimal string.
  *  @param hash array of bytes
@@ -7,9 +7,12 @@
 #define HASH_H
 
 #include "Buffer.hpp"
+#include <openssl/sha.h>
+#include <openssl/evp.h>
 #include <array>
 #include <string>
 #include <functional>
+#include <utility>
 
 /// A hash digest is represented as a fixed-size array of bytes (32 bytes for compatibility).
 typedef std::array<uint8_t, 32> hash_t;
@@ -36,6 +39,53 @@ hash_t sha256(const Buffer &buf);
  */
 hash_t sha256(const std::string &s);
 
+/**
+ *  Incremental SHA-256 computation whose state can be kept between
+ *  updates: digest finalizes a copy, so more bytes may be appended later
+ *  and only the new bytes are hashed.
+ */
+class Sha256State {
+private:
+  EVP_MD_CTX *ctx; ///< The midstate of the computation
+
+public:
+  /**
+   *  Starts a new computation.
+   */
+  Sha256State();
+
+  /**
+   *  Copies the midstate of another computation.
+   */
+  Sha256State(const Sha256State &other);
+  Sha256State(Sha256State &&other) noexcept : ctx(other.ctx) { other.ctx = nullptr; }
+  Sha256State &operator=(Sha256State other) {
+    std::swap(ctx, other.ctx);
+    return *this;
+  }
+  ~Sha256State();
+
+  /**
+   *  Appends raw bytes to the message.
+   *  @param buf pointer to the bytes
+   *  @param size number of bytes
+   *  @return a reference to the state
+   */
+  Sha256State &update(const uint8_t *buf, size_t size);
+
+  /**
+   *  Appends the content of a buffer to the message.
+   *  @param buf the buffer
+   *  @return a reference to the state
+   */
+  Sha256State &update(const Buffer &buf);
+
+  /**
+   *  Returns the digest of the bytes appended so far, leaving the state unchanged.
+   */
+  hash_t digest() const;
+};
+
 /**
  *  Converts an array of bytes to a human-readable hexadecimal string.
  *  @param hash array of bytes
@@ -0,0 +1,322 @@
+/**
+ *  @file Heatmap2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Heatmap2D.hpp"
+#include <cstring>
+
+/**
+ *  Size of an entry of a count-augmented internal node (rectangle, count, hash).
+ */
+#define COUNT_ENTRY_SIZE_2D (4*sizeof(int32_t) + sizeof(uint64_t) + SHA256_DIGEST_LENGTH)
+
+/**
+ *  Appends an entry of a count-augmented internal node to a buffer.
+ */
+static inline void put_count_entry_2d(Buffer &buf, const Rectangle &r, uint64_t count, hash_t h) {
+  buf.put(r.lx).put(r.ly).put(r.ux).put(r.uy).put(count)
+     .put_bytes(h.data(), h.size());
+}
+
+/**
+ *  Returns the published digest of a tree from the entry of its root.
+ */
+static hash_t count_root_hash_2d(const Rectangle &r, uint64_t count, const hash_t &h) {
+  Buffer buf(COUNT_ENTRY_SIZE_2D);
+  put_count_entry_2d(buf, r, count, h);
+  return sha256(buf);
+}
+
+/**
+ *  Computes the entry of a node and of its descendants.
+ */
+const CountEntry2D &CountTree2D::build(Node2D *node) {
+  CountEntry2D entry;
+  if (node->getType() == N2D_LEAF) {
+    entry = CountEntry2D{static_cast<LeafNode2D*>(node)->size(), node->getHash()};
+  } else {
+    const std::vector<Node2D*> &children = static_cast<IntNode2D*>(node)->getChildren();
+    Buffer buf(children.size() * COUNT_ENTRY_SIZE_2D);
+    entry.count = 0;
+    for (Node2D *child : children) {
+      const CountEntry2D &c = build(child);
+      entry.count += c.count;
+      put_count_entry_2d(buf, child->getRect(), c.count, c.hash);
+    }
+    entry.hash = sha256(buf);
+  }
+  return entries[node] = entry;
+}
+
+/**
+ *  Computes the counts and count-augmented digests of a tree.
+ */
+CountTree2D::CountTree2D(Node2D *root) : root(root), digest{} {
+  if (!root) return;
+  const CountEntry2D &e = build(root);
+  digest = count_root_hash_2d(root->getRect(), e.count, e.hash);
+}
+
+/**
+ *  Returns the cell of a coordinate in [lo, hi] split into n cells.
+ */
+static inline uint32_t heat_cell_2d(int32_t v, int32_t lo, int32_t hi, uint32_t n) {
+  return (uint32_t) (((int64_t) v - lo) * n / ((int64_t) hi - lo + 1));
+}
+
+/**
+ *  Returns the index of the single cell containing a rectangle, or -1 if
+ *  the rectangle is not inside the grid or spans several cells.
+ */
+static int64_t single_cell_2d(const Rectangle &r, const HeatmapGrid2D &g) {
+  if (!contains(g.area, r)) return -1;
+  uint32_t cx = heat_cell_2d(r.lx, g.area.lx, g.area.ux, g.nx);
+  uint32_t cy = heat_cell_2d(r.ly, g.area.ly, g.area.uy, g.ny);
+  if (cx != heat_cell_2d(r.ux, g.area.lx, g.area.ux, g.nx) ||
+      cy != heat_cell_2d(r.uy, g.area.ly, g.area.uy, g.ny)) return -1;
+  return (int64_t) cy * g.nx + cx;
+}
+
+/**
+ *  Recursive step of a heatmap query.
+ */
+static VHeat2D *heatmap_query_2d(const CountTree2D &tree, Node2D *node,
+                                 const HeatmapGrid2D &grid, QueryStats2D *stats) {
+  if (stats) stats->nodes_visited++;
+  
+  Rectangle rect = node->getRect();
+  if (!overlap(rect, grid.area) || single_cell_2d(rect, grid) >= 0) {
+    if (stats) stats->nodes_pruned++;
+    const CountEntry2D &e = tree.getEntry(node);
+    return new VHeat2D(rect, e.count, e.hash);
+  }
+  
+  if (node->getType() == N2D_LEAF) {
+    LeafNode2D *leaf = static_cast<LeafNode2D*>(node);
+    if (stats) stats->points_examined += leaf->size();
+    return new VHeat2D(ship_leaf_2d(leaf));
+  }
+  
+  VHeat2D *container = new VHeat2D();
+  for (Node2D *child : static_cast<IntNode2D*>(node)->getChildren()) {
+    container->append(heatmap_query_2d(tree, child, grid, stats));
+  }
+  return container;
+}
+
+/**
+ *  Performs a heatmap query.
+ */
+VHeat2D *heatmap_query_2d(const CountTree2D &tree, const HeatmapGrid2D &grid,
+                          QueryStats2D *stats) {
+  if (!tree.getRoot() || grid.nx == 0 || grid.ny == 0) return nullptr;
+  return heatmap_query_2d(tree, tree.getRoot(), grid, stats);
+}
+
+/**
+ *  Recursive step of the verification of a heatmap query: returns the MBR,
+ *  count and count-augmented digest of a subtree.
+ */
+static bool verify_heatmap_2d(VHeat2D *vo, const HeatmapGrid2D &grid, std::vector<uint64_t> &counts,
+                              Rectangle &rect, uint64_t &count, hash_t &hash) {
+  switch (vo->getType()) {
+    case VH2D_LEAF: {
+      VResult2D *res = verify_2d(vo->getLeaf(), grid.area);
+      rect = res->getRect();
+      hash = res->getHash();
+      count = vo->getLeaf()->getSize();
+      for (const Point2D &p : res->getPoints()) {
+        counts[(size_t) heat_cell_2d(p.loc.y, grid.area.ly, grid.area.uy, grid.ny) * grid.nx +
+               heat_cell_2d(p.loc.x, grid.area.lx, grid.area.ux, grid.nx)]++;
+      }
+      delete res;
+      return true;
+    }
+    
+    case VH2D_SUMMARY: {
+      rect = vo->getRect();
+      count = vo->getCount();
+      hash = vo->getHash();
+      if (!overlap(rect, grid.area)) return true;
+      int64_t cell = single_cell_2d(rect, grid);
+      if (cell < 0) return false;
+      counts[cell] += count;
+      return true;
+    }
+    
+    case VH2D_CONTAINER: {
+      Buffer buf(vo->getChildren().size() * COUNT_ENTRY_SIZE_2D);
+      rect = EMPTY_RECT;
+      count = 0;
+      for (VHeat2D *child : vo->getChildren()) {
+        Rectangle child_rect;
+        uint64_t child_count;
+        hash_t child_hash;
+        if (!verify_heatmap_2d(child, grid, counts, child_rect, child_count, child_hash)) return false;
+        rect = enlarge(rect, child_rect);
+        count += child_count;
+        put_count_entry_2d(buf, child_rect, child_count, child_hash);
+      }
+      hash = sha256(buf);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ *  Verifies a heatmap query.
+ */
+HeatmapResult2D verify_heatmap_2d(VHeat2D *vo, const HeatmapGrid2D &grid) {
+  HeatmapResult2D res{false, hash_t{}, std::vector<uint64_t>()};
+  if (!vo || grid.nx == 0 || grid.ny == 0) return res;
+  
+  res.counts.assign((size_t) grid.nx * grid.ny, 0);
+  Rectangle rect;
+  uint64_t count;
+  hash_t hash;
+  res.valid = verify_heatmap_2d(vo, grid, res.counts, rect, count, hash);
+  // The root entry is hashed once more, which binds its count to the trusted digest.
+  res.hash = count_root_hash_2d(rect, count, hash);
+  return res;
+}
+
+/**
+ *  Returns the size in bytes of the wire encoding of a heatmap VO.
+ */
+size_t heatmap_vo_size_2d(VHeat2D *vo) {
+  if (!vo) return 0;
+  switch (vo->getType()) {
+    case VH2D_LEAF:
+      return vo_size_2d(vo->getLeaf());
+    case VH2D_SUMMARY:
+      return sizeof(uint8_t) + COUNT_ENTRY_SIZE_2D;
+    case VH2D_CONTAINER: {
+      size_t total = sizeof(uint8_t) + sizeof(uint32_t);
+      for (VHeat2D *child : vo->getChildren()) total += heatmap_vo_size_2d(child);
+      return total;
+    }
+  }
+  return 0;
+}
+
+/**
+ *  Appends the raw bytes of a value to a byte vector.
+ */
+template <typename T>
+static inline void put_raw_2d(std::vector<uint8_t> &out, const T &x) {
+  const uint8_t *ptr = reinterpret_cast<const uint8_t*>(&x);
+  out.insert(out.end(), ptr, ptr + sizeof(T));
+}
+
+/**
+ *  Serializes a heatmap VO. Leaves are encoded by serialize_vo_2d, whose
+ *  leaf tags differ from the summary and container tags.
+ */
+void serialize_heatmap_vo_2d(VHeat2D *vo, std::vector<uint8_t> &out) {
+  if (!vo) return;
+  switch (vo->getType()) {
+    case VH2D_LEAF:
+      serialize_vo_2d(vo->getLeaf(), out);
+      return;
+    case VH2D_SUMMARY: {
+      Rectangle r = vo->getRect();
+      hash_t h = vo->getHash();
+      put_raw_2d(out, static_cast<uint8_t>(VH2D_SUMMARY));
+      put_raw_2d(out, r.lx);
+      put_raw_2d(out, r.ly);
+      put_raw_2d(out, r.ux);
+      put_raw_2d(out, r.uy);
+      put_raw_2d(out, vo->getCount());
+      out.insert(out.end(), h.begin(), h.end());
+      return;
+    }
+    case VH2D_CONTAINER:
+      put_raw_2d(out, static_cast<uint8_t>(VH2D_CONTAINER));
+      put_raw_2d(out, static_cast<uint32_t>(vo->getChildren().size()));
+      for (VHeat2D *child : vo->getChildren()) serialize_heatmap_vo_2d(child, out);
+      return;
+  }
+}
+
+/**
+ *  Recursive step of the deserialization of a heatmap VO.
+ *  @param depth the number of containers enclosing the object
+ */
+static VHeat2D *deserialize_heatmap_vo_2d(const uint8_t *data, size_t size, size_t &pos,
+                                          uint32_t depth) {
+  if (pos >= size) return nullptr;
+  uint8_t tag = data[pos];
+  
+  if (tag == VH2D_SUMMARY) {
+    if (size - pos < 1 + COUNT_ENTRY_SIZE_2D) return nullptr;
+    const uint8_t *p = data + pos + 1;
+    Rectangle r;
+    uint64_t count;
+    hash_t h;
+    std::memcpy(&r.lx, p, sizeof(int32_t));
+    std::memcpy(&r.ly, p + sizeof(int32_t), sizeof(int32_t));
+    std::memcpy(&r.ux, p + 2 * sizeof(int32_t), sizeof(int32_t));
+    std::memcpy(&r.uy, p + 3 * sizeof(int32_t), sizeof(int32_t));
+    std::memcpy(&count, p + 4 * sizeof(int32_t), sizeof(uint64_t));
+    std::memcpy(h.data(), p + 4 * sizeof(int32_t) + sizeof(uint64_t), h.size());
+    pos += 1 + COUNT_ENTRY_SIZE_2D;
+    return new VHeat2D(r, count, h);
+  }
+  
+  if (tag == VH2D_CONTAINER) {
+    uint32_t n;
+    if (depth >= V2D_MAX_DEPTH || size - pos < 1 + sizeof(n)) return nullptr;
+    std::memcpy(&n, data + pos + 1, sizeof(n));
+    pos += 1 + sizeof(n);
+    if (n > size - pos) return nullptr;
+    VHeat2D *container = new VHeat2D();
+    for (uint32_t i = 0; i < n; i++) {
+      VHeat2D *child = deserialize_heatmap_vo_2d(data, size, pos, depth + 1);
+      if (!child) {
+        delete container;
+        return nullptr;
+      }
+      container->append(child);
+    }
+    return container;
+  }
+  
+  size_t used;
+  VObject2D *leaf = deserialize_vo_2d(data + pos, size - pos, used);
+  if (!leaf || leaf->getType() != V2D_LEAF) {
+    delete_vo_2d(leaf);
+    return nullptr;
+  }
+  pos += used;
+  return new VHeat2D(static_cast<VLeaf2D*>(leaf));
+}
+
+/**
+ *  Deserializes a heatmap VO.
+ */
+VHeat2D *deserialize_heatmap_vo_2d(const uint8_t *data, size_t size) {
+  size_t pos = 0;
+  VHeat2D *vo = deserialize_heatmap_vo_2d(data, size, pos, 0);
+  if (vo && pos != size) {
+    delete vo;
+    return nullptr;
+  }
+  return vo;
+}
+
+/**
+ *  Counts the points of each cell of a grid by brute force.
+ */
+std::vector<uint64_t> heatmap_counts_2d(const std::vector<Point2D> &points,
+                                        const HeatmapGrid2D &grid) {
+  std::vector<uint64_t> counts((size_t) grid.nx * grid.ny, 0);
+  if (grid.nx == 0 || grid.ny == 0) return counts;
+  for (const Point2D &p : points) {
+    if (!contains(p, grid.area)) continue;
+    counts[(size_t) heat_cell_2d(p.loc.y, grid.area.ly, grid.area.uy, grid.ny) * grid.nx +
+           heat_cell_2d(p.loc.x, grid.area.lx, grid.area.ux, grid.nx)]++;
+  }
+  return counts;
+}
@@ -0,0 +1,173 @@
+/**
+ *  @file Heatmap2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Authenticated density heatmaps over a count-augmented MR-tree.
+ *
+ *  A CountTree2D adds to an MR-tree a second commitment in which every
+ *  internal entry binds the number of points below the child as well as
+ *  its MBR and digest. Leaves are hashed as in the MR-tree. A heatmap query
+ *  counts the points of each cell of a grid over a rectangle: subtrees
+ *  whose MBR falls inside a single cell are summarized by their count, and
+ *  only the others are opened down to their leaves. The published root
+ *  digest hashes the root's own entry, so it commits to the total count
+ *  and a VO cannot summarize the whole tree with a forged count.
+ */
+
+#ifndef HEATMAP2D_H
+#define HEATMAP2D_H
+
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include <unordered_map>
+#include <vector>
+
+/**
+ *  A grid of nx × ny equal cells over a rectangle. Integer coordinates are
+ *  unit cells, so the grid spans [lx, ux + 1) × [ly, uy + 1).
+ */
+struct HeatmapGrid2D {
+  Rectangle area; ///< The rectangle covered by the grid
+  uint32_t nx;    ///< Number of cells along x
+  uint32_t ny;    ///< Number of cells along y
+};
+
+/**
+ *  Count and count-augmented digest of a node.
+ */
+struct CountEntry2D {
+  uint64_t count; ///< Points below the node
+  hash_t hash;    ///< Count-augmented digest
+};
+
+/**
+ *  Count-augmented commitment over an MR-tree (which it does not own).
+ */
+class CountTree2D {
+private:
+  Node2D *root;                                               ///< Root of the MR-tree
+  std::unordered_map<const Node2D*, CountEntry2D> entries;    ///< Entries of the nodes
+  hash_t digest;                                              ///< Digest of the root entry
+
+  const CountEntry2D &build(Node2D *node);
+
+public:
+  /**
+   *  Computes the counts and count-augmented digests of a tree.
+   *  @param root the root of the 2D MR-tree
+   */
+  CountTree2D(Node2D *root);
+
+  Node2D *getRoot() const { return root; }
+  const CountEntry2D &getEntry(const Node2D *node) const { return entries.at(node); }
+
+  /**
+   *  Returns the count-augmented root digest: the digest of the root's
+   *  entry (MBR, count and digest), so it binds the number of points.
+   */
+  hash_t getHash() const { return digest; }
+
+  /**
+   *  Returns the number of points of the tree.
+   */
+  uint64_t size() const { return root ? entries.at(root).count : 0; }
+};
+
+/**
+ *  This enum defines the kind of a heatmap verification object.
+ */
+enum VHeat2DType {VH2D_LEAF, VH2D_SUMMARY, VH2D_CONTAINER};
+
+/**
+ *  Verification object of a heatmap query: a shipped leaf, a summarized
+ *  subtree (MBR, count and digest) or an opened internal node.
+ */
+class VHeat2D {
+private:
+  VHeat2DType type;
+  Rectangle rect;                 ///< MBR of a summary
+  uint64_t count;                 ///< Count of a summary
+  hash_t hash;                    ///< Digest of a summary
+  VLeaf2D *leaf;                  ///< Shipped leaf
+  std::vector<VHeat2D*> children; ///< Children of a container
+
+public:
+  VHeat2D(VLeaf2D *leaf) : type(VH2D_LEAF), rect(EMPTY_RECT), count(0), hash{}, leaf(leaf) {}
+  VHeat2D(Rectangle r, uint64_t c, hash_t h) : type(VH2D_SUMMARY), rect(r), count(c), hash(h), leaf(nullptr) {}
+  VHeat2D() : type(VH2D_CONTAINER), rect(EMPTY_RECT), count(0), hash{}, leaf(nullptr) {}
+  ~VHeat2D() {
+    delete leaf;
+    for (VHeat2D *child : children) delete child;
+  }
+  VHeat2D(const VHeat2D &) = delete;
+  VHeat2D &operator=(const VHeat2D &) = delete;
+
+  VHeat2DType getType() const { return type; }
+  Rectangle getRect() const { return rect; }
+  uint64_t getCount() const { return count; }
+  hash_t getHash() const { return hash; }
+  VLeaf2D *getLeaf() const { return leaf; }
+  const std::vector<VHeat2D*> &getChildren() const { return children; }
+  void append(VHeat2D *vo) { if (vo) children.push_back(vo); }
+};
+
+/**
+ *  Result of the verification of a heatmap query.
+ */
+struct HeatmapResult2D {
+  bool valid;                   ///< False if a summary overlapping several cells was not opened
+  hash_t hash;                  ///< Reconstructed count-augmented root digest (see CountTree2D::getHash)
+  std::vector<uint64_t> counts; ///< Points per cell, row by row
+};
+
+/**
+ *  Performs a heatmap query.
+ *  @param tree the count-augmented tree
+ *  @param grid the grid
+ *  @param stats optional statistics collector
+ *  @return the verification object
+ */
+VHeat2D *heatmap_query_2d(const CountTree2D &tree, const HeatmapGrid2D &grid,
+                          QueryStats2D *stats = nullptr);
+
+/**
+ *  Verifies a heatmap query.
+ *  The caller must compare the reconstructed hash with the trusted root.
+ *  @param vo the verification object
+ *  @param grid the grid
+ *  @return the verification result
+ */
+HeatmapResult2D verify_heatmap_2d(VHeat2D *vo, const HeatmapGrid2D &grid);
+
+/**
+ *  Returns the size in bytes of the wire encoding of a heatmap VO: leaves
+ *  are encoded as in vo_size_2d, summaries add a count to pruned entries.
+ */
+size_t heatmap_vo_size_2d(VHeat2D *vo);
+
+/**
+ *  Appends the wire encoding of a heatmap VO to a byte vector (heatmap_vo_size_2d(vo) bytes).
+ *  @param vo the verification object
+ *  @param out the output bytes
+ */
+void serialize_heatmap_vo_2d(VHeat2D *vo, std::vector<uint8_t> &out);
+
+/**
+ *  Decodes a heatmap VO.
+ *  @param data the encoded bytes
+ *  @param size the number of bytes
+ *  @return the verification object, or nullptr if the encoding is malformed
+ *          or nests containers deeper than V2D_MAX_DEPTH
+ */
+VHeat2D *deserialize_heatmap_vo_2d(const uint8_t *data, size_t size);
+
+/**
+ *  Counts the points of each cell of a grid by brute force.
+ *  @param points the points
+ *  @param grid the grid
+ *  @return the points per cell, row by row
+ */
+std::vector<uint64_t> heatmap_counts_2d(const std::vector<Point2D> &points,
+                                        const HeatmapGrid2D &grid);
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ *  @file Histogram2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Histogram2D.hpp"
+#include <algorithm>
+
+/**
+ *  Integer coordinates are treated as unit cells, so the histogram spans
+ *  [lx, ux + 1) x [ly, uy + 1).
+ */
+static inline int64_t extent(int32_t lo, int32_t hi) {
+  return (int64_t) hi - lo + 1;
+}
+
+/**
+ *  Returns the column of a (clamped) x-coordinate.
+ */
+size_t Histogram2D::cellX(int32_t x) const {
+  return (size_t) (((int64_t) x - bounds.lx) * (int64_t) nx / extent(bounds.lx, bounds.ux));
+}
+
+/**
+ *  Returns the row of a (clamped) y-coordinate.
+ */
+size_t Histogram2D::cellY(int32_t y) const {
+  return (size_t) (((int64_t) y - bounds.ly) * (int64_t) ny / extent(bounds.ly, bounds.uy));
+}
+
+/**
+ *  Builds the histogram of a set of points.
+ */
+Histogram2D::Histogram2D(const std::vector<Point2D> &points, size_t cells)
+: bounds(compute_mbr(points)), nx(0), ny(0), total(points.size()) {
+  if (points.empty()) return;
+  cells = std::max<size_t>(cells, 1);
+  nx = (size_t) std::min<int64_t>(cells, extent(bounds.lx, bounds.ux));
+  ny = (size_t) std::min<int64_t>(cells, extent(bounds.ly, bounds.uy));
+  counts.assign(nx * ny, 0);
+  for (const Point2D &p : points) counts[cellY(p.loc.y) * nx + cellX(p.loc.x)]++;
+}
+
+/**
+ *  Returns the fraction of cell i (of n cells over [lo, hi]) overlapped by [qlo, qhi].
+ */
+static double overlap(size_t i, size_t n, int32_t lo, int32_t hi, int32_t qlo, int32_t qhi) {
+  double width = (double) extent(lo, hi) / n;
+  double cell_lo = lo + i * width, cell_hi = cell_lo + width;
+  double a = std::max(cell_lo, (double) qlo), b = std::min(cell_hi, (double) qhi + 1);
+  return (b > a) ? (b - a) / width : 0.0;
+}
+
+/**
+ *  Estimates the number of points inside a rectangle.
+ */
+double Histogram2D::estimate(const Rectangle &q) const {
+  if (total == 0) return 0.0;
+  Rectangle r = {std::max(q.lx, bounds.lx), std::max(q.ly, bounds.ly),
+                 std::min(q.ux, bounds.ux), std::min(q.uy, bounds.uy)};
+  if (r.lx > r.ux || r.ly > r.uy) return 0.0;
+
+  size_t x0 = cellX(r.lx), x1 = cellX(r.ux);
+  size_t y0 = cellY(r.ly), y1 = cellY(r.uy);
+  std::vector<double> fx(x1 - x0 + 1);
+  for (size_t i = x0; i <= x1; i++) fx[i - x0] = overlap(i, nx, bounds.lx, bounds.ux, r.lx, r.ux);
+
+  double est = 0.0;
+  for (size_t j = y0; j <= y1; j++) {
+    double fy = overlap(j, ny, bounds.ly, bounds.uy, r.ly, r.uy);
+    const uint32_t *row = &counts[j * nx];
+    double row_est = 0.0;
+    for (size_t i = x0; i <= x1; i++) row_est += row[i] * fx[i - x0];
+    est += row_est * fy;
+  }
+  return est;
+}
@@ -0,0 +1,55 @@
+/**
+ *  @file Histogram2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Equi-width spatial histogram for estimating the result size of 2D range queries
+ */
+
+#ifndef HISTOGRAM2D_H
+#define HISTOGRAM2D_H
+
+#include "Point2D.hpp"
+#include <vector>
+
+/**
+ *  Default number of histogram cells along each axis.
+ */
+#define DEFAULT_HISTOGRAM_CELLS 64
+
+/**
+ *  A grid of point counts over the MBR of a dataset.
+ *  Points are assumed to be uniformly spread inside each cell, so a query
+ *  counts each cell it overlaps in proportion to the overlapping area.
+ */
+class Histogram2D {
+private:
+  Rectangle bounds;             ///< MBR of the points
+  size_t nx;                    ///< Number of cells along x
+  size_t ny;                    ///< Number of cells along y
+  size_t total;                 ///< Number of points
+  std::vector<uint32_t> counts; ///< Points per cell, row by row
+
+  size_t cellX(int32_t x) const;
+  size_t cellY(int32_t y) const;
+
+public:
+  /**
+   *  Builds the histogram of a set of points.
+   *  @param points the points
+   *  @param cells the number of cells along each axis
+   */
+  Histogram2D(const std::vector<Point2D> &points, size_t cells = DEFAULT_HISTOGRAM_CELLS);
+
+  size_t size() const { return total; }
+  Rectangle getBounds() const { return bounds; }
+  size_t sizeInBytes() const { return counts.size() * sizeof(uint32_t); }
+
+  /**
+   *  Estimates the number of points inside a rectangle.
+   *  @param q the query rectangle
+   *  @return the estimated number of points
+   */
+  double estimate(const Rectangle &q) const;
+};
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ *  @file Index2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Index2D.hpp"
+#include <chrono>
+
+using namespace std::chrono;
+
+/**
+ *  Builds the MR-tree.
+ */
+MRTreeIndex2D::MRTreeIndex2D(std::vector<Point2D> points, size_t capacity)
+: root(build_2d_tree(points, capacity)), trusted(root ? root->getHash() : hash_t{}) {}
+
+MRTreeIndex2D::~MRTreeIndex2D() {
+  delete_2d_tree(root);
+}
+
+/**
+ *  Queries an MR-tree, with or without bulk emission, and verifies the
+ *  verification object against the trusted root digest. A missing VO
+ *  (empty tree) or a malformed one gives an invalid result.
+ */
+static IndexResult2D mr_query_verify(Node2D *root, const hash_t &trusted, const Rectangle &q,
+                                     bool bulk, QueryStats2D *stats) {
+  auto query_start = high_resolution_clock::now();
+  VObject2D *vo = bulk ? range_query_bulk_2d(root, q, stats) : range_query_2d(root, q, stats);
+  auto query_end = high_resolution_clock::now();
+  VResult2D *res = verify_2d(vo, q, stats);
+  auto verify_end = high_resolution_clock::now();
+
+  if (stats) {
+    stats->query_time_us += duration_cast<nanoseconds>(query_end - query_start).count() / 1000.0;
+    stats->verify_time_us += duration_cast<nanoseconds>(verify_end - query_end).count() / 1000.0;
+  }
+
+  if (!res) {
+    delete_vo_2d(vo);
+    return IndexResult2D{false, 0, {}};
+  }
+  IndexResult2D out{res->getHash() == trusted, vo_size_2d(vo), res->getPoints()};
+  delete res;
+  delete_vo_2d(vo);
+  return out;
+}
+
+/**
+ *  Queries the MR-tree and verifies the verification object.
+ */
+IndexResult2D MRTreeIndex2D::query(const Rectangle &q, QueryStats2D *stats) const {
+  return mr_query_verify(root, trusted, q, false, stats);
+}
+
+/**
+ *  Builds the Merkle B+-tree on Z-order keys.
+ */
+MBTreeIndex2D::MBTreeIndex2D(const std::vector<Point2D> &points, size_t fanout,
+                             size_t max_intervals)
+: tree(MBT_KEY_Z, fanout, points), max_intervals(max_intervals) {}
+
+/**
+ *  Queries the Merkle B+-tree and verifies the proof.
+ */
+IndexResult2D MBTreeIndex2D::query(const Rectangle &q, QueryStats2D *stats) const {
+  auto query_start = high_resolution_clock::now();
+  MBProof2D proof = mb_rect_query_2d(tree, q, max_intervals, stats);
+  auto query_end = high_resolution_clock::now();
+  MBResult2D res = verify_mb_rect_2d(proof, q, max_intervals, stats);
+  auto verify_end = high_resolution_clock::now();
+
+  if (stats) {
+    stats->query_time_us += duration_cast<nanoseconds>(query_end - query_start).count() / 1000.0;
+    stats->verify_time_us += duration_cast<nanoseconds>(verify_end - query_end).count() / 1000.0;
+  }
+
+  return IndexResult2D{res.valid && res.hash == tree.getHash(),
+                       mb_proof_size_2d(proof), std::move(res.points)};
+}
+
+/**
+ *  Chooses the plan of a query: bulk emission for large windows, the
+ *  alternative index for small ones and tree traversal otherwise.
+ */
+QueryPlan2D plan_query_2d(double estimate, size_t total, bool has_alt,
+                          const PlannerConfig2D &config) {
+  if (total > 0 && estimate >= config.bulk_fraction * total) return QP2D_BULK;
+  if (has_alt && estimate <= config.alt_max_results) return QP2D_ALT;
+  return QP2D_TREE;
+}
+
+/**
+ *  Builds the MR-tree and its histogram.
+ */
+PlannedIndex2D::PlannedIndex2D(const std::vector<Point2D> &points, size_t capacity,
+                               std::unique_ptr<SpatialIndex2D> alt,
+                               const PlannerConfig2D &config, size_t cells)
+: tree(points, capacity), histogram(points, cells), alt(std::move(alt)), config(config) {}
+
+/**
+ *  Returns the plan the planner would choose for a query.
+ */
+QueryPlan2D PlannedIndex2D::plan(const Rectangle &q, double *estimate) const {
+  double est = histogram.estimate(q);
+  if (estimate) *estimate = est;
+  return plan_query_2d(est, histogram.size(), alt != nullptr, config);
+}
+
+/**
+ *  Plans the query, then runs it on the chosen index.
+ */
+IndexResult2D PlannedIndex2D::query(const Rectangle &q, QueryStats2D *stats) const {
+  auto plan_start = high_resolution_clock::now();
+  double est = 0.0;
+  QueryPlan2D p = plan(q, &est);
+  auto plan_end = high_resolution_clock::now();
+
+  if (stats) {
+    stats->estimated_results += est;
+    stats->plan = p;
+    stats->query_time_us += duration_cast<nanoseconds>(plan_end - plan_start).count() / 1000.0;
+  }
+  if (p == QP2D_ALT) return alt->query(q, stats);
+  return mr_query_verify(tree.getRoot(), tree.getHash(), q, p == QP2D_BULK, stats);
+}
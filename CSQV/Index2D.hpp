@@ -0,0 +1,155 @@
+/**
+ *  @file Index2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Common interface for authenticated 2D range query indexes, so that the
+ *  same driver can query, verify and compare them on identical workloads.
+ */
+
+#ifndef INDEX2D_H
+#define INDEX2D_H
+
+#include "Histogram2D.hpp"
+#include "MBTree2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "ZOrder2D.hpp"
+#include <memory>
+#include <string>
+
+/**
+ *  Result of an authenticated range query on a 2D index.
+ */
+struct IndexResult2D {
+  bool valid;                  ///< True if the proof verified against the trusted root
+  size_t proof_bytes;          ///< Size of the wire encoding of the proof
+  std::vector<Point2D> points; ///< Points inside the query rectangle
+};
+
+/**
+ *  An authenticated 2D range query index.
+ */
+class SpatialIndex2D {
+public:
+  virtual ~SpatialIndex2D() {}
+
+  /**
+   *  Returns the name of the index.
+   */
+  virtual std::string getName() const = 0;
+
+  /**
+   *  Returns the root digest the client trusts.
+   */
+  virtual hash_t getHash() const = 0;
+
+  /**
+   *  Builds the proof for a query rectangle and verifies it on the client side.
+   *  Query and verification times are stored in stats.
+   *  @param q the query rectangle
+   *  @param stats optional statistics collector
+   *  @return the verified result
+   */
+  virtual IndexResult2D query(const Rectangle &q, QueryStats2D *stats = nullptr) const = 0;
+};
+
+/**
+ *  The MR-tree (Node2D) behind the common interface.
+ */
+class MRTreeIndex2D : public SpatialIndex2D {
+private:
+  Node2D *root;
+  hash_t trusted; ///< Root digest taken at build time (zero for an empty tree)
+
+public:
+  MRTreeIndex2D(std::vector<Point2D> points, size_t capacity);
+  ~MRTreeIndex2D();
+  MRTreeIndex2D(const MRTreeIndex2D &) = delete;
+  MRTreeIndex2D &operator=(const MRTreeIndex2D &) = delete;
+
+  std::string getName() const override { return "MR-tree"; }
+  hash_t getHash() const override { return trusted; }
+  IndexResult2D query(const Rectangle &q, QueryStats2D *stats = nullptr) const override;
+  Node2D *getRoot() const { return root; }
+};
+
+/**
+ *  The Z-keyed Merkle B+-tree behind the common interface.
+ */
+class MBTreeIndex2D : public SpatialIndex2D {
+private:
+  MBTree2D tree;
+  size_t max_intervals;
+
+public:
+  MBTreeIndex2D(const std::vector<Point2D> &points, size_t fanout,
+                size_t max_intervals = DEFAULT_MAX_INTERVALS);
+
+  std::string getName() const override { return "MB-tree (Z-order)"; }
+  hash_t getHash() const override { return tree.getHash(); }
+  IndexResult2D query(const Rectangle &q, QueryStats2D *stats = nullptr) const override;
+};
+
+/**
+ *  Thresholds of the query planner.
+ */
+struct PlannerConfig2D {
+  double bulk_fraction;   ///< Estimated fraction of the points from which contained subtrees are emitted in bulk
+  double alt_max_results; ///< Estimated result size up to which the alternative index is used
+
+  PlannerConfig2D() : bulk_fraction(0.25), alt_max_results(1000) {}
+};
+
+/**
+ *  Chooses the plan of a query from its estimated result size.
+ *  @param estimate the estimated number of results
+ *  @param total the number of indexed points
+ *  @param has_alt true if an alternative index is available
+ *  @param config the planner thresholds
+ *  @return the plan
+ */
+QueryPlan2D plan_query_2d(double estimate, size_t total, bool has_alt,
+                          const PlannerConfig2D &config);
+
+/**
+ *  The MR-tree with a spatial histogram built alongside it and a planner
+ *  choosing, for each query, between tree traversal, bulk emission of
+ *  contained subtrees and an optional alternative index over the same points.
+ *  The estimate and the chosen plan are reported in QueryStats2D.
+ */
+class PlannedIndex2D : public SpatialIndex2D {
+private:
+  MRTreeIndex2D tree;
+  Histogram2D histogram;
+  std::unique_ptr<SpatialIndex2D> alt;
+  PlannerConfig2D config;
+
+public:
+  /**
+   *  Builds the MR-tree and its histogram.
+   *  @param points the points to index
+   *  @param capacity the leaf capacity of the MR-tree
+   *  @param alt optional alternative index over the same points
+   *  @param config the planner thresholds
+   *  @param cells the number of histogram cells along each axis
+   */
+  PlannedIndex2D(const std::vector<Point2D> &points, size_t capacity,
+                 std::unique_ptr<SpatialIndex2D> alt = nullptr,
+                 const PlannerConfig2D &config = PlannerConfig2D(),
+                 size_t cells = DEFAULT_HISTOGRAM_CELLS);
+
+  std::string getName() const override { return "MR-tree (planned)"; }
+  hash_t getHash() const override { return tree.getHash(); }
+  IndexResult2D query(const Rectangle &q, QueryStats2D *stats = nullptr) const override;
+  const Histogram2D &getHistogram() const { return histogram; }
+
+  /**
+   *  Returns the plan the planner would choose for a query.
+   *  @param q the query rectangle
+   *  @param estimate optional output for the estimated result size
+   *  @return the plan
+   */
+  QueryPlan2D plan(const Rectangle &q, double *estimate = nullptr) const;
+};
+
+#endif
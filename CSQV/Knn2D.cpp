@@ -0,0 +1,221 @@
+/**
+ *  @file Knn2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Knn2D.hpp"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+/**
+ *  Returns dx^2 + dy^2, saturated at UINT64_MAX.
+ */
+static inline uint64_t sum_squares_2d(uint64_t dx, uint64_t dy) {
+  uint64_t a = dx * dx, b = dy * dy;
+  return (a > UINT64_MAX - b) ? UINT64_MAX : a + b;
+}
+
+/**
+ *  Returns the squared distance of a point from (x, y).
+ */
+uint64_t knn_distance2_2d(const Point2D &p, int32_t x, int32_t y) {
+  return sum_squares_2d((uint64_t) std::llabs((int64_t) p.loc.x - x),
+                        (uint64_t) std::llabs((int64_t) p.loc.y - y));
+}
+
+/**
+ *  Returns the squared distance of a rectangle from (x, y).
+ */
+static uint64_t min_distance2_2d(const Rectangle &r, int32_t x, int32_t y) {
+  int64_t dx = (x < r.lx) ? (int64_t) r.lx - x : (x > r.ux) ? (int64_t) x - r.ux : 0;
+  int64_t dy = (y < r.ly) ? (int64_t) r.ly - y : (y > r.uy) ? (int64_t) y - r.uy : 0;
+  return sum_squares_2d(dx, dy);
+}
+
+/**
+ *  Returns the smallest r with r^2 >= d2.
+ */
+static uint64_t ceil_sqrt_2d(uint64_t d2) {
+  uint64_t r = (uint64_t) std::sqrt((long double) d2);
+  while (r < ((uint64_t) 1 << 32) && r * r < d2) r++;
+  while (r > 0 && r - 1 < ((uint64_t) 1 << 32) && (r - 1) * (r - 1) >= d2) r--;
+  return r;
+}
+
+/**
+ *  Returns true if (a, b) precedes (c, d): nearer first, then smaller ID.
+ */
+static inline bool nearer_2d(uint64_t d2a, uint32_t ida, uint64_t d2b, uint32_t idb) {
+  return d2a < d2b || (d2a == d2b && ida < idb);
+}
+
+/**
+ *  Returns the square window of a given half-width around (x, y).
+ */
+Rectangle knn_window_2d(int32_t x, int32_t y, uint64_t radius) {
+  int64_t r = (int64_t) std::min(radius, KNN2D_FULL_RADIUS);
+  auto clamp = [](int64_t v) {
+    return (int32_t) std::max<int64_t>(INT32_MIN, std::min<int64_t>(INT32_MAX, v));
+  };
+  return Rectangle{clamp(x - r), clamp(y - r), clamp(x + r), clamp(y + r)};
+}
+
+/**
+ *  Returns the squared distance of the k-th nearest point, found by a
+ *  best-first search, or UINT64_MAX if the tree has fewer than k points.
+ */
+static uint64_t kth_distance2_2d(Node2D *root, int32_t x, int32_t y, size_t k, QueryStats2D *stats) {
+  typedef std::pair<uint64_t, Node2D*> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> frontier;
+  std::priority_queue<uint64_t> best;  ///< The k smallest distances so far
+  frontier.push(Entry(min_distance2_2d(root->getRect(), x, y), root));
+  
+  while (!frontier.empty()) {
+    Entry e = frontier.top();
+    frontier.pop();
+    if (best.size() == k && e.first > best.top()) break;
+    if (stats) stats->nodes_visited++;
+    
+    if (e.second->getType() == N2D_LEAF) {
+      const std::vector<Point2D> &points = static_cast<LeafNode2D*>(e.second)->getPoints();
+      if (stats) stats->points_examined += points.size();
+      for (const Point2D &p : points) {
+        uint64_t d2 = knn_distance2_2d(p, x, y);
+        if (best.size() < k) best.push(d2);
+        else if (d2 < best.top()) {
+          best.pop();
+          best.push(d2);
+        }
+      }
+      continue;
+    }
+    for (Node2D *child : static_cast<IntNode2D*>(e.second)->getChildren()) {
+      uint64_t d2 = min_distance2_2d(child->getRect(), x, y);
+      if (best.size() < k || d2 <= best.top()) frontier.push(Entry(d2, child));
+    }
+  }
+  return (best.size() == k) ? best.top() : UINT64_MAX;
+}
+
+/**
+ *  Recursive step of the window proof: overlapping leaves are shipped.
+ */
+static VObject2D *knn_window_query_2d(Node2D *root, const Rectangle &window, QueryStats2D *stats) {
+  if (!overlap(root->getRect(), window)) {
+    if (stats) stats->nodes_pruned++;
+    return new VPruned2D(root->getRect(), root->getHash());
+  }
+  
+  if (root->getType() == N2D_LEAF) {
+    LeafNode2D *leaf = static_cast<LeafNode2D*>(root);
+    return ship_leaf_2d(leaf);
+  }
+  
+  VContainer2D *container = new VContainer2D();
+  for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+    container->append(knn_window_query_2d(child, window, stats));
+  }
+  return container;
+}
+
+/**
+ *  Performs a 2D kNN query.
+ */
+VObject2D *knn_query_2d(Node2D *root, int32_t x, int32_t y, size_t k, uint64_t &radius,
+                        QueryStats2D *stats) {
+  if (!root || k == 0) return nullptr;
+  uint64_t d2 = kth_distance2_2d(root, x, y, k, stats);
+  radius = (d2 == UINT64_MAX) ? KNN2D_FULL_RADIUS : std::min(ceil_sqrt_2d(d2), KNN2D_FULL_RADIUS);
+  return knn_window_query_2d(root, knn_window_2d(x, y, radius), stats);
+}
+
+/**
+ *  State of the verification of a kNN query.
+ */
+struct KnnVerify2D {
+  const Rectangle &window;
+  std::vector<Point2D> points; ///< Points inside the window
+  bool complete;               ///< False if a pruned node overlaps the window
+  QueryStats2D *stats;
+};
+
+/**
+ *  Recursive step of the verification of a kNN query.
+ */
+static void verify_knn_2d(VObject2D *vo, KnnVerify2D &st, Rectangle &rect, hash_t &hash) {
+  switch (vo->getType()) {
+    case V2D_LEAF: {
+      VResult2D *res = verify_2d(vo, st.window, st.stats);
+      rect = res->getRect();
+      hash = res->getHash();
+      st.points.insert(st.points.end(), res->getPoints().begin(), res->getPoints().end());
+      delete res;
+      return;
+    }
+    
+    case V2D_PRUNED: {
+      VPruned2D *pruned = static_cast<VPruned2D*>(vo);
+      rect = pruned->getRect();
+      hash = pruned->getHash();
+      if (overlap(rect, st.window)) st.complete = false;
+      return;
+    }
+    
+    case V2D_CONTAINER: {
+      VContainer2D *container = static_cast<VContainer2D*>(vo);
+      verify_children_2d(container, [&](size_t i, Rectangle &child_rect, hash_t &child_hash) {
+        verify_knn_2d(container->get(i), st, child_rect, child_hash);
+      }, rect, hash);
+      return;
+    }
+  }
+}
+
+/**
+ *  Sorts points by distance from (x, y), then by ID, and keeps the first k.
+ */
+static void keep_nearest_2d(std::vector<Point2D> &points, int32_t x, int32_t y, size_t k) {
+  auto cmp = [x, y](const Point2D &a, const Point2D &b) {
+    return nearer_2d(knn_distance2_2d(a, x, y), a.id, knn_distance2_2d(b, x, y), b.id);
+  };
+  if (points.size() > k) {
+    std::nth_element(points.begin(), points.begin() + k, points.end(), cmp);
+    points.resize(k);
+  }
+  std::sort(points.begin(), points.end(), cmp);
+}
+
+/**
+ *  Verifies a 2D kNN query.
+ */
+VResult2D *verify_knn_2d(VObject2D *vo, int32_t x, int32_t y, size_t k, uint64_t radius,
+                         QueryStats2D *stats) {
+  if (!vo || k == 0) return nullptr;
+  
+  Rectangle window = knn_window_2d(x, y, radius);
+  KnnVerify2D st{window, {}, true, stats};
+  Rectangle rect;
+  hash_t hash;
+  verify_knn_2d(vo, st, rect, hash);
+  if (!st.complete) return nullptr;
+  
+  // The window must reach the k-th point, or cover everything if there are fewer.
+  keep_nearest_2d(st.points, x, y, k);
+  if (st.points.size() < k) {
+    if (radius < KNN2D_FULL_RADIUS) return nullptr;
+  } else if (radius < ((uint64_t) 1 << 32) &&
+             knn_distance2_2d(st.points.back(), x, y) > radius * radius) {
+    return nullptr;
+  }
+  return new VResult2D(rect, hash, std::move(st.points));
+}
+
+/**
+ *  Returns the k nearest points by brute force.
+ */
+std::vector<Point2D> knn_scan_2d(const std::vector<Point2D> &points, int32_t x, int32_t y, size_t k) {
+  std::vector<Point2D> result = points;
+  keep_nearest_2d(result, x, y, k);
+  return result;
+}
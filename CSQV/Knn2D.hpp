@@ -0,0 +1,77 @@
+/**
+ *  @file Knn2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Verified k-nearest-neighbour queries on the 2D MR-tree.
+ *
+ *  The server finds the distance d of the k-th nearest point with a
+ *  best-first search and answers with the radius r = ceil(d) and the proof
+ *  of the square window of half-width r around the query point: every
+ *  overlapping leaf is shipped and every other node pruned. Any point at
+ *  distance at most d lies in the window, so the client gets the k nearest
+ *  points from the verified window alone, after checking that the k-th of
+ *  them is within r. With fewer than k points the window covers the whole
+ *  coordinate space. Distances are Euclidean; ties are broken by ID.
+ */
+
+#ifndef KNN2D_H
+#define KNN2D_H
+
+#include "Query2D.hpp"
+
+/**
+ *  Radius of a window covering the whole coordinate space.
+ */
+#define KNN2D_FULL_RADIUS ((uint64_t) UINT32_MAX)
+
+/**
+ *  Returns the squared Euclidean distance of a point from (x, y), saturated at UINT64_MAX.
+ */
+uint64_t knn_distance2_2d(const Point2D &p, int32_t x, int32_t y);
+
+/**
+ *  Returns the square window of a given half-width around (x, y), clamped
+ *  to the coordinate space.
+ */
+Rectangle knn_window_2d(int32_t x, int32_t y, uint64_t radius);
+
+/**
+ *  Performs a 2D kNN query.
+ *  @param root the root of the 2D MR-tree
+ *  @param x the x-coordinate of the query point
+ *  @param y the y-coordinate of the query point
+ *  @param k the number of neighbours (at least 1)
+ *  @param radius receives the half-width of the window the proof covers
+ *  @param stats optional statistics collector
+ *  @return the verification object of the window, nullptr if the tree is empty or k is 0
+ */
+VObject2D *knn_query_2d(Node2D *root, int32_t x, int32_t y, size_t k, uint64_t &radius,
+                        QueryStats2D *stats = nullptr);
+
+/**
+ *  Verifies a 2D kNN query.
+ *  The caller must compare the reconstructed hash with the trusted root.
+ *  @param vo the verification object
+ *  @param x the x-coordinate of the query point
+ *  @param y the y-coordinate of the query point
+ *  @param k the number of neighbours
+ *  @param radius the half-width of the window sent by the server
+ *  @param stats optional statistics collector
+ *  @return the verification result with the k nearest points, nearest first
+ *          (all points if there are fewer), or nullptr if a pruned node
+ *          overlaps the window or the window is too small
+ */
+VResult2D *verify_knn_2d(VObject2D *vo, int32_t x, int32_t y, size_t k, uint64_t radius,
+                         QueryStats2D *stats = nullptr);
+
+/**
+ *  Returns the k nearest points by brute force, nearest first.
+ *  @param points the points
+ *  @param x the x-coordinate of the query point
+ *  @param y the y-coordinate of the query point
+ *  @param k the number of neighbours
+ *  @return the k nearest points
+ */
+std::vector<Point2D> knn_scan_2d(const std::vector<Point2D> &points, int32_t x, int32_t y, size_t k);
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ *  @file LearnedIndex2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "LearnedIndex2D.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ *  Builds the model with the shrinking-cone algorithm: each segment starts
+ *  at a key and keeps the range of slopes that predicts every following
+ *  key within epsilon; when the range becomes empty a new segment starts.
+ *  Only the first position of each distinct key is fitted.
+ */
+LearnedIndex2D::LearnedIndex2D(const std::vector<uint64_t> &keys, size_t epsilon)
+: epsilon(std::max<size_t>(epsilon, 1)), n(keys.size()) {
+  if (keys.empty()) return;
+
+  const double eps = static_cast<double>(this->epsilon);
+  LISegment2D seg{keys[0], 0, 0.0};
+  double slope_lo = 0.0;
+  double slope_hi = std::numeric_limits<double>::infinity();
+
+  for (size_t i = 1; i < keys.size(); i++) {
+    if (keys[i] == keys[i - 1]) continue;
+    double dx = static_cast<double>(keys[i] - seg.key);
+    double dy = static_cast<double>(i - seg.pos);
+    double lo = (dy - eps) / dx;
+    double hi = (dy + eps) / dx;
+    if (lo > slope_hi || hi < slope_lo) {
+      seg.slope = std::isinf(slope_hi) ? 0.0 : (slope_lo + slope_hi) / 2;
+      segments.push_back(seg);
+      seg = LISegment2D{keys[i], i, 0.0};
+      slope_lo = 0.0;
+      slope_hi = std::numeric_limits<double>::infinity();
+    } else {
+      slope_lo = std::max(slope_lo, lo);
+      slope_hi = std::min(slope_hi, hi);
+    }
+  }
+  seg.slope = std::isinf(slope_hi) ? 0.0 : (slope_lo + slope_hi) / 2;
+  segments.push_back(seg);
+}
+
+/**
+ *  Returns the position of the first key not less than k.
+ */
+size_t LearnedIndex2D::lower_bound(const std::vector<uint64_t> &keys, uint64_t k) const {
+  if (segments.empty() || k <= segments[0].key) return 0;
+
+  // Segment whose first key is the last one not greater than k.
+  auto it = std::upper_bound(segments.begin(), segments.end(), k,
+    [](uint64_t key, const LISegment2D &s) { return key < s.key; }) - 1;
+  size_t seg_begin = it->pos;
+  size_t seg_end = (it + 1 == segments.end()) ? n : (it + 1)->pos;
+
+  double pred = it->pos + it->slope * static_cast<double>(k - it->key);
+  size_t p = static_cast<size_t>(std::min<double>(std::max(pred, 0.0), n));
+  size_t lo = std::max(seg_begin, p > epsilon + 1 ? p - epsilon - 1 : 0);
+  size_t hi = std::min(seg_end, p + epsilon + 2);
+
+  if (lo < hi) {
+    size_t r = std::lower_bound(keys.begin() + lo, keys.begin() + hi, k) - keys.begin();
+    bool left_ok = (r == 0 || keys[r - 1] < k);
+    bool right_ok = (r == keys.size() || keys[r] >= k);
+    if (left_ok && right_ok) return r;
+  }
+  return std::lower_bound(keys.begin() + seg_begin, keys.begin() + seg_end, k) - keys.begin();
+}
+
+/**
+ *  Returns the position of the first key greater than k.
+ */
+size_t LearnedIndex2D::upper_bound(const std::vector<uint64_t> &keys, uint64_t k) const {
+  if (k == std::numeric_limits<uint64_t>::max()) return keys.size();
+  return lower_bound(keys, k + 1);
+}
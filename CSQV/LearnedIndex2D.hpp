@@ -0,0 +1,85 @@
+/**
+ *  @file LearnedIndex2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Learned index over sorted 64-bit keys (Morton codes or point IDs).
+ *
+ *  A piecewise-linear model, built in one pass with the shrinking-cone
+ *  algorithm of the PGM-index, predicts the position of each key within
+ *  `epsilon` entries. A lookup finds the segment of the key with a binary
+ *  search over the segment keys, evaluates it and searches only the
+ *  2*epsilon+1 positions around the prediction.
+ */
+
+#ifndef LEARNEDINDEX2D_H
+#define LEARNEDINDEX2D_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ *  Default maximum error of the model, in positions.
+ */
+#define DEFAULT_LEARNED_EPSILON 32
+
+/**
+ *  A segment of the model: keys from `key` up to the next segment are at
+ *  position pos + slope * (k - key), within epsilon.
+ */
+struct LISegment2D {
+  uint64_t key;   ///< First key of the segment
+  uint64_t pos;   ///< Position of the first key
+  double slope;   ///< Positions per key unit
+};
+
+/**
+ *  Piecewise-linear model mapping sorted keys to their positions.
+ */
+class LearnedIndex2D {
+private:
+  size_t epsilon;                     ///< Maximum error of the predictions
+  size_t n;                           ///< Number of keys
+  std::vector<LISegment2D> segments;  ///< Segments, sorted on their first key
+
+public:
+  LearnedIndex2D() : epsilon(0), n(0) {}
+
+  /**
+   *  Builds the model.
+   *  @param keys the sorted keys (duplicates allowed)
+   *  @param epsilon the maximum error of the predictions (at least 1)
+   */
+  LearnedIndex2D(const std::vector<uint64_t> &keys, size_t epsilon = DEFAULT_LEARNED_EPSILON);
+
+  bool empty() const { return segments.empty(); }
+  size_t getEpsilon() const { return epsilon; }
+  size_t countSegments() const { return segments.size(); }
+  const std::vector<LISegment2D> &getSegments() const { return segments; }
+
+  /**
+   *  Returns the memory used by the model in bytes.
+   */
+  size_t sizeInBytes() const { return segments.size() * sizeof(LISegment2D); }
+
+  /**
+   *  Returns the position of the first key not less than k, like
+   *  std::lower_bound. If the prediction window misses (which the model
+   *  rules out for keys of the training set), falls back to a binary search
+   *  between the surrounding segments, so the result is always exact.
+   *  @param keys the keys the model was built on
+   *  @param k the key to search
+   *  @return the position of the first key not less than k
+   */
+  size_t lower_bound(const std::vector<uint64_t> &keys, uint64_t k) const;
+
+  /**
+   *  Returns the position of the first key greater than k, like std::upper_bound.
+   *  @param keys the keys the model was built on
+   *  @param k the key to search
+   *  @return the position of the first key greater than k
+   */
+  size_t upper_bound(const std::vector<uint64_t> &keys, uint64_t k) const;
+};
+
+#endif
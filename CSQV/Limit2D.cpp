@@ -0,0 +1,105 @@
+/**
+ *  @file Limit2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Limit2D.hpp"
+
+/**
+ *  Recursive step of a LIMIT-N query; found counts the matches shipped so far.
+ */
+static VObject2D *limit_query_2d(Node2D *root, const Rectangle &query, size_t limit,
+                                 size_t &found, QueryStats2D *stats) {
+  if (found >= limit || !overlap(root->getRect(), query)) {
+    if (stats) stats->nodes_pruned++;
+    return new VPruned2D(root->getRect(), root->getHash());
+  }
+  if (stats) stats->nodes_visited++;
+  
+  if (root->getType() == N2D_LEAF) {
+    LeafNode2D *leaf = static_cast<LeafNode2D*>(root);
+    if (stats) stats->points_examined += leaf->size();
+    for (const Point2D &p : leaf->getPoints()) {
+      if (contains(p, query)) found++;
+    }
+    return ship_leaf_2d(leaf);
+  }
+  
+  VContainer2D *container = new VContainer2D();
+  for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+    container->append(limit_query_2d(child, query, limit, found, stats));
+  }
+  return container;
+}
+
+/**
+ *  Performs a 2D range query for the first limit matching points in curve order.
+ */
+VObject2D *limit_query_2d(Node2D *root, const Rectangle &query, size_t limit,
+                          QueryStats2D *stats) {
+  if (!root) return nullptr;
+  size_t found = 0;
+  return limit_query_2d(root, query, limit, found, stats);
+}
+
+/**
+ *  State of the verification of a LIMIT-N query.
+ */
+struct LimitVerify2D {
+  const Rectangle &query;
+  size_t limit;
+  std::vector<Point2D> points; ///< Matches so far, in curve order
+  bool complete;               ///< False if a pruned node may hide an earlier match
+  QueryStats2D *stats;
+};
+
+/**
+ *  Recursive step of the verification of a LIMIT-N query.
+ */
+static void verify_limit_2d(VObject2D *vo, LimitVerify2D &st, Rectangle &rect, hash_t &hash) {
+  switch (vo->getType()) {
+    case V2D_LEAF: {
+      VResult2D *res = verify_2d(vo, st.query, nullptr);
+      rect = res->getRect();
+      hash = res->getHash();
+      for (const Point2D &p : res->getPoints()) {
+        if (st.points.size() >= st.limit) break;
+        st.points.push_back(p);
+        if (st.stats) st.stats->points_returned++;
+      }
+      delete res;
+      return;
+    }
+    
+    case V2D_PRUNED: {
+      VPruned2D *pruned = static_cast<VPruned2D*>(vo);
+      rect = pruned->getRect();
+      hash = pruned->getHash();
+      if (st.points.size() < st.limit && overlap(rect, st.query)) st.complete = false;
+      return;
+    }
+    
+    case V2D_CONTAINER: {
+      VContainer2D *container = static_cast<VContainer2D*>(vo);
+      verify_children_2d(container, [&](size_t i, Rectangle &child_rect, hash_t &child_hash) {
+        verify_limit_2d(container->get(i), st, child_rect, child_hash);
+      }, rect, hash);
+      return;
+    }
+  }
+}
+
+/**
+ *  Verifies a LIMIT-N range query.
+ */
+VResult2D *verify_limit_2d(VObject2D *vo, const Rectangle &query, size_t limit,
+                           QueryStats2D *stats) {
+  if (!vo) return nullptr;
+  
+  LimitVerify2D st{query, limit, {}, true, stats};
+  Rectangle rect;
+  hash_t hash;
+  verify_limit_2d(vo, st, rect, hash);
+  if (!st.complete) return nullptr;
+  return new VResult2D(rect, hash, std::move(st.points));
+}
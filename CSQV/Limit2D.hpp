@@ -0,0 +1,44 @@
+/**
+ *  @file Limit2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Verified LIMIT-N range queries in curve order.
+ *
+ *  Leaves of the MR-tree, and points within leaves, are in sort order
+ *  (Morton order with Z_INDEX), so a depth-first traversal meets points in
+ *  curve order. The server ships overlapping leaves until N matches are
+ *  found and prunes everything after. The verifier replays the traversal:
+ *  a pruned node overlapping the query is only allowed once N matches have
+ *  been seen, so the result is exactly the first N matches.
+ */
+
+#ifndef LIMIT2D_H
+#define LIMIT2D_H
+
+#include "Query2D.hpp"
+
+/**
+ *  Performs a 2D range query for the first limit matching points in curve order.
+ *  @param root the root of the 2D MR-tree
+ *  @param query the query rectangle
+ *  @param limit the maximum number of points
+ *  @param stats optional statistics collector
+ *  @return the verification object
+ */
+VObject2D *limit_query_2d(Node2D *root, const Rectangle &query, size_t limit,
+                          QueryStats2D *stats = nullptr);
+
+/**
+ *  Verifies a LIMIT-N range query.
+ *  The caller must compare the reconstructed hash with the trusted root.
+ *  @param vo the verification object
+ *  @param query the query rectangle
+ *  @param limit the maximum number of points
+ *  @param stats optional statistics collector
+ *  @return the verification result with the first matching points in curve
+ *          order, or nullptr if a match before the last one may be missing
+ */
+VResult2D *verify_limit_2d(VObject2D *vo, const Rectangle &query, size_t limit,
+                           QueryStats2D *stats = nullptr);
+
+#endif
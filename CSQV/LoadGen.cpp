@@ -0,0 +1,128 @@
+/**
+ *  @file LoadGen.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Open-loop load generator: replays range queries against the in-process
+ *  engine or a query server at increasing arrival rates and reports the
+ *  throughput and latency at each, up to the saturation point
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "LoadGen2D.hpp"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <query_file|num_queries> <target> <rates> [threads] [requests] [trace_file]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  query_file: CSV file with format lx,ly,ux,uy,matching,fraction" << std::endl;
+  std::cout << "  num_queries: number of random queries (instead of a query file)" << std::endl;
+  std::cout << "  target: engine (in-process) or the address of a QueryServer (unix:<path>, tcp:<port>)" << std::endl;
+  std::cout << "  rates: comma-separated arrival rates in requests/s, e.g. 1000,2000,4000" << std::endl;
+  std::cout << "  threads: number of engine worker threads (default: 0 = all cores)" << std::endl;
+  std::cout << "  requests: number of requests per rate (default: 2000)" << std::endl;
+  std::cout << "  trace_file: arrival timestamps in seconds, one per line, scaled to each rate" << std::endl;
+  std::cout << "              instead of Poisson arrivals (rate 0 replays the trace as recorded)" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 6) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  std::string query_arg = argv[3];
+  std::string target = argv[4];
+  size_t threads = (argc > 6) ? std::stoul(argv[6]) : 0;
+  size_t requests = (argc > 7) ? std::stoul(argv[7]) : 2000;
+  std::string trace_file = (argc > 8) ? argv[8] : "";
+
+  std::vector<double> rates;
+  std::stringstream list(argv[5]);
+  for (std::string item; std::getline(list, item, ',');) rates.push_back(std::stod(item));
+  if (rates.empty()) {
+    std::cerr << "Error: No arrival rates given" << std::endl;
+    return 1;
+  }
+
+  std::vector<double> trace;
+  if (!trace_file.empty()) {
+    trace = load_arrivals_2d(trace_file);
+    if (trace.empty()) return 1;
+  }
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  std::vector<Rectangle> queries;
+  if (query_arg.find_first_not_of("0123456789") == std::string::npos) {
+    queries = generate_random_queries_2d(compute_mbr(points), std::stoul(query_arg));
+  } else {
+    queries = load_queries_2d(query_arg);
+  }
+  if (queries.empty()) {
+    std::cerr << "Error: No queries loaded" << std::endl;
+    return 1;
+  }
+
+  // The engine needs the tree here; a server has built its own.
+  Node2D *root = nullptr;
+  bool engine = target == "engine";
+  if (engine) root = build_2d_tree(points, capacity);
+
+  std::cout << "=== Open-loop load on " << target << " ("
+            << (trace.empty() ? "Poisson arrivals" : "trace " + trace_file) << ") ===" << std::endl;
+  std::cout << std::setw(12) << "offered/s" << std::setw(12) << "achieved/s" << std::setw(8) << "failed"
+            << std::setw(12) << "mean μs" << std::setw(12) << "p50 μs" << std::setw(12) << "p90 μs"
+            << std::setw(12) << "p99 μs" << std::setw(12) << "max μs" << std::setw(12) << "queue μs" << std::endl;
+
+  bool ok = true;
+  LoadResult2D baseline = {};
+  double sustained = 0, saturated = 0;
+  std::cout << std::fixed << std::setprecision(1);
+  for (size_t r = 0; r < rates.size() && ok; r++) {
+    std::vector<double> arrivals;
+    if (trace.empty()) arrivals = poisson_arrivals_2d(requests, rates[r], r + 1);
+    else arrivals = (rates[r] > 0) ? scale_arrivals_2d(trace, rates[r]) : trace;
+    if (arrivals.empty()) {
+      std::cerr << "Error: Rate " << rates[r] << " gives no arrivals" << std::endl;
+      ok = false;
+      break;
+    }
+
+    LoadResult2D res;
+    if (engine) res = run_engine_load_2d(root, queries, arrivals, threads);
+    else ok = run_server_load_2d(target, queries, arrivals, res);
+    if (!ok) break;
+
+    std::cout << std::setw(12) << res.offered_rate << std::setw(12) << res.achieved_rate << std::setw(8) << res.failed
+              << std::setw(12) << res.mean_us << std::setw(12) << res.p50_us << std::setw(12) << res.p90_us
+              << std::setw(12) << res.p99_us << std::setw(12) << res.max_us << std::setw(12) << res.mean_queue_us << std::endl;
+
+    if (r == 0) baseline = res;
+    if (load_saturated_2d(res, baseline)) {
+      if (saturated == 0) saturated = res.offered_rate;
+    } else if (saturated == 0) {
+      sustained = res.offered_rate;
+    }
+  }
+  if (root) delete_2d_tree(root);
+  if (!ok) return 1;
+
+  if (saturated == 0) {
+    std::cout << "Not saturated up to " << sustained << " requests/s" << std::endl;
+  } else {
+    std::cout << "Saturation between " << sustained << " and " << saturated << " requests/s"
+              << " (goodput below " << LOADGEN2D_MIN_GOODPUT * 100 << "% of the offered rate or p99 above "
+              << LOADGEN2D_MAX_P99_GROWTH << "x the lightest load)" << std::endl;
+  }
+  return 0;
+}
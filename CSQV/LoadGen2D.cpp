@@ -0,0 +1,245 @@
+/**
+ *  @file LoadGen2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "LoadGen2D.hpp"
+#include "Server2D.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace std::chrono;
+
+/**
+ *  Draws Poisson arrival times.
+ */
+std::vector<double> poisson_arrivals_2d(size_t count, double rate, uint32_t seed) {
+  std::vector<double> arrivals;
+  if (rate <= 0) return arrivals;
+  arrivals.reserve(count);
+  std::mt19937 rng(seed);
+  std::exponential_distribution<double> gap(rate / 1e6);
+  double t = 0;
+  for (size_t i = 0; i < count; i++) {
+    t += gap(rng);
+    arrivals.push_back(t);
+  }
+  return arrivals;
+}
+
+/**
+ *  Loads a trace of arrival times, one timestamp in seconds per line.
+ */
+std::vector<double> load_arrivals_2d(const std::string &path) {
+  std::vector<double> arrivals;
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "Error: Cannot open trace file " << path << std::endl;
+    return arrivals;
+  }
+  std::string line;
+  size_t line_no = 0;
+  while (std::getline(in, line)) {
+    line_no++;
+    if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+    char *end;
+    double t = std::strtod(line.c_str(), &end);
+    if (end == line.c_str() || (!arrivals.empty() && t * 1e6 < arrivals.back())) {
+      std::cerr << "Error: Bad or unsorted timestamp on line " << line_no << " of " << path << std::endl;
+      return {};
+    }
+    arrivals.push_back(t * 1e6);
+  }
+  for (size_t i = 1; i < arrivals.size(); i++) arrivals[i] -= arrivals[0];
+  if (!arrivals.empty()) arrivals[0] = 0;
+  return arrivals;
+}
+
+/**
+ *  Offered rate of an arrival schedule, in requests per second.
+ */
+static double offered_rate_2d(const std::vector<double> &arrivals) {
+  if (arrivals.empty() || arrivals.back() <= 0) return 0.0;
+  return arrivals.size() / (arrivals.back() / 1e6);
+}
+
+/**
+ *  Stretches or compresses a trace to a given mean rate.
+ */
+std::vector<double> scale_arrivals_2d(const std::vector<double> &arrivals, double rate) {
+  std::vector<double> scaled = arrivals;
+  double current = offered_rate_2d(arrivals);
+  if (current <= 0 || rate <= 0) return scaled;
+  for (double &t : scaled) t *= current / rate;
+  return scaled;
+}
+
+/**
+ *  Returns the p-th percentile of a sorted list of values.
+ */
+static double percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty()) return 0.0;
+  return sorted[std::min(sorted.size() - 1, (size_t) (p * sorted.size()))];
+}
+
+/**
+ *  Computes the result of a run from the times of its requests, all in
+ *  microseconds from the start. A request with done < 0 was not answered.
+ */
+static LoadResult2D summarize_load_2d(const std::vector<double> &arrivals, const std::vector<double> &started,
+                                      const std::vector<double> &done, const std::vector<bool> &ok) {
+  LoadResult2D result = {};
+  result.offered_rate = offered_rate_2d(arrivals);
+  std::vector<double> latencies;
+  double queued = 0, last = 0;
+  for (size_t i = 0; i < arrivals.size(); i++) {
+    if (done[i] < 0 || !ok[i]) {
+      result.failed++;
+      continue;
+    }
+    latencies.push_back(done[i] - arrivals[i]);
+    queued += started[i] - arrivals[i];
+    last = std::max(last, done[i]);
+  }
+  result.completed = latencies.size();
+  if (latencies.empty()) return result;
+
+  std::sort(latencies.begin(), latencies.end());
+  double sum = 0;
+  for (double l : latencies) sum += l;
+  result.mean_us = sum / latencies.size();
+  result.p50_us = percentile(latencies, 0.5);
+  result.p90_us = percentile(latencies, 0.9);
+  result.p99_us = percentile(latencies, 0.99);
+  result.max_us = latencies.back();
+  result.mean_queue_us = queued / latencies.size();
+  if (last > arrivals[0]) result.achieved_rate = result.completed / ((last - arrivals[0]) / 1e6);
+  return result;
+}
+
+/**
+ *  Replays queries against the in-process engine.
+ */
+LoadResult2D run_engine_load_2d(Node2D *root, const std::vector<Rectangle> &queries,
+                                const std::vector<double> &arrivals, size_t threads) {
+  size_t n = arrivals.size();
+  std::vector<double> started(n, -1), done(n, -1);
+  std::vector<bool> ok(n, true);
+  if (queries.empty()) return summarize_load_2d(arrivals, started, done, ok);
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<size_t> queue;
+  bool closed = false;
+  steady_clock::time_point start;
+  auto since = [&start]() { return duration<double, std::micro>(steady_clock::now() - start).count(); };
+
+  auto work = [&]() {
+    std::vector<uint8_t> bytes;
+    while (true) {
+      size_t i;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return closed || !queue.empty(); });
+        if (queue.empty()) return;
+        i = queue.front();
+        queue.pop_front();
+      }
+      started[i] = since();
+      VObject2D *vo = range_query_2d(root, queries[i % queries.size()]);
+      bytes.clear();
+      serialize_vo_2d(vo, bytes);
+      delete_vo_2d(vo);
+      done[i] = since();
+    }
+  };
+  std::vector<std::thread> pool;
+  for (size_t t = 0; t < threads; t++) pool.emplace_back(work);
+
+  // The dispatcher never waits for answers, only for the next arrival.
+  start = steady_clock::now();
+  for (size_t i = 0; i < n; i++) {
+    std::this_thread::sleep_until(start + duration_cast<steady_clock::duration>(duration<double, std::micro>(arrivals[i])));
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(i);
+    cv.notify_one();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+  }
+  cv.notify_all();
+  for (std::thread &th : pool) th.join();
+  return summarize_load_2d(arrivals, started, done, ok);
+}
+
+/**
+ *  Replays queries against a query server.
+ */
+bool run_server_load_2d(const std::string &address, const std::vector<Rectangle> &queries,
+                        const std::vector<double> &arrivals, LoadResult2D &result) {
+  size_t n = arrivals.size();
+  std::vector<double> sent(n, -1), done(n, -1);
+  std::vector<bool> ok(n, false);
+  if (queries.empty() || n > UINT32_MAX) {
+    std::cerr << "Error: No queries or too many arrivals" << std::endl;
+    return false;
+  }
+  ServerClient2D client;
+  if (!client.connect(address)) {
+    std::cerr << "Error: Cannot connect to " << address << std::endl;
+    return false;
+  }
+
+  steady_clock::time_point start = steady_clock::now();
+  auto since = [&start]() { return duration<double, std::micro>(steady_clock::now() - start).count(); };
+
+  // Replies are collected concurrently so that writes never wait for them.
+  std::thread receiver([&]() {
+    ServerReply2D reply;
+    for (size_t k = 0; k < n && client.receive(reply); k++) {
+      if (reply.id >= n || done[reply.id] >= 0) continue;
+      done[reply.id] = since();
+      ok[reply.id] = reply.status == SERVER2D_OK;
+    }
+  });
+
+  // Requests that fell due while a write was blocked go out together.
+  std::vector<ServerRequest2D> batch;
+  for (size_t i = 0; i < n;) {
+    std::this_thread::sleep_until(start + duration_cast<steady_clock::duration>(duration<double, std::micro>(arrivals[i])));
+    double now = since();
+    batch.clear();
+    size_t first = i;
+    for (; i < n && arrivals[i] <= now; i++) batch.push_back(range_request_2d(i, queries[i % queries.size()]));
+    if (batch.empty()) continue;
+    now = since();
+    for (size_t j = first; j < i; j++) sent[j] = now;
+    if (!client.send(batch)) {
+      std::cerr << "Error: Connection to " << address << " lost after " << first << " requests" << std::endl;
+      break;
+    }
+  }
+  receiver.join();
+  client.close();
+  result = summarize_load_2d(arrivals, sent, done, ok);
+  return true;
+}
+
+/**
+ *  Tells whether a run overloaded the node.
+ */
+bool load_saturated_2d(const LoadResult2D &result, const LoadResult2D &baseline) {
+  if (result.failed > 0) return true;
+  if (result.achieved_rate < LOADGEN2D_MIN_GOODPUT * result.offered_rate) return true;
+  return baseline.p99_us > 0 && result.p99_us > LOADGEN2D_MAX_P99_GROWTH * baseline.p99_us;
+}
@@ -0,0 +1,109 @@
+/**
+ *  @file LoadGen2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Open-loop load generation for range queries.
+ *
+ *  Requests are issued at fixed arrival times (Poisson or taken from a
+ *  trace) whether or not earlier ones have been answered, so a node that
+ *  cannot keep up builds a queue instead of slowing the generator down.
+ *  The latency of a request runs from its scheduled arrival to its answer
+ *  and therefore includes the time it spent queued, in the generator, the
+ *  socket or the server.
+ */
+
+#ifndef LOADGEN2D_H
+#define LOADGEN2D_H
+
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include <string>
+#include <vector>
+
+/**
+ *  Fraction of the offered rate below which a node counts as saturated.
+ */
+#define LOADGEN2D_MIN_GOODPUT 0.95
+
+/**
+ *  Growth of the 99th percentile latency over the lightest load above
+ *  which a node counts as saturated.
+ */
+#define LOADGEN2D_MAX_P99_GROWTH 10.0
+
+/**
+ *  Draws Poisson arrival times.
+ *  @param count the number of arrivals
+ *  @param rate the mean arrival rate in requests per second
+ *  @param seed the seed of the exponential gaps
+ *  @return arrival times in microseconds from the start
+ */
+std::vector<double> poisson_arrivals_2d(size_t count, double rate, uint32_t seed = 1);
+
+/**
+ *  Loads a trace of arrival times, one timestamp in seconds per line.
+ *  @param path the trace file
+ *  @return arrival times in microseconds from the first one, or an empty
+ *          vector if the file cannot be read or is not sorted
+ */
+std::vector<double> load_arrivals_2d(const std::string &path);
+
+/**
+ *  Stretches or compresses a trace to a given mean rate, keeping its bursts.
+ *  @param arrivals arrival times in microseconds from the start
+ *  @param rate the mean arrival rate in requests per second
+ */
+std::vector<double> scale_arrivals_2d(const std::vector<double> &arrivals, double rate);
+
+/**
+ *  Outcome of one load run.
+ */
+struct LoadResult2D {
+  double offered_rate;  ///< Requests per second of the arrival schedule
+  double achieved_rate; ///< Answers per second from the first arrival to the last answer
+  size_t completed;     ///< Requests answered
+  size_t failed;        ///< Requests not answered or answered with an error
+  double mean_us;       ///< Mean latency from scheduled arrival to answer
+  double p50_us;
+  double p90_us;
+  double p99_us;
+  double max_us;
+  double mean_queue_us; ///< Mean delay before work on a request started (engine)
+                        ///< or before it was written to the socket (server)
+};
+
+/**
+ *  Replays queries against the in-process engine: a dispatcher thread
+ *  queues each query at its arrival time and worker threads answer them
+ *  with range_query_2d and serialize_vo_2d, as the query server does.
+ *  @param root the root of the 2D MR-tree
+ *  @param queries the query rectangles, reused in turn if there are fewer than arrivals
+ *  @param arrivals arrival times in microseconds from the start
+ *  @param threads the number of worker threads (0 = one per hardware thread)
+ *  @return the latencies and throughput of the run
+ */
+LoadResult2D run_engine_load_2d(Node2D *root, const std::vector<Rectangle> &queries,
+                                const std::vector<double> &arrivals, size_t threads = 0);
+
+/**
+ *  Replays queries against a query server as RANGE requests on one
+ *  pipelined connection: requests are written at their arrival times while
+ *  a receiver thread collects the replies.
+ *  @param address the server address (see Server2D.hpp)
+ *  @param queries the query rectangles, reused in turn if there are fewer than arrivals
+ *  @param arrivals arrival times in microseconds from the start
+ *  @param result receives the latencies and throughput of the run
+ *  @return false if the server cannot be reached
+ */
+bool run_server_load_2d(const std::string &address, const std::vector<Rectangle> &queries,
+                        const std::vector<double> &arrivals, LoadResult2D &result);
+
+/**
+ *  Tells whether a run overloaded the node: it answered less than
+ *  LOADGEN2D_MIN_GOODPUT of the offered rate, or its 99th percentile
+ *  latency grew more than LOADGEN2D_MAX_P99_GROWTH times over a baseline
+ *  run at light load.
+ */
+bool load_saturated_2d(const LoadResult2D &result, const LoadResult2D &baseline);
+
+#endif
@@ -0,0 +1,382 @@
+/**
+ *  @file MBTree2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "MBTree2D.hpp"
+#include "libmorton/morton.h"
+#include <algorithm>
+#include <numeric>
+
+/**
+ *  Number of bytes hashed for an entry (id, x, y).
+ */
+#define MB_ENTRY_SIZE (sizeof(uint32_t) + 2 * sizeof(int32_t))
+
+/**
+ *  Computes the key of a point.
+ */
+uint64_t mb_key_2d(const Point2D &p, MBTreeKey key) {
+  if (key == MBT_KEY_ID) return p.id;
+  return libmorton::morton2D_64_encode(static_cast<uint32_t>(p.loc.x),
+                                       static_cast<uint32_t>(p.loc.y));
+}
+
+/**
+ *  Computes the digest of a leaf made of entries [begin, end).
+ */
+static hash_t mb_leaf_hash(const Point2D *entries, const hash_t *digests, size_t n) {
+  Buffer buf(n * (MB_ENTRY_SIZE + (digests ? SHA256_DIGEST_LENGTH : 0)));
+  for (size_t i = 0; i < n; i++) {
+    if (digests) put_point2d(buf, entries[i], digests[i]);
+    else put_point2d(buf, entries[i]);
+  }
+  return sha256(buf);
+}
+
+/**
+ *  Computes the digest of an internal node from the digests of its children.
+ */
+static hash_t mb_node_hash(const hash_t *children, size_t n) {
+  Buffer buf(n * SHA256_DIGEST_LENGTH);
+  for (size_t i = 0; i < n; i++) {
+    buf.put_bytes(const_cast<uint8_t*>(children[i].data()), children[i].size());
+  }
+  return sha256(buf);
+}
+
+/**
+ *  Computes the digests of the parent level of a level.
+ */
+static std::vector<hash_t> mb_parent_level(const std::vector<hash_t> &level, size_t fanout) {
+  std::vector<hash_t> parents;
+  parents.reserve((level.size() + fanout - 1) / fanout);
+  for (size_t i = 0; i < level.size(); i += fanout) {
+    parents.push_back(mb_node_hash(&level[i], std::min(fanout, level.size() - i)));
+  }
+  return parents;
+}
+
+/**
+ *  Computes the root commitment of a Merkle B+-tree.
+ */
+hash_t mb_commit_2d(uint64_t count, uint32_t fanout, MBTreeKey key,
+                    bool payload, const hash_t &top) {
+  Buffer buf(sizeof(uint64_t) + sizeof(uint32_t) + 2 + SHA256_DIGEST_LENGTH);
+  buf.put(count).put(fanout).put(static_cast<uint8_t>(key))
+     .put(static_cast<uint8_t>(payload))
+     .put_bytes(const_cast<uint8_t*>(top.data()), top.size());
+  return sha256(buf);
+}
+
+/**
+ *  Builds a Merkle B+-tree.
+ */
+MBTree2D::MBTree2D(MBTreeKey key, size_t fanout, const std::vector<Point2D> &points,
+                   const AttributeStore *attrs)
+: key_type(key), fanout(std::max<size_t>(fanout, 2)) {
+  // Sort on (key, input position), so that equal keys keep the input order.
+  std::vector<std::pair<uint64_t, size_t>> order(points.size());
+  for (size_t i = 0; i < points.size(); i++) order[i] = {mb_key_2d(points[i], key), i};
+  std::sort(order.begin(), order.end());
+
+  keys.reserve(points.size());
+  entries.reserve(points.size());
+  for (const auto &o : order) {
+    keys.push_back(o.first);
+    entries.push_back(points[o.second]);
+    if (attrs) digests.push_back(attrs->getDigest(points[o.second].id));
+  }
+
+  if (!entries.empty()) {
+    std::vector<hash_t> leaves;
+    for (size_t i = 0; i < entries.size(); i += this->fanout) {
+      size_t n = std::min(this->fanout, entries.size() - i);
+      leaves.push_back(mb_leaf_hash(&entries[i], attrs ? &digests[i] : nullptr, n));
+    }
+    levels.push_back(std::move(leaves));
+    while (levels.back().size() > 1) {
+      levels.push_back(mb_parent_level(levels.back(), this->fanout));
+    }
+  }
+
+  hash_t top = levels.empty() ? hash_t{} : levels.back()[0];
+  root = mb_commit_2d(entries.size(), this->fanout, key_type, attrs != nullptr, top);
+}
+
+/**
+ *  Returns the position of the first entry whose key is not less than k.
+ */
+size_t MBTree2D::lowerBound(uint64_t k) const {
+  if (hasModel()) return model.lower_bound(keys, k);
+  return std::lower_bound(keys.begin(), keys.end(), k) - keys.begin();
+}
+
+/**
+ *  Returns the position of the first entry whose key is greater than k.
+ */
+size_t MBTree2D::upperBound(uint64_t k) const {
+  if (hasModel()) return model.upper_bound(keys, k);
+  return std::upper_bound(keys.begin(), keys.end(), k) - keys.begin();
+}
+
+/**
+ *  Merges sorted index intervals that overlap or touch.
+ */
+static std::vector<MBRun2D> mb_merge_runs(const std::vector<MBRun2D> &runs) {
+  std::vector<MBRun2D> merged;
+  for (const MBRun2D &r : runs) {
+    if (!merged.empty() &&
+        r.first_leaf <= merged.back().first_leaf + merged.back().n_leaves) {
+      uint64_t end = std::max(merged.back().first_leaf + merged.back().n_leaves,
+                              r.first_leaf + r.n_leaves);
+      merged.back().n_leaves = end - merged.back().first_leaf;
+    } else {
+      merged.push_back(r);
+    }
+  }
+  return merged;
+}
+
+/**
+ *  Returns the runs of parent nodes of a list of runs of nodes.
+ */
+static std::vector<MBRun2D> mb_parent_runs(const std::vector<MBRun2D> &runs, uint64_t fanout) {
+  std::vector<MBRun2D> parents;
+  for (const MBRun2D &r : runs) {
+    uint64_t first = r.first_leaf / fanout;
+    uint64_t last = (r.first_leaf + r.n_leaves - 1) / fanout;
+    parents.push_back({first, last - first + 1});
+  }
+  return mb_merge_runs(parents);
+}
+
+/**
+ *  Returns true if a node index belongs to one of the runs.
+ */
+static bool mb_in_runs(const std::vector<MBRun2D> &runs, uint64_t idx) {
+  auto it = std::upper_bound(runs.begin(), runs.end(), idx,
+    [](uint64_t i, const MBRun2D &r) { return i < r.first_leaf; });
+  if (it == runs.begin()) return false;
+  --it;
+  return idx < it->first_leaf + it->n_leaves;
+}
+
+/**
+ *  Builds the proof for all entries whose key lies in one of several ranges.
+ *  For each range, the shipped leaves start one entry before the range and
+ *  end one entry after it, so that the verifier can check that nothing is missing.
+ */
+MBProof2D mb_ranges_query_2d(const MBTree2D &tree, const std::vector<KeyRange> &ranges,
+                             QueryStats2D *stats) {
+  MBProof2D proof;
+  proof.key_type = tree.getKeyType();
+  proof.fanout = tree.getFanout();
+  proof.payload = tree.hasPayload();
+  proof.count = tree.size();
+  if (tree.size() == 0 || ranges.empty()) return proof;
+
+  const std::vector<uint64_t> &keys = tree.getKeys();
+  uint64_t fanout = tree.getFanout();
+
+  // Leaves covering each range, merged into disjoint runs.
+  std::vector<MBRun2D> runs;
+  for (const KeyRange &r : ranges) {
+    size_t a = tree.lowerBound(r.lo);
+    size_t b = tree.upperBound(r.hi);
+    if (a > 0) a--;
+    if (b >= keys.size()) b = keys.size() - 1;
+    if (b < a) b = a;
+    runs.push_back({a / fanout, b / fanout - a / fanout + 1});
+  }
+  std::sort(runs.begin(), runs.end(),
+    [](const MBRun2D &x, const MBRun2D &y) { return x.first_leaf < y.first_leaf; });
+  proof.runs = mb_merge_runs(runs);
+
+  for (const MBRun2D &r : proof.runs) {
+    size_t begin = r.first_leaf * fanout;
+    size_t end = std::min<size_t>(keys.size(), (r.first_leaf + r.n_leaves) * fanout);
+    proof.entries.insert(proof.entries.end(), tree.getEntries().begin() + begin,
+                         tree.getEntries().begin() + end);
+    if (tree.hasPayload()) {
+      proof.digests.insert(proof.digests.end(), tree.getDigests().begin() + begin,
+                           tree.getDigests().begin() + end);
+    }
+  }
+
+  // Collect the digests of the nodes missing from the touched groups, level by level.
+  const std::vector<std::vector<hash_t>> &levels = tree.getLevels();
+  std::vector<MBRun2D> known = proof.runs;
+  size_t nodes = 0;
+  for (size_t l = 0; l + 1 < levels.size(); l++) {
+    const std::vector<hash_t> &level = levels[l];
+    std::vector<MBRun2D> groups = mb_parent_runs(known, fanout);
+    for (const MBRun2D &g : groups) {
+      uint64_t begin = g.first_leaf * fanout;
+      uint64_t end = std::min<uint64_t>(level.size(), (g.first_leaf + g.n_leaves) * fanout);
+      for (uint64_t i = begin; i < end; i++) {
+        if (!mb_in_runs(known, i)) proof.siblings.push_back(level[i]);
+      }
+      nodes += g.n_leaves;
+    }
+    known = std::move(groups);
+  }
+
+  if (stats) {
+    for (const MBRun2D &r : proof.runs) nodes += r.n_leaves;
+    stats->nodes_visited += nodes;
+    stats->points_examined += proof.entries.size();
+  }
+  return proof;
+}
+
+/**
+ *  Builds the proof for all entries whose key lies in [lo, hi].
+ */
+MBProof2D mb_range_query_2d(const MBTree2D &tree, uint64_t lo, uint64_t hi,
+                            QueryStats2D *stats) {
+  return mb_ranges_query_2d(tree, std::vector<KeyRange>{{lo, hi}}, stats);
+}
+
+/**
+ *  Verifies a proof for several key ranges.
+ */
+MBResult2D verify_mb_ranges_2d(const MBProof2D &proof, const std::vector<KeyRange> &ranges,
+                               QueryStats2D *stats) {
+  MBResult2D res;
+  res.valid = false;
+  res.hash = hash_t{};
+
+  bool payload = proof.payload;
+  if (payload && proof.digests.size() != proof.entries.size()) return res;
+  if (!payload && !proof.digests.empty()) return res;
+
+  if (proof.count == 0 || ranges.empty()) {
+    // Nothing to prove beyond the root: the proof must be the top digest alone.
+    if (proof.count == 0) {
+      res.valid = proof.runs.empty() && proof.entries.empty() && proof.siblings.empty();
+      res.hash = mb_commit_2d(0, proof.fanout, proof.key_type, payload, hash_t{});
+    }
+    return res;
+  }
+
+  // Proofs come from the server: n_leaves is computed without n + fanout - 1,
+  // and run bounds are checked without first_leaf + n_leaves, so neither wraps.
+  uint64_t fanout = proof.fanout;
+  uint64_t n = proof.count;
+  if (fanout < 2 || proof.runs.empty()) return res;
+  uint64_t n_leaves = n / fanout + (n % fanout != 0);
+
+  // Rebuild the shipped leaves; runs must be sorted, disjoint and made of whole leaves.
+  std::vector<hash_t> cur;
+  std::vector<std::pair<size_t, size_t>> run_entries; // [begin, end) in proof.entries
+  size_t consumed = 0;
+  uint64_t next_free = 0;
+  for (const MBRun2D &r : proof.runs) {
+    if (r.n_leaves == 0 || r.first_leaf < next_free || r.first_leaf >= n_leaves ||
+        r.n_leaves > n_leaves - r.first_leaf) return res;
+    next_free = r.first_leaf + r.n_leaves + 1;
+    size_t run_begin = consumed;
+    for (uint64_t leaf = r.first_leaf; leaf < r.first_leaf + r.n_leaves; leaf++) {
+      size_t leaf_size = std::min<uint64_t>(fanout, n - leaf * fanout);
+      if (consumed + leaf_size > proof.entries.size()) return res;
+      cur.push_back(mb_leaf_hash(&proof.entries[consumed],
+                                 payload ? &proof.digests[consumed] : nullptr, leaf_size));
+      consumed += leaf_size;
+    }
+    run_entries.push_back({run_begin, consumed});
+  }
+  if (consumed != proof.entries.size()) return res;
+
+  // Entries must be sorted on their key.
+  std::vector<uint64_t> keys(proof.entries.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys[i] = mb_key_2d(proof.entries[i], proof.key_type);
+    if (i > 0 && keys[i] < keys[i - 1]) return res;
+  }
+
+  // Each range must be enclosed by a run that reaches past both of its ends.
+  for (const KeyRange &range : ranges) {
+    bool covered = false;
+    for (size_t r = 0; r < proof.runs.size() && !covered; r++) {
+      uint64_t first_pos = proof.runs[r].first_leaf * fanout;
+      uint64_t last_pos = first_pos + (run_entries[r].second - run_entries[r].first) - 1;
+      bool left = (first_pos == 0) || keys[run_entries[r].first] < range.lo;
+      bool right = (last_pos == n - 1) || keys[run_entries[r].second - 1] > range.hi;
+      covered = left && right;
+    }
+    if (!covered) return res;
+  }
+
+  // Collect the entries falling in some range.
+  for (size_t i = 0; i < keys.size(); i++) {
+    auto it = std::upper_bound(ranges.begin(), ranges.end(), keys[i],
+      [](uint64_t k, const KeyRange &r) { return k < r.lo; });
+    if (it != ranges.begin() && keys[i] <= (--it)->hi) {
+      res.points.push_back(proof.entries[i]);
+      if (payload) res.digests.push_back(proof.digests[i]);
+      if (stats) stats->points_returned++;
+    }
+  }
+
+  // Climb to the top, filling the touched groups with the shipped siblings.
+  std::vector<MBRun2D> known = proof.runs;
+  uint64_t level_size = n_leaves;
+  size_t s = 0;
+  while (level_size > 1) {
+    std::vector<MBRun2D> groups = mb_parent_runs(known, fanout);
+    std::vector<hash_t> parents;
+    size_t k = 0;
+    for (const MBRun2D &g : groups) {
+      for (uint64_t p = g.first_leaf; p < g.first_leaf + g.n_leaves; p++) {
+        uint64_t begin = p * fanout, end = std::min(level_size, (p + 1) * fanout);
+        std::vector<hash_t> children;
+        for (uint64_t i = begin; i < end; i++) {
+          if (mb_in_runs(known, i)) {
+            if (k >= cur.size()) return res;
+            children.push_back(cur[k++]);
+          } else {
+            if (s >= proof.siblings.size()) return res;
+            children.push_back(proof.siblings[s++]);
+          }
+        }
+        parents.push_back(mb_node_hash(children.data(), children.size()));
+      }
+    }
+    if (k != cur.size()) return res;
+    cur = std::move(parents);
+    known = std::move(groups);
+    level_size = (level_size + fanout - 1) / fanout;
+  }
+  if (s != proof.siblings.size() || cur.size() != 1) return res;
+
+  res.hash = mb_commit_2d(n, proof.fanout, proof.key_type, payload, cur[0]);
+  res.valid = true;
+  return res;
+}
+
+/**
+ *  Verifies a proof for the key range [lo, hi].
+ */
+MBResult2D verify_mb_range_2d(const MBProof2D &proof, uint64_t lo, uint64_t hi,
+                              QueryStats2D *stats) {
+  return verify_mb_ranges_2d(proof, std::vector<KeyRange>{{lo, hi}}, stats);
+}
+
+/**
+ *  Builds the proof for a lookup by point ID.
+ */
+MBProof2D mb_lookup_2d(const MBTree2D &tree, uint32_t id) {
+  return mb_range_query_2d(tree, id, id);
+}
+
+/**
+ *  Returns the size in bytes of the wire encoding of a proof.
+ */
+size_t mb_proof_size_2d(const MBProof2D &proof) {
+  size_t header = sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t) +
+                  sizeof(uint64_t) + 4 * sizeof(uint32_t);
+  return header + proof.runs.size() * 2 * sizeof(uint64_t) +
+         proof.entries.size() * MB_ENTRY_SIZE +
+         (proof.digests.size() + proof.siblings.size()) * SHA256_DIGEST_LENGTH;
+}
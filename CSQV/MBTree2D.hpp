@@ -0,0 +1,222 @@
+/**
+ *  @file MBTree2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Merkle B+-tree over 2D points sorted on a 64-bit key.
+ *
+ *  Points are sorted on their key (point ID or Morton code) and packed into
+ *  leaves of `fanout` entries; internal levels group `fanout` digests each.
+ *  The root commitment also binds the number of entries, the fanout and the
+ *  key type, so positions are authenticated: a proof ships one or more runs
+ *  of whole leaves plus the sibling digests needed to rebuild the root, and
+ *  the verifier checks that, for each key range, some run reaches past both
+ *  ends of the range (or the ends of the tree). This gives verified key
+ *  lookups, key-range scans, multi-interval scans and proofs of absence.
+ */
+
+#ifndef MBTREE2D_H
+#define MBTREE2D_H
+
+#include "Attributes2D.hpp"
+#include "Hash.hpp"
+#include "LearnedIndex2D.hpp"
+#include "Point2D.hpp"
+#include "Query2D.hpp"
+#include <vector>
+
+/**
+ *  The key on which entries of a Merkle B+-tree are sorted.
+ */
+enum MBTreeKey {MBT_KEY_ID, MBT_KEY_Z};
+
+/**
+ *  A closed range of keys [lo, hi].
+ */
+struct KeyRange {
+  uint64_t lo; ///< The lower bound
+  uint64_t hi; ///< The upper bound
+};
+
+/**
+ *  Computes the key of a point.
+ *  @param p the point
+ *  @param key the key type
+ *  @return the point ID or the 2D Morton code of its location
+ */
+uint64_t mb_key_2d(const Point2D &p, MBTreeKey key);
+
+/**
+ *  A Merkle B+-tree over 2D points.
+ */
+class MBTree2D {
+private:
+  MBTreeKey key_type;                      ///< Key the entries are sorted on
+  size_t fanout;                           ///< Entries per leaf and children per node
+  std::vector<uint64_t> keys;              ///< Sorted keys, one per entry
+  std::vector<Point2D> entries;            ///< Entries sorted on their key
+  std::vector<hash_t> digests;             ///< Payload digests of the entries (empty if none)
+  std::vector<std::vector<hash_t>> levels; ///< Node digests, from the leaves to the top node
+  hash_t root;                             ///< Root commitment
+  LearnedIndex2D model;                    ///< Optional learned model over the keys
+
+public:
+  /**
+   *  Builds a Merkle B+-tree.
+   *  @param key the key to sort entries on
+   *  @param fanout entries per leaf and children per internal node (at least 2)
+   *  @param points the points to index
+   *  @param attrs optional attribute store whose payloads the entries commit to
+   */
+  MBTree2D(MBTreeKey key, size_t fanout, const std::vector<Point2D> &points,
+           const AttributeStore *attrs = nullptr);
+
+  MBTreeKey getKeyType() const { return key_type; }
+  size_t getFanout() const { return fanout; }
+  size_t size() const { return entries.size(); }
+  bool hasPayload() const { return !digests.empty(); }
+  const std::vector<uint64_t> &getKeys() const { return keys; }
+  const std::vector<Point2D> &getEntries() const { return entries; }
+  const std::vector<hash_t> &getDigests() const { return digests; }
+  const std::vector<std::vector<hash_t>> &getLevels() const { return levels; }
+
+  /**
+   *  Returns the root commitment of the tree.
+   */
+  hash_t getHash() const { return root; }
+
+  /**
+   *  Returns the number of levels (leaves included).
+   */
+  size_t height() const { return levels.size(); }
+
+  /**
+   *  Builds a learned model over the keys, used from then on to locate
+   *  the leaves of lookups and range scans instead of a binary search.
+   *  @param epsilon the maximum error of the model, in entries
+   */
+  void buildModel(size_t epsilon = DEFAULT_LEARNED_EPSILON) { model = LearnedIndex2D(keys, epsilon); }
+
+  /**
+   *  Drops the learned model.
+   */
+  void dropModel() { model = LearnedIndex2D(); }
+
+  bool hasModel() const { return !model.empty(); }
+  const LearnedIndex2D &getModel() const { return model; }
+
+  /**
+   *  Returns the position of the first entry whose key is not less than k.
+   */
+  size_t lowerBound(uint64_t k) const;
+
+  /**
+   *  Returns the position of the first entry whose key is greater than k.
+   */
+  size_t upperBound(uint64_t k) const;
+};
+
+/**
+ *  A run of consecutive leaves shipped in a proof.
+ */
+struct MBRun2D {
+  uint64_t first_leaf;  ///< Index of the first leaf of the run
+  uint64_t n_leaves;    ///< Number of leaves of the run
+};
+
+/**
+ *  Proof for one or more key ranges of a Merkle B+-tree.
+ */
+struct MBProof2D {
+  MBTreeKey key_type;            ///< Key type of the tree
+  uint32_t fanout;               ///< Fanout of the tree
+  bool payload;                  ///< True if entries commit to payload digests
+  uint64_t count;                ///< Total number of entries of the tree
+  std::vector<MBRun2D> runs;     ///< Runs of leaves shipped, sorted and disjoint
+  std::vector<Point2D> entries;  ///< All entries of the leaves shipped, run by run
+  std::vector<hash_t> digests;   ///< Payload digests of the entries shipped
+  std::vector<hash_t> siblings;  ///< Missing node digests, level by level, left to right
+};
+
+/**
+ *  Result of the verification of a Merkle B+-tree proof.
+ */
+struct MBResult2D {
+  bool valid;                    ///< False if the proof is malformed or incomplete
+  hash_t hash;                   ///< Reconstructed root commitment
+  std::vector<Point2D> points;   ///< Entries whose key is inside a range, in key order
+  std::vector<hash_t> digests;   ///< Payload digests of those entries (if any)
+};
+
+/**
+ *  Computes the root commitment of a Merkle B+-tree.
+ *  @param count number of entries
+ *  @param fanout fanout of the tree
+ *  @param key key type
+ *  @param payload true if entries commit to payload digests
+ *  @param top digest of the top node (zero for an empty tree)
+ *  @return the root commitment
+ */
+hash_t mb_commit_2d(uint64_t count, uint32_t fanout, MBTreeKey key,
+                    bool payload, const hash_t &top);
+
+/**
+ *  Builds the proof for all entries whose key lies in [lo, hi].
+ *  @param tree the Merkle B+-tree
+ *  @param lo the lower bound of the key range
+ *  @param hi the upper bound of the key range
+ *  @param stats optional statistics collector
+ *  @return the proof
+ */
+MBProof2D mb_range_query_2d(const MBTree2D &tree, uint64_t lo, uint64_t hi,
+                            QueryStats2D *stats = nullptr);
+
+/**
+ *  Builds the proof for all entries whose key lies in one of several ranges.
+ *  @param tree the Merkle B+-tree
+ *  @param ranges the key ranges, sorted and disjoint
+ *  @param stats optional statistics collector
+ *  @return the proof
+ */
+MBProof2D mb_ranges_query_2d(const MBTree2D &tree, const std::vector<KeyRange> &ranges,
+                             QueryStats2D *stats = nullptr);
+
+/**
+ *  Verifies a proof for several key ranges.
+ *  The caller must compare the reconstructed root with a trusted one.
+ *  @param proof the proof
+ *  @param ranges the key ranges, sorted and disjoint
+ *  @param stats optional statistics collector
+ *  @return the verification result
+ */
+MBResult2D verify_mb_ranges_2d(const MBProof2D &proof, const std::vector<KeyRange> &ranges,
+                               QueryStats2D *stats = nullptr);
+
+/**
+ *  Verifies a proof for the key range [lo, hi].
+ *  The caller must compare the reconstructed root with a trusted one.
+ *  @param proof the proof
+ *  @param lo the lower bound of the key range
+ *  @param hi the upper bound of the key range
+ *  @param stats optional statistics collector
+ *  @return the verification result
+ */
+MBResult2D verify_mb_range_2d(const MBProof2D &proof, uint64_t lo, uint64_t hi,
+                              QueryStats2D *stats = nullptr);
+
+/**
+ *  Builds the proof for a lookup by point ID in an ID-keyed tree.
+ *  If the point does not exist, the proof shows its neighbours.
+ *  @param tree a Merkle B+-tree keyed on MBT_KEY_ID
+ *  @param id the point ID
+ *  @return the proof
+ */
+MBProof2D mb_lookup_2d(const MBTree2D &tree, uint32_t id);
+
+/**
+ *  Returns the size in bytes of the wire encoding of a proof.
+ *  @param proof the proof
+ *  @return the size in bytes
+ */
+size_t mb_proof_size_2d(const MBProof2D &proof);
+
+#endif
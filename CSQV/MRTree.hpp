@@ -0,0 +1,654 @@
+/**
+ *  @file MRTree.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Compile-time specialized Merkle R-tree.
+ *
+ *  Dimensionality, coordinate type, leaf capacity, fanout, space-filling
+ *  curve and hash function are template parameters. Nodes store their
+ *  entries in fixed-size inline arrays and all hash buffers have constexpr
+ *  sizes, so predicate loops are fully unrolled and digests are computed
+ *  from stack buffers. The 2D instantiation (MRTree2D) produces the same
+ *  digests as the tree built by build_2d_tree.
+ *
+ *  The template is a separate implementation: build_2d_tree, range_query_2d,
+ *  verify_2d and every module built on Node2D / VObject2D keep the
+ *  runtime-capacity code path and do not benefit from the specialization.
+ *  Both prune with the same closed overlap test, so they return the same
+ *  points for every query, including points on the query border.
+ */
+
+#ifndef MRTREE_H
+#define MRTREE_H
+
+#include "Config.hpp"
+#include "Geometry.hpp"
+#include "Hash.hpp"
+#include "Point2D.hpp"
+#include "Query2D.hpp"
+#include "libmorton/morton.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ *  A point with an identifier and Dim coordinates.
+ */
+template<size_t Dim, typename Coord>
+struct MRPoint {
+  uint32_t id;                ///< Unique identifier for the point
+  std::array<Coord, Dim> c;   ///< Coordinates of the point
+};
+
+/**
+ *  An axis-aligned box given by its lower and upper corners.
+ *  All predicates treat the box as closed.
+ */
+template<size_t Dim, typename Coord>
+struct MRBox {
+  std::array<Coord, Dim> lo;  ///< The lower corner
+  std::array<Coord, Dim> hi;  ///< The upper corner
+
+  /**
+   *  Returns the empty box with corners (+inf, ..., -inf, ...).
+   */
+  static MRBox empty() {
+    MRBox b;
+    b.lo.fill(std::numeric_limits<Coord>::max());
+    b.hi.fill(std::numeric_limits<Coord>::lowest());
+    return b;
+  }
+
+  /**
+   *  Returns true if and only if the point lies inside the box.
+   *  The loop uses non-short-circuit operators so that it can be vectorized.
+   */
+  bool contains(const MRPoint<Dim, Coord> &p) const {
+    bool in = true;
+    for (size_t d = 0; d < Dim; d++) in &= (lo[d] <= p.c[d]) & (p.c[d] <= hi[d]);
+    return in;
+  }
+
+  /**
+   *  Returns true if and only if the two boxes share at least one point.
+   */
+  bool intersects(const MRBox &b) const {
+    bool in = true;
+    for (size_t d = 0; d < Dim; d++) in &= (lo[d] <= b.hi[d]) & (b.lo[d] <= hi[d]);
+    return in;
+  }
+
+  /**
+   *  Returns true if and only if the box fully contains the other box.
+   */
+  bool covers(const MRBox &b) const {
+    bool in = true;
+    for (size_t d = 0; d < Dim; d++) in &= (lo[d] <= b.lo[d]) & (b.hi[d] <= hi[d]);
+    return in;
+  }
+
+  /**
+   *  Enlarges the box so that it encloses the given point.
+   */
+  void enlarge(const MRPoint<Dim, Coord> &p) {
+    for (size_t d = 0; d < Dim; d++) {
+      lo[d] = std::min(lo[d], p.c[d]);
+      hi[d] = std::max(hi[d], p.c[d]);
+    }
+  }
+
+  /**
+   *  Enlarges the box so that it encloses the given box.
+   */
+  void enlarge(const MRBox &b) {
+    for (size_t d = 0; d < Dim; d++) {
+      lo[d] = std::min(lo[d], b.lo[d]);
+      hi[d] = std::max(hi[d], b.hi[d]);
+    }
+  }
+};
+
+/**
+ *  Hash policy based on SHA-256.
+ */
+struct Sha256Hash {
+  typedef hash_t digest_t;                  ///< Type of a digest
+  static constexpr size_t DIGEST_SIZE = 32; ///< Size of a digest in bytes
+
+  /**
+   *  Computes the digest of an array of raw bytes.
+   */
+  static digest_t digest(const uint8_t *buf, size_t size) {
+    return sha256(buf, size);
+  }
+};
+
+/**
+ *  Morton (Z-order) curve policy. Only the specializations below exist.
+ *  A curve maps the coordinates of a point to a 64-bit sort key;
+ *  the domain (MBR of the whole dataset) may be used for normalization.
+ */
+template<size_t Dim>
+struct MortonCurve;
+
+/**
+ *  2D Morton curve. Coordinates are reinterpreted as unsigned 32-bit
+ *  integers, exactly as morton2D_encode does, so that the resulting
+ *  order is the one used by build_2d_tree.
+ */
+template<>
+struct MortonCurve<2> {
+  template<typename Coord>
+  static uint64_t key(const std::array<Coord, 2> &c, const MRBox<2, Coord> &) {
+    return libmorton::morton2D_64_encode(static_cast<uint32_t>(c[0]),
+                                         static_cast<uint32_t>(c[1]));
+  }
+};
+
+/**
+ *  3D Morton curve. A 64-bit Morton key holds 21 bits per dimension,
+ *  so each coordinate is first rescaled from the domain to [0, 2^21).
+ *  Rescaling keeps dimensions with very different ranges (e.g. space
+ *  and time) equally represented in the key.
+ */
+template<>
+struct MortonCurve<3> {
+  static constexpr uint64_t MAX_CELL = (uint64_t(1) << 21) - 1;
+
+  template<typename Coord>
+  static uint32_t scale(Coord v, Coord lo, Coord hi) {
+    static_assert(sizeof(Coord) <= sizeof(uint32_t), "coordinates wider than 32 bits");
+    uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(hi) - lo);
+    if (span == 0) return 0;
+    uint64_t off = static_cast<uint64_t>(static_cast<int64_t>(v) - lo);
+    return static_cast<uint32_t>(off * MAX_CELL / span);
+  }
+
+  template<typename Coord>
+  static uint64_t key(const std::array<Coord, 3> &c, const MRBox<3, Coord> &domain) {
+    return libmorton::morton3D_64_encode(scale(c[0], domain.lo[0], domain.hi[0]),
+                                         scale(c[1], domain.lo[1], domain.hi[1]),
+                                         scale(c[2], domain.lo[2], domain.hi[2]));
+  }
+};
+
+/**
+ *  Lexicographic curve policy. Coordinates are packed from the first
+ *  to the last dimension, with the sign bit flipped for signed types.
+ */
+struct LexCurve {
+  template<size_t Dim, typename Coord>
+  static uint64_t key(const std::array<Coord, Dim> &c, const MRBox<Dim, Coord> &) {
+    static_assert(Dim * sizeof(Coord) <= sizeof(uint64_t),
+                  "lexicographic key does not fit in 64 bits");
+    typedef typename std::make_unsigned<Coord>::type ucoord_t;
+    constexpr unsigned BITS = 8 * sizeof(Coord);
+    constexpr uint64_t BIAS = std::is_signed<Coord>::value ? (uint64_t(1) << (BITS - 1)) : 0;
+    uint64_t k = 0;
+    for (size_t d = 0; d < Dim; d++) {
+      uint64_t v = static_cast<uint64_t>(static_cast<ucoord_t>(c[d])) ^ BIAS;
+      k = (BITS < 64) ? ((k << (BITS % 64)) | v) : v;
+    }
+    return k;
+  }
+};
+
+/**
+ *  Compile-time specialized Merkle R-tree.
+ *
+ *  Leaves and internal nodes live in two contiguous arrays and refer to
+ *  each other by index. A leaf digest is the hash of (id, c[0], ..., c[Dim-1])
+ *  for all its points; an internal node digest is the hash of
+ *  (lo[0..Dim), hi[0..Dim), digest) for all its children.
+ *
+ *  @tparam Dim number of dimensions
+ *  @tparam Coord coordinate type
+ *  @tparam LeafCap maximum number of points per leaf
+ *  @tparam Fanout maximum number of children per internal node
+ *  @tparam Curve curve policy used to sort points before bulk-loading
+ *  @tparam Hash hash policy
+ */
+template<size_t Dim, typename Coord, size_t LeafCap, size_t Fanout,
+         typename Curve, typename Hash>
+class MRTree {
+  static_assert(Dim > 0, "at least one dimension is required");
+  static_assert(LeafCap > 0 && Fanout > 1, "invalid node capacity");
+
+public:
+  typedef MRPoint<Dim, Coord> point_t;      ///< Point type
+  typedef MRBox<Dim, Coord> box_t;          ///< Box type
+  typedef typename Hash::digest_t digest_t; ///< Digest type
+
+  /// Number of bytes hashed for each point.
+  static constexpr size_t POINT_BYTES = sizeof(uint32_t) + Dim * sizeof(Coord);
+  /// Number of bytes hashed for each child entry.
+  static constexpr size_t ENTRY_BYTES = 2 * Dim * sizeof(Coord) + Hash::DIGEST_SIZE;
+  /// Size of the buffer needed to hash a full leaf.
+  static constexpr size_t LEAF_BUF_SIZE = LeafCap * POINT_BYTES;
+  /// Size of the buffer needed to hash a full internal node.
+  static constexpr size_t INNER_BUF_SIZE = Fanout * ENTRY_BYTES;
+
+  /**
+   *  Returns the number of levels needed to index 2^32 leaves, the most
+   *  that 32-bit node indices allow.
+   */
+  static constexpr uint32_t max_height() {
+    uint32_t h = 1;
+    for (uint64_t reach = 1; reach < (uint64_t(1) << 32); reach *= Fanout) h++;
+    return h;
+  }
+
+  /// Maximum number of levels of a tree, and of a valid VO.
+  static constexpr uint32_t MAX_HEIGHT = max_height();
+
+  /**
+   *  Leaf node with inline point storage.
+   */
+  struct Leaf {
+    box_t box;                              ///< MBR of the points
+    digest_t hash;                          ///< Digest of the leaf
+    uint32_t size;                          ///< Number of points
+    std::array<point_t, LeafCap> points;    ///< Point storage
+  };
+
+  /**
+   *  Internal node with inline child storage. Children of a node at
+   *  level 1 are leaves, children of higher nodes are internal nodes.
+   */
+  struct Inner {
+    box_t box;                              ///< MBR of the children
+    digest_t hash;                          ///< Digest of the node
+    uint32_t size;                          ///< Number of children
+    uint32_t level;                         ///< Level of the node (leaves are 0)
+    std::array<uint32_t, Fanout> children;  ///< Child indices
+  };
+
+  /**
+   *  Kinds of entries in a verification object.
+   */
+  enum VOKind : uint8_t {VO_LEAF, VO_PRUNED, VO_OPEN};
+
+  /**
+   *  A verification object entry. Leaves carry their points in the
+   *  point pool of the VO, pruned entries carry box and digest,
+   *  open entries are followed by their children.
+   */
+  struct VOEntry {
+    VOKind kind;    ///< Kind of the entry
+    uint32_t size;  ///< Number of points (leaf) or children (open)
+    box_t box;      ///< MBR (pruned only)
+    digest_t hash;  ///< Digest (pruned only)
+  };
+
+  /**
+   *  A verification object stored as a flat pre-order sequence of entries.
+   */
+  struct VO {
+    std::vector<VOEntry> entries;   ///< Entries in pre-order
+    std::vector<point_t> points;    ///< Points of all leaf entries, in order
+  };
+
+  /**
+   *  Result of the verification of a verification object.
+   */
+  struct VResult {
+    bool valid;                     ///< False if the VO is malformed or incomplete
+    box_t box;                      ///< Reconstructed MBR of the root
+    digest_t hash;                  ///< Reconstructed digest of the root
+    std::vector<point_t> points;    ///< Points matching the query
+  };
+
+private:
+  std::vector<Leaf> leaves;   ///< Leaf nodes in curve order
+  std::vector<Inner> inners;  ///< Internal nodes, level by level
+  uint32_t root;              ///< Index of the root
+  uint32_t height;            ///< Number of levels (0 for an empty tree)
+
+  /**
+   *  Serializes a point into a hash buffer.
+   */
+  static uint8_t *put_point(uint8_t *ptr, const point_t &p) {
+    std::memcpy(ptr, &p.id, sizeof(uint32_t));
+    std::memcpy(ptr + sizeof(uint32_t), p.c.data(), Dim * sizeof(Coord));
+    return ptr + POINT_BYTES;
+  }
+
+  /**
+   *  Serializes a child entry into a hash buffer.
+   */
+  static uint8_t *put_entry(uint8_t *ptr, const box_t &b, const digest_t &h) {
+    std::memcpy(ptr, b.lo.data(), Dim * sizeof(Coord));
+    std::memcpy(ptr + Dim * sizeof(Coord), b.hi.data(), Dim * sizeof(Coord));
+    std::memcpy(ptr + 2 * Dim * sizeof(Coord), h.data(), Hash::DIGEST_SIZE);
+    return ptr + ENTRY_BYTES;
+  }
+
+  /**
+   *  Computes MBR and digest of a filled leaf.
+   */
+  static void seal_leaf(Leaf &leaf) {
+    uint8_t buf[LEAF_BUF_SIZE];
+    uint8_t *ptr = buf;
+    leaf.box = box_t::empty();
+    for (uint32_t i = 0; i < leaf.size; i++) {
+      leaf.box.enlarge(leaf.points[i]);
+      ptr = put_point(ptr, leaf.points[i]);
+    }
+    leaf.hash = Hash::digest(buf, ptr - buf);
+  }
+
+  /**
+   *  Computes MBR and digest of a filled internal node.
+   */
+  void seal_inner(Inner &node) const {
+    uint8_t buf[INNER_BUF_SIZE];
+    uint8_t *ptr = buf;
+    node.box = box_t::empty();
+    for (uint32_t i = 0; i < node.size; i++) {
+      const box_t &b = child_box(node, i);
+      node.box.enlarge(b);
+      ptr = put_entry(ptr, b, child_hash(node, i));
+    }
+    node.hash = Hash::digest(buf, ptr - buf);
+  }
+
+  const box_t &child_box(const Inner &node, uint32_t i) const {
+    return (node.level == 1) ? leaves[node.children[i]].box : inners[node.children[i]].box;
+  }
+
+  const digest_t &child_hash(const Inner &node, uint32_t i) const {
+    return (node.level == 1) ? leaves[node.children[i]].hash : inners[node.children[i]].hash;
+  }
+
+  /**
+   *  Recursive step of the range query.
+   */
+  void query_node(uint32_t idx, uint32_t level, const box_t &q,
+                  VO &vo, QueryStats2D *stats) const {
+    if (stats) stats->nodes_visited++;
+    if (level == 0) {
+      const Leaf &leaf = leaves[idx];
+      if (!leaf.box.intersects(q)) {
+        if (stats) stats->nodes_pruned++;
+        vo.entries.push_back({VO_PRUNED, 0, leaf.box, leaf.hash});
+        return;
+      }
+      if (stats) stats->points_examined += leaf.size;
+      vo.entries.push_back({VO_LEAF, leaf.size, box_t(), digest_t()});
+      vo.points.insert(vo.points.end(), leaf.points.begin(),
+                       leaf.points.begin() + leaf.size);
+      return;
+    }
+    const Inner &node = inners[idx];
+    if (!node.box.intersects(q)) {
+      if (stats) stats->nodes_pruned++;
+      vo.entries.push_back({VO_PRUNED, 0, node.box, node.hash});
+      return;
+    }
+    vo.entries.push_back({VO_OPEN, node.size, box_t(), digest_t()});
+    for (uint32_t i = 0; i < node.size; i++) {
+      query_node(node.children[i], level - 1, q, vo, stats);
+    }
+  }
+
+  /**
+   *  Recursive step of the verification. Open entries nested deeper than
+   *  MAX_HEIGHT levels are rejected, which bounds the stack used by the
+   *  per-level hash buffers.
+   *  @param depth the level of the entry below the root
+   *  @return false if the VO is malformed or omits part of the result
+   */
+  static bool verify_entry(const VO &vo, size_t &e, size_t &p, const box_t &q,
+                           box_t &box, digest_t &hash, std::vector<point_t> &out,
+                           QueryStats2D *stats, uint32_t depth) {
+    if (e >= vo.entries.size()) return false;
+    const VOEntry &entry = vo.entries[e++];
+    switch (entry.kind) {
+      case VO_PRUNED:
+        // A pruned subtree must not overlap the query, otherwise results are missing.
+        if (entry.box.intersects(q)) return false;
+        box = entry.box;
+        hash = entry.hash;
+        return true;
+
+      case VO_LEAF: {
+        if (entry.size > LeafCap || p + entry.size > vo.points.size()) return false;
+        uint8_t buf[LEAF_BUF_SIZE];
+        uint8_t *ptr = buf;
+        box = box_t::empty();
+        for (uint32_t i = 0; i < entry.size; i++) {
+          const point_t &pt = vo.points[p++];
+          box.enlarge(pt);
+          ptr = put_point(ptr, pt);
+          if (q.contains(pt)) {
+            out.push_back(pt);
+            if (stats) stats->points_returned++;
+          }
+        }
+        hash = Hash::digest(buf, ptr - buf);
+        return true;
+      }
+
+      case VO_OPEN: {
+        if (entry.size > Fanout || depth + 1 >= MAX_HEIGHT) return false;
+        uint8_t buf[INNER_BUF_SIZE];
+        uint8_t *ptr = buf;
+        box = box_t::empty();
+        for (uint32_t i = 0; i < entry.size; i++) {
+          box_t child_box;
+          digest_t child_hash;
+          if (!verify_entry(vo, e, p, q, child_box, child_hash, out, stats, depth + 1)) return false;
+          box.enlarge(child_box);
+          ptr = put_entry(ptr, child_box, child_hash);
+        }
+        hash = Hash::digest(buf, ptr - buf);
+        return true;
+      }
+    }
+    return false;
+  }
+
+public:
+  /**
+   *  Constructs an empty tree.
+   */
+  MRTree() : root(0), height(0) {}
+
+  /**
+   *  Bulk-loads the tree from a list of points. Points are sorted on
+   *  their curve key; ties keep the input order.
+   *  @param pts list of points
+   */
+  void build(const std::vector<point_t> &pts) {
+    leaves.clear();
+    inners.clear();
+    root = 0;
+    height = 0;
+    if (pts.empty()) return;
+
+    box_t domain = box_t::empty();
+    for (const point_t &p : pts) domain.enlarge(p);
+
+    std::vector<std::pair<uint64_t, uint32_t>> order(pts.size());
+    for (size_t i = 0; i < pts.size(); i++) {
+      order[i] = {Curve::key(pts[i].c, domain), static_cast<uint32_t>(i)};
+    }
+    std::sort(order.begin(), order.end());
+
+    // Fill leaves in curve order.
+    leaves.resize((pts.size() + LeafCap - 1) / LeafCap);
+    for (size_t l = 0; l < leaves.size(); l++) {
+      Leaf &leaf = leaves[l];
+      size_t begin = l * LeafCap, end = std::min(pts.size(), begin + LeafCap);
+      leaf.size = static_cast<uint32_t>(end - begin);
+      for (size_t i = begin; i < end; i++) leaf.points[i - begin] = pts[order[i].second];
+      seal_leaf(leaf);
+    }
+
+    // Build internal levels bottom-up.
+    uint32_t level = 0;
+    size_t level_begin = 0, level_size = leaves.size();
+    while (level_size > 1) {
+      level++;
+      size_t next_begin = inners.size();
+      for (size_t i = 0; i < level_size; i += Fanout) {
+        Inner node;
+        node.level = level;
+        node.size = static_cast<uint32_t>(std::min(Fanout, level_size - i));
+        for (uint32_t j = 0; j < node.size; j++) {
+          node.children[j] = static_cast<uint32_t>(level_begin + i + j);
+        }
+        seal_inner(node);
+        inners.push_back(node);
+      }
+      level_begin = next_begin;
+      level_size = inners.size() - next_begin;
+    }
+    root = static_cast<uint32_t>(level_begin);
+    height = level + 1;
+  }
+
+  /**
+   *  Returns true if the tree contains no points.
+   */
+  bool empty() const { return height == 0; }
+
+  /**
+   *  Returns the number of levels of the tree (leaves included).
+   */
+  uint32_t getHeight() const { return height; }
+
+  /**
+   *  Returns the number of leaves of the tree.
+   */
+  size_t countLeaves() const { return leaves.size(); }
+
+  /**
+   *  Returns the MBR of the root.
+   */
+  box_t getRootBox() const {
+    if (empty()) return box_t::empty();
+    return (height == 1) ? leaves[root].box : inners[root].box;
+  }
+
+  /**
+   *  Returns the digest of the root.
+   */
+  digest_t getRootHash() const {
+    if (empty()) return digest_t{};
+    return (height == 1) ? leaves[root].hash : inners[root].hash;
+  }
+
+  /**
+   *  Performs a range query and builds the verification object.
+   *  @param q the query box
+   *  @param stats optional statistics collector
+   *  @return the verification object
+   */
+  VO range_query(const box_t &q, QueryStats2D *stats = nullptr) const {
+    VO vo;
+    if (!empty()) query_node(root, height - 1, q, vo, stats);
+    return vo;
+  }
+
+  /**
+   *  Verifies a verification object and reconstructs the root.
+   *  The caller must compare the reconstructed digest with a trusted one.
+   *  @param vo the verification object
+   *  @param q the query box
+   *  @param stats optional statistics collector
+   *  @return the verification result
+   */
+  static VResult verify(const VO &vo, const box_t &q, QueryStats2D *stats = nullptr) {
+    VResult res;
+    res.box = box_t::empty();
+    res.hash = digest_t{};
+    if (vo.entries.empty()) {
+      res.valid = vo.points.empty();
+      return res;
+    }
+    size_t e = 0, p = 0;
+    res.valid = verify_entry(vo, e, p, q, res.box, res.hash, res.points, stats, 0) &&
+                e == vo.entries.size() && p == vo.points.size();
+    return res;
+  }
+
+  /**
+   *  Performs a range query followed by its verification.
+   *  @param q the query box
+   *  @param stats optional statistics collector
+   *  @return the verification result
+   */
+  VResult query_and_verify(const box_t &q, QueryStats2D *stats = nullptr) const {
+    using namespace std::chrono;
+    if (stats) *stats = QueryStats2D();
+    auto query_start = high_resolution_clock::now();
+    VO vo = range_query(q, stats);
+    auto query_end = high_resolution_clock::now();
+    VResult res = verify(vo, q, stats);
+    auto verify_end = high_resolution_clock::now();
+    if (stats) {
+      stats->query_time_us = duration_cast<microseconds>(query_end - query_start).count();
+      stats->verify_time_us = duration_cast<microseconds>(verify_end - query_end).count();
+    }
+    return res;
+  }
+};
+
+#ifdef Z_INDEX
+typedef MortonCurve<2> MRCurve2D;   ///< Curve matching the order of Point2D
+#else
+typedef LexCurve MRCurve2D;         ///< Curve matching the order of Point2D
+#endif
+
+/**
+ *  The 2D MR-tree as an instantiation of the template.
+ *  Its digests match those of build_2d_tree with the same capacity.
+ */
+template<size_t Cap>
+using MRTree2D = MRTree<2, int32_t, Cap, Cap, MRCurve2D, Sha256Hash>;
+
+/**
+ *  Converts a Point2D into a point of the templated tree.
+ */
+static inline MRPoint<2, int32_t> to_mr_point(const Point2D &p) {
+  return MRPoint<2, int32_t>{p.id, {{p.loc.x, p.loc.y}}};
+}
+
+/**
+ *  Converts a point of the templated tree into a Point2D.
+ */
+static inline Point2D from_mr_point(const MRPoint<2, int32_t> &p) {
+  return Point2D(p.id, p.c[0], p.c[1]);
+}
+
+/**
+ *  Converts a Rectangle into a box of the templated tree.
+ */
+static inline MRBox<2, int32_t> to_mr_box(const Rectangle &r) {
+  return MRBox<2, int32_t>{{{r.lx, r.ly}}, {{r.ux, r.uy}}};
+}
+
+/**
+ *  Converts a box of the templated tree into a Rectangle.
+ */
+static inline Rectangle from_mr_box(const MRBox<2, int32_t> &b) {
+  return Rectangle{b.lo[0], b.lo[1], b.hi[0], b.hi[1]};
+}
+
+/**
+ *  Converts a list of Point2D into points of the templated tree.
+ */
+static inline std::vector<MRPoint<2, int32_t>> to_mr_points(const std::vector<Point2D> &points) {
+  std::vector<MRPoint<2, int32_t>> out;
+  out.reserve(points.size());
+  for (const Point2D &p : points) out.push_back(to_mr_point(p));
+  return out;
+}
+
+#endif
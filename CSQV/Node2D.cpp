@@ -21,7 +21,7 @@
 /**
  *  Creates a new 2D leaf node from a list of points.
  */
-LeafNode2D *make_leaf_2d(std::vector<Point2D> points) {
+LeafNode2D *make_leaf_2d(std::vector<Point2D> points, const AttributeStore *attrs) {
   if (points.empty()) {
     return new LeafNode2D(EMPTY_RECT, hash_t{}, std::vector<Point2D>());
   }
@@ -30,15 +30,25 @@ LeafNode2D *make_leaf_2d(std::vector<Point2D> points) {
   Rectangle rect = compute_mbr(points);
   
   // Create buffer for hashing
-  Buffer buf(points.size() * (sizeof(uint32_t) + 2 * sizeof(int32_t)));
-  for (const Point2D &p : points) {
-    put_point2d(buf, p);
+  std::vector<hash_t> digests;
+  Buffer buf(points.size() * (sizeof(uint32_t) + 2 * sizeof(int32_t) +
+                              (attrs ? SHA256_DIGEST_LENGTH : 0)));
+  if (attrs) {
+    digests.reserve(points.size());
+    for (const Point2D &p : points) {
+      digests.push_back(attrs->getDigest(p.id));
+      put_point2d(buf, p, digests.back());
+    }
+  } else {
+    for (const Point2D &p : points) {
+      put_point2d(buf, p);
+    }
   }
   
   // Compute hash
   hash_t hash = sha256(buf);
   
-  return new LeafNode2D(rect, hash, std::move(points));
+  return new LeafNode2D(rect, hash, std::move(points), std::move(digests));
 }
 
 /**
@@ -74,13 +84,25 @@ IntNode2D *make_internal_2d(std::vector<Node2D*> children) {
 /**
  *  Builds a 2D MR-tree using bulk-loading algorithm.
  */
-Node2D *build_2d_tree(std::vector<Point2D> &points, size_t capacity) {
+Node2D *build_2d_tree(std::vector<Point2D> &points, size_t capacity,
+                      const AttributeStore *attrs) {
   if (points.empty()) {
     return nullptr;
   }
   
   // Sort points for spatial locality
   std::sort(points.begin(), points.end());
+  return build_sorted_2d_tree(points, capacity, attrs);
+}
+
+/**
+ *  Builds a 2D MR-tree from a list of points already in the desired order.
+ */
+Node2D *build_sorted_2d_tree(const std::vector<Point2D> &points, size_t capacity,
+                             const AttributeStore *attrs) {
+  if (points.empty()) {
+    return nullptr;
+  }
   
   // Create leaf nodes by splitting points into chunks
   std::vector<Node2D*> current_level;
@@ -89,7 +111,7 @@ Node2D *build_2d_tree(std::vector<Point2D> &points, size_t capacity) {
   for (size_t i = 0; i < points.size(); i += capacity) {
     size_t end = std::min(points.size(), i + capacity);
     std::vector<Point2D> chunk(points.begin() + i, points.begin() + end);
-    current_level.push_back(make_leaf_2d(std::move(chunk)));
+    current_level.push_back(make_leaf_2d(std::move(chunk), attrs));
   }
   
   // Build internal levels bottom-up
@@ -11,6 +11,7 @@
 #include "Geometry.hpp"
 #include "Hash.hpp"
 #include "Point2D.hpp"
+#include "Attributes2D.hpp"
 
 /**
  *  This enum defines the kind of a MR-tree node for 2D points.
@@ -26,6 +27,8 @@ private:
   Node2DType type;    ///< Node type indicator
   Rectangle rect;     ///< Bounding rectangle
   hash_t hash;        ///< The digest of the node
+
+  friend class AppendTree2D;
   
 public:
   /**
@@ -63,6 +66,9 @@ public:
 class LeafNode2D : public Node2D {
 private:
   std::vector<Point2D> points; ///< List of 2D points in this leaf
+  std::vector<hash_t> digests; ///< Payload digests of the points (empty if none)
+
+  friend class AppendTree2D;
   
 public:
   /**
@@ -70,14 +76,26 @@ public:
    *  @param r the node rectangle
    *  @param h the hash value of the node
    *  @param points list of 2D points to be stored
+   *  @param digests payload digests of the points, empty if the tree has no payloads
    */
-  LeafNode2D(Rectangle r, hash_t h, std::vector<Point2D> points)
-  : Node2D(N2D_LEAF, r, h), points(std::move(points)) {}
+  LeafNode2D(Rectangle r, hash_t h, std::vector<Point2D> points,
+             std::vector<hash_t> digests = std::vector<hash_t>())
+  : Node2D(N2D_LEAF, r, h), points(std::move(points)), digests(std::move(digests)) {}
 
   /**
    *  Returns the list of 2D points contained in the node.
    */
   const std::vector<Point2D> &getPoints() const { return points; }
+
+  /**
+   *  Returns the payload digests of the points (empty if the tree has no payloads).
+   */
+  const std::vector<hash_t> &getDigests() const { return digests; }
+
+  /**
+   *  Returns true if the leaf commits to the payloads of its points.
+   */
+  bool hasPayload() const { return !digests.empty(); }
   
   /**
    *  Returns the number of points in this leaf.
@@ -91,6 +109,8 @@ public:
 class IntNode2D : public Node2D {
 private:
   std::vector<Node2D*> children; ///< List of child nodes
+
+  friend class AppendTree2D;
   
 public:
   /**
@@ -115,10 +135,14 @@ public:
 
 /**
  *  Creates a new 2D leaf node from a list of points.
+ *  If an attribute store is given, the leaf also commits to the
+ *  payload digest of each point.
  *  @param points the list of 2D points
+ *  @param attrs optional attribute store
  *  @return a leaf node for the 2D MR-tree
  */
-LeafNode2D *make_leaf_2d(std::vector<Point2D> points);
+LeafNode2D *make_leaf_2d(std::vector<Point2D> points,
+                         const AttributeStore *attrs = nullptr);
 
 /**
  *  Creates a new 2D internal node from a list of child nodes.
@@ -131,9 +155,21 @@ IntNode2D *make_internal_2d(std::vector<Node2D*> children);
  *  Builds a 2D MR-tree from a list of points using bulk-loading.
  *  @param points list of 2D points
  *  @param capacity page capacity
+ *  @param attrs optional attribute store whose payloads the leaves commit to
+ *  @return pointer to the root node of the 2D tree
+ */
+Node2D *build_2d_tree(std::vector<Point2D> &points, size_t capacity,
+                      const AttributeStore *attrs = nullptr);
+
+/**
+ *  Builds a 2D MR-tree from a list of points already in the desired order.
+ *  @param points list of sorted 2D points
+ *  @param capacity page capacity
+ *  @param attrs optional attribute store whose payloads the leaves commit to
  *  @return pointer to the root node of the 2D tree
  */
-Node2D *build_2d_tree(std::vector<Point2D> &points, size_t capacity);
+Node2D *build_sorted_2d_tree(const std::vector<Point2D> &points, size_t capacity,
+                             const AttributeStore *attrs = nullptr);
 
 /**
  *  Frees the memory occupied by a 2D MR-tree.
@@ -0,0 +1,210 @@
+/**
+ *  @file Page2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Page2D.hpp"
+#include <algorithm>
+#include <cstring>
+
+/**
+ *  Position of a node relative to a depth-first position.
+ */
+enum PagePos2D {PP2D_BEFORE, PP2D_ON_PATH, PP2D_AFTER};
+
+/**
+ *  Locates the subtree at path relative to the position pos: entirely
+ *  before it, containing it, or entirely at or after it.
+ */
+static PagePos2D locate_2d(const PagePath2D &path, const PagePath2D &pos) {
+  auto m = std::mismatch(path.begin(), path.end(), pos.begin(), pos.end());
+  if (m.first == path.end()) return (m.second == pos.end()) ? PP2D_AFTER : PP2D_ON_PATH;
+  if (m.second == pos.end()) return PP2D_AFTER;
+  return (*m.first < *m.second) ? PP2D_BEFORE : PP2D_AFTER;
+}
+
+/**
+ *  Returns the token of the first page of a query.
+ */
+PageToken2D first_page_token_2d(const hash_t &root) {
+  return PageToken2D{root, PagePath2D(), false};
+}
+
+/**
+ *  State of the construction of one page.
+ */
+struct PageBuild2D {
+  const Rectangle &query;
+  const PagePath2D &start;
+  size_t budget;
+  size_t used;        ///< Bytes of the leaves shipped so far
+  bool stopped;       ///< True once the budget is reached
+  PagePath2D stop;    ///< Position of the first leaf not shipped
+  QueryStats2D *stats;
+};
+
+/**
+ *  Recursive step of a page: nodes before the start, after the stop or
+ *  outside the query are pruned.
+ */
+static VObject2D *range_query_page_2d(Node2D *root, PagePath2D &path, PageBuild2D &st) {
+  if (st.stats) st.stats->nodes_visited++;
+  
+  PagePos2D pos = locate_2d(path, st.start);
+  if (st.stopped || pos == PP2D_BEFORE || !overlap(root->getRect(), st.query)) {
+    if (st.stats) st.stats->nodes_pruned++;
+    return new VPruned2D(root->getRect(), root->getHash());
+  }
+  
+  if (root->getType() == N2D_LEAF) {
+    LeafNode2D *leaf = static_cast<LeafNode2D*>(root);
+    VLeaf2D *vleaf = ship_leaf_2d(leaf);
+    size_t size = vo_size_2d(vleaf);
+    if (st.used > 0 && st.used + size > st.budget) {
+      delete vleaf;
+      st.stopped = true;
+      st.stop = path;
+      if (st.stats) st.stats->nodes_pruned++;
+      return new VPruned2D(leaf->getRect(), leaf->getHash());
+    }
+    st.used += size;
+    if (st.stats) st.stats->points_examined += leaf->size();
+    return vleaf;
+  }
+  
+  VContainer2D *container = new VContainer2D();
+  const std::vector<Node2D*> &children = static_cast<IntNode2D*>(root)->getChildren();
+  for (size_t i = 0; i < children.size(); i++) {
+    path.push_back(static_cast<uint32_t>(i));
+    container->append(range_query_page_2d(children[i], path, st));
+    path.pop_back();
+  }
+  return container;
+}
+
+/**
+ *  Performs one page of a 2D range query.
+ */
+VObject2D *range_query_page_2d(Node2D *root, const Rectangle &query,
+                               const PageToken2D &from, size_t budget,
+                               PageToken2D &next, QueryStats2D *stats) {
+  if (!root || from.done || from.root != root->getHash()) return nullptr;
+  
+  PageBuild2D st{query, from.next, budget, 0, false, PagePath2D(), stats};
+  PagePath2D path;
+  VObject2D *vo = range_query_page_2d(root, path, st);
+  next = PageToken2D{from.root, st.stop, !st.stopped};
+  return vo;
+}
+
+/**
+ *  State of the verification of one page.
+ */
+struct PageVerify2D {
+  const Rectangle &query;
+  const PageToken2D &from;
+  const PageToken2D &next;
+  std::vector<Point2D> points;
+  bool complete;
+  QueryStats2D *stats;
+};
+
+/**
+ *  Returns true if the subtree at path lies inside the page [from, next).
+ */
+static bool in_page_2d(const PagePath2D &path, const PageVerify2D &st) {
+  return locate_2d(path, st.from.next) != PP2D_BEFORE &&
+         (st.next.done || locate_2d(path, st.next.next) == PP2D_BEFORE);
+}
+
+/**
+ *  Recursive step of the verification of a page.
+ */
+static void verify_page_2d(VObject2D *vo, PagePath2D &path, PageVerify2D &st,
+                           Rectangle &rect, hash_t &hash) {
+  switch (vo->getType()) {
+    case V2D_LEAF: {
+      VResult2D *res = verify_2d(vo, st.query, in_page_2d(path, st) ? st.stats : nullptr);
+      rect = res->getRect();
+      hash = res->getHash();
+      if (in_page_2d(path, st)) {
+        st.points.insert(st.points.end(), res->getPoints().begin(), res->getPoints().end());
+      }
+      delete res;
+      return;
+    }
+    
+    case V2D_PRUNED: {
+      VPruned2D *pruned = static_cast<VPruned2D*>(vo);
+      rect = pruned->getRect();
+      hash = pruned->getHash();
+      if (!overlap(rect, st.query)) return;
+      
+      // A pruned node overlapping the query must lie before or after the page.
+      bool before = locate_2d(path, st.from.next) == PP2D_BEFORE;
+      bool after = !st.next.done && locate_2d(path, st.next.next) == PP2D_AFTER;
+      if (!before && !after) st.complete = false;
+      return;
+    }
+    
+    case V2D_CONTAINER: {
+      VContainer2D *container = static_cast<VContainer2D*>(vo);
+      verify_children_2d(container, [&](size_t i, Rectangle &child_rect, hash_t &child_hash) {
+        path.push_back(static_cast<uint32_t>(i));
+        verify_page_2d(container->get(i), path, st, child_rect, child_hash);
+        path.pop_back();
+      }, rect, hash);
+      return;
+    }
+  }
+}
+
+/**
+ *  Verifies one page of a 2D range query.
+ */
+VResult2D *verify_page_2d(VObject2D *vo, const Rectangle &query,
+                          const PageToken2D &from, const PageToken2D &next,
+                          QueryStats2D *stats) {
+  if (!vo || from.done || from.root != next.root) return nullptr;
+  
+  PageVerify2D st{query, from, next, {}, true, stats};
+  PagePath2D path;
+  Rectangle rect;
+  hash_t hash;
+  verify_page_2d(vo, path, st, rect, hash);
+  if (!st.complete) return nullptr;
+  return new VResult2D(rect, hash, std::move(st.points));
+}
+
+/**
+ *  Encodes a continuation token.
+ */
+std::vector<uint8_t> encode_page_token_2d(const PageToken2D &token) {
+  std::vector<uint8_t> out(token.root.size() + 1 + sizeof(uint32_t) * (1 + token.next.size()));
+  uint8_t *p = out.data();
+  std::memcpy(p, token.root.data(), token.root.size());
+  p += token.root.size();
+  *p++ = token.done ? 1 : 0;
+  uint32_t depth = static_cast<uint32_t>(token.next.size());
+  std::memcpy(p, &depth, sizeof(depth));
+  p += sizeof(depth);
+  if (depth) std::memcpy(p, token.next.data(), depth * sizeof(uint32_t));
+  return out;
+}
+
+/**
+ *  Decodes a continuation token.
+ */
+bool decode_page_token_2d(const uint8_t *data, size_t size, PageToken2D &token) {
+  size_t header = token.root.size() + 1 + sizeof(uint32_t);
+  if (!data || size < header) return false;
+  uint32_t depth;
+  std::memcpy(&depth, data + token.root.size() + 1, sizeof(depth));
+  if (data[token.root.size()] > 1 || (size - header) / sizeof(uint32_t) != depth ||
+      (size - header) % sizeof(uint32_t) != 0) return false;
+  std::memcpy(token.root.data(), data, token.root.size());
+  token.done = data[token.root.size()] == 1;
+  token.next.resize(depth);
+  if (depth) std::memcpy(token.next.data(), data + header, depth * sizeof(uint32_t));
+  return true;
+}
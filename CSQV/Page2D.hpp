@@ -0,0 +1,86 @@
+/**
+ *  @file Page2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Paginated 2D range queries with continuation tokens.
+ *
+ *  Leaves of the MR-tree are in sort order (Morton order with Z_INDEX), so
+ *  the depth-first position of a leaf, given as the path of child indices
+ *  from the root, is a curve-order boundary. A page ships the leaves
+ *  overlapping the query from the start position of its token up to a byte
+ *  budget; everything before the start or after the stop position is
+ *  pruned. The verifier checks that every pruned node overlapping the query
+ *  lies entirely outside the page, so that chained pages cover the query
+ *  exactly once.
+ */
+
+#ifndef PAGE2D_H
+#define PAGE2D_H
+
+#include "Query2D.hpp"
+#include <vector>
+
+/**
+ *  Depth-first position in a tree: child indices from the root.
+ */
+typedef std::vector<uint32_t> PagePath2D;
+
+/**
+ *  Continuation token of a paginated query.
+ */
+struct PageToken2D {
+  hash_t root;      ///< Root digest of the tree the pages come from
+  PagePath2D next;  ///< Position of the first leaf of the next page
+  bool done;        ///< True if no page follows
+};
+
+/**
+ *  Returns the token of the first page of a query.
+ *  @param root the root digest of the tree
+ */
+PageToken2D first_page_token_2d(const hash_t &root);
+
+/**
+ *  Performs one page of a 2D range query. At least one leaf is shipped per
+ *  page, so every call makes progress; the budget bounds the leaves
+ *  shipped, the digests of the pruned remainder come on top.
+ *  @param root the root of the 2D MR-tree
+ *  @param query the query rectangle
+ *  @param from the token of the page (first_page_token_2d for the first one)
+ *  @param budget the byte budget of the leaves of the page
+ *  @param next receives the token of the next page
+ *  @param stats optional statistics collector
+ *  @return the verification object, or nullptr if the token is of another tree or done
+ */
+VObject2D *range_query_page_2d(Node2D *root, const Rectangle &query,
+                               const PageToken2D &from, size_t budget,
+                               PageToken2D &next, QueryStats2D *stats = nullptr);
+
+/**
+ *  Verifies one page of a 2D range query.
+ *  The caller must compare the reconstructed hash with the trusted root,
+ *  and pass the token it received with the previous page as from.
+ *  @param vo the verification object of the page
+ *  @param query the query rectangle
+ *  @param from the token the page was requested with
+ *  @param next the token returned with the page
+ *  @param stats optional statistics collector
+ *  @return the verification result with the matching points of the page,
+ *          or nullptr if the page leaves part of its range unproven
+ */
+VResult2D *verify_page_2d(VObject2D *vo, const Rectangle &query,
+                          const PageToken2D &from, const PageToken2D &next,
+                          QueryStats2D *stats = nullptr);
+
+/**
+ *  Encodes a continuation token: root digest, done flag, depth and path.
+ */
+std::vector<uint8_t> encode_page_token_2d(const PageToken2D &token);
+
+/**
+ *  Decodes a continuation token.
+ *  @return false if the encoding is malformed
+ */
+bool decode_page_token_2d(const uint8_t *data, size_t size, PageToken2D &token);
+
+#endif
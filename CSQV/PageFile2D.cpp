@@ -0,0 +1,429 @@
+/**
+ *  @file PageFile2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "PageFile2D.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+/**
+ *  Magic number and version of page files.
+ */
+#define PAGE2D_MAGIC "CSQVPAGE"
+#define PAGE2D_VERSION 1
+
+/**
+ *  Sizes of the parts of a page.
+ */
+#define PAGE2D_NODE_HEADER 8
+#define PAGE2D_POINT_SIZE (sizeof(uint32_t) + 2 * sizeof(int32_t))
+#define PAGE2D_ENTRY_SIZE (4 * sizeof(int32_t) + SHA256_DIGEST_LENGTH + sizeof(uint32_t))
+#define PAGE2D_FILE_HEADER (8 + 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t) + sizeof(uint32_t) + PAGE2D_ENTRY_SIZE)
+
+/**
+ *  Appends a value to a byte vector.
+ */
+template <typename T>
+static inline void append_2d(std::vector<uint8_t> &buf, const T &x) {
+  const uint8_t *p = reinterpret_cast<const uint8_t*>(&x);
+  buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+/**
+ *  Appends an entry to a byte vector.
+ */
+static inline void append_entry_2d(std::vector<uint8_t> &buf, const PageEntry2D &e) {
+  append_2d(buf, e.rect.lx);
+  append_2d(buf, e.rect.ly);
+  append_2d(buf, e.rect.ux);
+  append_2d(buf, e.rect.uy);
+  buf.insert(buf.end(), e.hash.begin(), e.hash.end());
+  append_2d(buf, e.page);
+}
+
+/**
+ *  Reads an entry from a page.
+ */
+static inline PageEntry2D read_entry_2d(const uint8_t *p) {
+  PageEntry2D e;
+  std::memcpy(&e.rect.lx, p, sizeof(int32_t));
+  std::memcpy(&e.rect.ly, p + sizeof(int32_t), sizeof(int32_t));
+  std::memcpy(&e.rect.ux, p + 2 * sizeof(int32_t), sizeof(int32_t));
+  std::memcpy(&e.rect.uy, p + 3 * sizeof(int32_t), sizeof(int32_t));
+  std::memcpy(e.hash.data(), p + 4 * sizeof(int32_t), e.hash.size());
+  std::memcpy(&e.page, p + 4 * sizeof(int32_t) + SHA256_DIGEST_LENGTH, sizeof(uint32_t));
+  return e;
+}
+
+/**
+ *  Creates a page file.
+ */
+bool PageWriter2D::open(const std::string &path, uint32_t page_size) {
+  this->page_size = page_size;
+  next_page = 1;
+  if (page_size < PAGE2D_FILE_HEADER) return false;
+  file.open(path, std::ios::binary | std::ios::trunc);
+  if (!file) return false;
+  
+  // Page 0 is reserved for the header, written by finish.
+  buf.assign(page_size, 0);
+  file.write(reinterpret_cast<const char*>(buf.data()), page_size);
+  return (bool) file;
+}
+
+/**
+ *  Pads the node in buf to a page and writes it.
+ */
+bool PageWriter2D::writePage(PageEntry2D &out) {
+  if (buf.size() > page_size) {
+    std::cerr << "Error writing page file: node of " << buf.size()
+              << " bytes does not fit in a page of " << page_size << std::endl;
+    return false;
+  }
+  buf.resize(page_size, 0);
+  file.write(reinterpret_cast<const char*>(buf.data()), page_size);
+  out.page |= next_page++;
+  return (bool) file;
+}
+
+/**
+ *  Writes a leaf page.
+ */
+bool PageWriter2D::writeLeaf(const std::vector<Point2D> &points, const std::vector<hash_t> &digests,
+                             PageEntry2D &out) {
+  bool payload = !digests.empty();
+  if (payload && digests.size() != points.size()) return false;
+  
+  buf.clear();
+  append_2d(buf, (uint8_t) N2D_LEAF);
+  append_2d(buf, (uint8_t) payload);
+  append_2d(buf, (uint16_t) 0);
+  append_2d(buf, (uint32_t) points.size());
+  
+  // Same digest as make_leaf_2d.
+  Buffer hbuf(points.size() * (PAGE2D_POINT_SIZE + (payload ? SHA256_DIGEST_LENGTH : 0)));
+  for (size_t i = 0; i < points.size(); i++) {
+    append_2d(buf, points[i].id);
+    append_2d(buf, points[i].loc.x);
+    append_2d(buf, points[i].loc.y);
+    if (payload) put_point2d(hbuf, points[i], digests[i]);
+    else put_point2d(hbuf, points[i]);
+  }
+  for (const hash_t &d : digests) buf.insert(buf.end(), d.begin(), d.end());
+  
+  out.rect = compute_mbr(points);
+  out.hash = points.empty() ? hash_t{} : sha256(hbuf);
+  out.page = PAGE2D_LEAF_BIT;
+  return writePage(out);
+}
+
+/**
+ *  Writes an internal page.
+ */
+bool PageWriter2D::writeInternal(const std::vector<PageEntry2D> &children, PageEntry2D &out) {
+  buf.clear();
+  append_2d(buf, (uint8_t) N2D_INT);
+  append_2d(buf, (uint8_t) 0);
+  append_2d(buf, (uint16_t) 0);
+  append_2d(buf, (uint32_t) children.size());
+  
+  // Same digest as make_internal_2d.
+  Buffer hbuf(children.size() * (4 * sizeof(int32_t) + SHA256_DIGEST_LENGTH));
+  out.rect = EMPTY_RECT;
+  for (const PageEntry2D &c : children) {
+    append_entry_2d(buf, c);
+    hash_t h = c.hash;
+    out.rect = enlarge(out.rect, c.rect);
+    hbuf.put(c.rect.lx).put(c.rect.ly).put(c.rect.ux).put(c.rect.uy)
+        .put_bytes(h.data(), h.size());
+  }
+  out.hash = children.empty() ? hash_t{} : sha256(hbuf);
+  out.page = 0;
+  return writePage(out);
+}
+
+/**
+ *  Writes the header and closes the file.
+ */
+bool PageWriter2D::finish(const PageEntry2D &root, uint64_t points, uint32_t height) {
+  buf.assign(PAGE2D_MAGIC, PAGE2D_MAGIC + 8);
+  append_2d(buf, (uint32_t) PAGE2D_VERSION);
+  append_2d(buf, page_size);
+  append_2d(buf, (uint64_t) next_page);
+  append_2d(buf, points);
+  append_2d(buf, height);
+  append_entry_2d(buf, root);
+  file.seekp(0);
+  file.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+  file.close();
+  return !file.fail();
+}
+
+/**
+ *  Writes a subtree, children first, counting its points and levels.
+ */
+static bool write_page_subtree_2d(PageWriter2D &writer, Node2D *node, PageEntry2D &out,
+                                  uint64_t &points, uint32_t &height) {
+  if (node->getType() == N2D_LEAF) {
+    LeafNode2D *leaf = static_cast<LeafNode2D*>(node);
+    points += leaf->size();
+    height = 1;
+    return writer.writeLeaf(leaf->getPoints(), leaf->getDigests(), out);
+  }
+  
+  const std::vector<Node2D*> &children = static_cast<IntNode2D*>(node)->getChildren();
+  std::vector<PageEntry2D> entries(children.size());
+  height = 0;
+  for (size_t i = 0; i < children.size(); i++) {
+    uint32_t child_height;
+    if (!write_page_subtree_2d(writer, children[i], entries[i], points, child_height)) return false;
+    height = std::max(height, child_height + 1);
+  }
+  return writer.writeInternal(entries, out);
+}
+
+/**
+ *  Writes an in-memory MR-tree to a page file.
+ */
+bool write_page_file_2d(Node2D *root, const std::string &path, uint32_t page_size) {
+  if (!root) return false;
+  PageWriter2D writer;
+  PageEntry2D entry;
+  uint64_t points = 0;
+  uint32_t height = 0;
+  if (!writer.open(path, page_size) ||
+      !write_page_subtree_2d(writer, root, entry, points, height)) return false;
+  return writer.finish(entry, points, height);
+}
+
+/**
+ *  Creates a pool.
+ */
+BufferPool2D::BufferPool2D(std::ifstream *file, uint32_t page_size, size_t n_frames)
+: file(file), page_size(page_size), frames(n_frames * page_size), pages(n_frames, 0),
+  pins(n_frames, 0), referenced(n_frames, false), used(n_frames, false), hand(0),
+  stats{0, 0, 0} {}
+
+/**
+ *  Pins a page, reading it if it is not resident.
+ */
+const uint8_t *BufferPool2D::fetch(uint32_t page) {
+  auto it = table.find(page);
+  if (it != table.end()) {
+    stats.hits++;
+    pins[it->second]++;
+    referenced[it->second] = true;
+    return &frames[it->second * page_size];
+  }
+  
+  // Clock: skip pinned frames, give referenced ones a second chance.
+  size_t n = pages.size(), frame = n;
+  for (size_t step = 0; step < 2 * n; step++) {
+    size_t f = hand;
+    hand = (hand + 1) % n;
+    if (pins[f] > 0) continue;
+    if (used[f] && referenced[f]) {
+      referenced[f] = false;
+      continue;
+    }
+    frame = f;
+    break;
+  }
+  if (frame == n) return nullptr;
+  
+  if (used[frame]) {
+    table.erase(pages[frame]);
+    stats.evictions++;
+  }
+  used[frame] = false;
+  file->clear();
+  file->seekg((std::streamoff) page * page_size);
+  file->read(reinterpret_cast<char*>(&frames[frame * page_size]), page_size);
+  if (!*file) return nullptr;
+  
+  stats.misses++;
+  pages[frame] = page;
+  pins[frame] = 1;
+  referenced[frame] = true;
+  used[frame] = true;
+  table[page] = frame;
+  return &frames[frame * page_size];
+}
+
+/**
+ *  Unpins a page fetched before.
+ */
+void BufferPool2D::unpin(uint32_t page) {
+  auto it = table.find(page);
+  if (it != table.end() && pins[it->second] > 0) pins[it->second]--;
+}
+
+/**
+ *  Parses the file header; false if it is malformed.
+ */
+static bool read_header_2d(const uint8_t *header, uint32_t &page_size, uint64_t &n_pages,
+                           uint64_t &n_points, uint32_t &height, PageEntry2D &root) {
+  if (std::memcmp(header, PAGE2D_MAGIC, 8) != 0) return false;
+  uint32_t version;
+  const uint8_t *p = header + 8;
+  std::memcpy(&version, p, sizeof(uint32_t));
+  std::memcpy(&page_size, p + sizeof(uint32_t), sizeof(uint32_t));
+  p += 2 * sizeof(uint32_t);
+  std::memcpy(&n_pages, p, sizeof(uint64_t));
+  std::memcpy(&n_points, p + sizeof(uint64_t), sizeof(uint64_t));
+  p += 2 * sizeof(uint64_t);
+  std::memcpy(&height, p, sizeof(uint32_t));
+  root = read_entry_2d(p + sizeof(uint32_t));
+  return version == PAGE2D_VERSION && page_size >= PAGE2D_FILE_HEADER &&
+         root.pageNo() != 0 && root.pageNo() < n_pages;
+}
+
+/**
+ *  Opens a page file.
+ */
+bool PagedTree2D::open(const std::string &path, size_t n_frames) {
+  close();
+  file.open(path, std::ios::binary);
+  if (!file) return false;
+  
+  uint8_t header[PAGE2D_FILE_HEADER];
+  file.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!file || n_frames == 0 ||
+      !read_header_2d(header, page_size, n_pages, n_points, height, root)) {
+    file.close();
+    return false;
+  }
+  
+  pool = new BufferPool2D(&file, page_size, n_frames);
+  return true;
+}
+
+/**
+ *  Closes the file.
+ */
+void PagedTree2D::close() {
+  delete pool;
+  pool = nullptr;
+  if (file.is_open()) file.close();
+}
+
+/**
+ *  Opens a page file image held in memory.
+ */
+bool PageImage2D::open(const uint8_t *data, size_t size) {
+  this->data = nullptr;
+  if (!data || size < PAGE2D_FILE_HEADER ||
+      !read_header_2d(data, page_size, n_pages, n_points, height, root) ||
+      n_pages > size / page_size) return false;
+  this->data = data;
+  return true;
+}
+
+/**
+ *  Returns a page of the image, or nullptr if it is past the end.
+ */
+const uint8_t *PageImage2D::fetch(uint32_t page) const {
+  return (page < n_pages) ? data + (size_t) page * page_size : nullptr;
+}
+
+/**
+ *  Recursive step of the paged range query over a buffer pool or an image;
+ *  failed is set on I/O error, if no frame can be pinned or on a bad page.
+ */
+template <typename Pages>
+static VObject2D *range_query_paged_2d(Pages &pool, const PageEntry2D &node,
+                                       const Rectangle &query, uint32_t page_size,
+                                       bool &failed, QueryStats2D *stats) {
+  if (failed) return nullptr;
+  
+  // As in range_query_2d, leaves of opened nodes are shipped untested.
+  if (!node.isLeaf() && !overlap(node.rect, query)) {
+    if (stats) {
+      stats->nodes_visited++;
+      stats->nodes_pruned++;
+    }
+    return new VPruned2D(node.rect, node.hash);
+  }
+  
+  const uint8_t *page = pool.fetch(node.pageNo());
+  if (!page) {
+    failed = true;
+    return nullptr;
+  }
+  if (stats) stats->nodes_visited++;
+  uint32_t n;
+  std::memcpy(&n, page + 4, sizeof(n));
+  bool payload = page[1] != 0;
+  size_t body = node.isLeaf() ? n * (PAGE2D_POINT_SIZE + (payload ? SHA256_DIGEST_LENGTH : 0))
+                              : n * PAGE2D_ENTRY_SIZE;
+  if (page[0] != (node.isLeaf() ? N2D_LEAF : N2D_INT) || body > page_size - PAGE2D_NODE_HEADER) {
+    pool.unpin(node.pageNo());
+    failed = true;
+    return nullptr;
+  }
+  const uint8_t *p = page + PAGE2D_NODE_HEADER;
+  
+  if (node.isLeaf()) {
+    std::vector<Point2D> points;
+    points.reserve(n);
+    for (uint32_t i = 0; i < n; i++, p += PAGE2D_POINT_SIZE) {
+      uint32_t id;
+      int32_t x, y;
+      std::memcpy(&id, p, sizeof(uint32_t));
+      std::memcpy(&x, p + sizeof(uint32_t), sizeof(int32_t));
+      std::memcpy(&y, p + sizeof(uint32_t) + sizeof(int32_t), sizeof(int32_t));
+      points.emplace_back(id, x, y);
+    }
+    std::vector<hash_t> digests(payload ? n : 0);
+    for (hash_t &d : digests) {
+      std::memcpy(d.data(), p, d.size());
+      p += d.size();
+    }
+    pool.unpin(node.pageNo());
+    if (stats) stats->points_examined += n;
+    return payload ? new VLeaf2D(points, std::move(digests), 0, std::vector<ProjectedRecord>())
+                   : new VLeaf2D(points);
+  }
+  
+  // The page stays pinned while its children are explored.
+  VContainer2D *container = new VContainer2D();
+  for (uint32_t i = 0; i < n && !failed; i++, p += PAGE2D_ENTRY_SIZE) {
+    container->append(range_query_paged_2d(pool, read_entry_2d(p), query, page_size, failed, stats));
+  }
+  pool.unpin(node.pageNo());
+  return container;
+}
+
+/**
+ *  Performs a 2D range query on a page file image.
+ */
+VObject2D *range_query_paged_2d(const PageImage2D &image, const Rectangle &query,
+                                QueryStats2D *stats) {
+  if (!image.isOpen()) return nullptr;
+  bool failed = false;
+  VObject2D *vo = range_query_paged_2d(image, image.getRoot(), query,
+                                       image.getPageSize(), failed, stats);
+  if (failed) {
+    delete_vo_2d(vo);
+    return nullptr;
+  }
+  return vo;
+}
+
+/**
+ *  Performs a 2D range query on a paged MR-tree.
+ */
+VObject2D *range_query_paged_2d(PagedTree2D &tree, const Rectangle &query,
+                                QueryStats2D *stats) {
+  if (!tree.isOpen()) return nullptr;
+  bool failed = false;
+  VObject2D *vo = range_query_paged_2d(tree.getPool(), tree.getRoot(), query,
+                                       tree.getPageSize(), failed, stats);
+  if (failed) {
+    delete_vo_2d(vo);
+    return nullptr;
+  }
+  return vo;
+}
@@ -0,0 +1,281 @@
+/**
+ *  @file PageFile2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Out-of-core MR-tree: page file format, writer, buffer pool and range query.
+ *
+ *  Every node takes one fixed-size page. Page 0 is the file header; node
+ *  pages are written bottom-up, so a writer can stream leaves and upper
+ *  levels without holding the tree. An internal page keeps the MBR, digest
+ *  and page of each child, so pruned children are never read. Digests are
+ *  those of make_leaf_2d and make_internal_2d: a paged tree has the same
+ *  root digest as the in-memory one and its VOs are checked with verify_2d.
+ *
+ *  Page layouts (native endian):
+ *    header: magic "CSQVPAGE", u32 version, u32 page size, u64 pages,
+ *            u64 points, u32 height, root entry
+ *    node:   u8 type, u8 payload, u16 unused, u32 n, then
+ *            leaf:     n × (u32 id, i32 x, i32 y) [+ n × 32-byte digests]
+ *            internal: n × entry
+ *    entry:  4 × i32 MBR, 32-byte digest, u32 page (top bit set for leaves)
+ */
+
+#ifndef PAGEFILE2D_H
+#define PAGEFILE2D_H
+
+#include "Query2D.hpp"
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ *  Default page size in bytes (holds 64-entry nodes, with payloads too).
+ */
+#define PAGE2D_DEFAULT_SIZE 4096
+
+/**
+ *  Flag of leaf pages in the page number of an entry.
+ */
+#define PAGE2D_LEAF_BIT 0x80000000u
+
+/**
+ *  Reference to a node page from its parent.
+ */
+struct PageEntry2D {
+  Rectangle rect; ///< MBR of the node
+  hash_t hash;    ///< Digest of the node
+  uint32_t page;  ///< Page number, with PAGE2D_LEAF_BIT for leaves
+
+  bool isLeaf() const { return (page & PAGE2D_LEAF_BIT) != 0; }
+  uint32_t pageNo() const { return page & ~PAGE2D_LEAF_BIT; }
+};
+
+/**
+ *  Writes a page file bottom-up: children must be written before their parent.
+ */
+class PageWriter2D {
+private:
+  std::ofstream file;
+  uint32_t page_size;
+  uint32_t next_page;      ///< Next free page (page 0 is the header)
+  std::vector<uint8_t> buf;
+
+  bool writePage(PageEntry2D &out);
+
+public:
+  PageWriter2D() : page_size(0), next_page(1) {}
+
+  /**
+   *  Creates a page file.
+   *  @param path the file
+   *  @param page_size the page size in bytes
+   *  @return false if the file cannot be created
+   */
+  bool open(const std::string &path, uint32_t page_size = PAGE2D_DEFAULT_SIZE);
+
+  /**
+   *  Writes a leaf page.
+   *  @param points the points of the leaf
+   *  @param digests their payload digests, or empty
+   *  @param out receives the entry of the leaf
+   *  @return false if the leaf does not fit in a page or cannot be written
+   */
+  bool writeLeaf(const std::vector<Point2D> &points, const std::vector<hash_t> &digests,
+                 PageEntry2D &out);
+
+  /**
+   *  Writes an internal page.
+   *  @param children the entries of the children
+   *  @param out receives the entry of the node
+   *  @return false if the node does not fit in a page or cannot be written
+   */
+  bool writeInternal(const std::vector<PageEntry2D> &children, PageEntry2D &out);
+
+  /**
+   *  Writes the header and closes the file.
+   *  @param root the entry of the root
+   *  @param points the number of points
+   *  @param height the number of levels
+   *  @return false on I/O error
+   */
+  bool finish(const PageEntry2D &root, uint64_t points, uint32_t height);
+
+  uint32_t getPageSize() const { return page_size; }
+  uint32_t countPages() const { return next_page; }
+};
+
+/**
+ *  Writes an in-memory MR-tree to a page file.
+ *  @param root the root of the 2D MR-tree
+ *  @param path the file
+ *  @param page_size the page size in bytes
+ *  @return false on error
+ */
+bool write_page_file_2d(Node2D *root, const std::string &path,
+                        uint32_t page_size = PAGE2D_DEFAULT_SIZE);
+
+/**
+ *  Statistics of a buffer pool.
+ */
+struct BufferPoolStats2D {
+  size_t hits;      ///< Fetches of resident pages
+  size_t misses;    ///< Fetches that read the file
+  size_t evictions; ///< Pages evicted
+
+  double hitRate() const { return (hits + misses) ? (double) hits / (hits + misses) : 0.0; }
+};
+
+/**
+ *  Fixed-size pool of page frames with clock (second chance) eviction.
+ *  Fetched pages stay pinned, and are never evicted, until unpinned.
+ *  Not thread-safe.
+ */
+class BufferPool2D {
+private:
+  std::ifstream *file;
+  uint32_t page_size;
+  std::vector<uint8_t> frames;                    ///< Page contents, frame by frame
+  std::vector<uint32_t> pages;                    ///< Page held by each frame
+  std::vector<uint32_t> pins;                     ///< Pin count of each frame
+  std::vector<bool> referenced;                   ///< Reference bit of each frame
+  std::vector<bool> used;                         ///< True if the frame holds a page
+  std::unordered_map<uint32_t, size_t> table;     ///< Frame of each resident page
+  size_t hand;                                    ///< Clock hand
+  BufferPoolStats2D stats;
+
+public:
+  /**
+   *  Creates a pool.
+   *  @param file the page file
+   *  @param page_size the page size in bytes
+   *  @param n_frames the number of frames
+   */
+  BufferPool2D(std::ifstream *file, uint32_t page_size, size_t n_frames);
+
+  /**
+   *  Pins a page, reading it if it is not resident.
+   *  @param page the page number
+   *  @return the page contents, or nullptr if all frames are pinned or on I/O error
+   */
+  const uint8_t *fetch(uint32_t page);
+
+  /**
+   *  Unpins a page fetched before.
+   */
+  void unpin(uint32_t page);
+
+  size_t countFrames() const { return pages.size(); }
+  const BufferPoolStats2D &getStats() const { return stats; }
+  void resetStats() { stats = BufferPoolStats2D{0, 0, 0}; }
+};
+
+/**
+ *  MR-tree stored in a page file and accessed through a buffer pool.
+ */
+class PagedTree2D {
+private:
+  std::ifstream file;
+  uint32_t page_size;
+  uint64_t n_pages;
+  uint64_t n_points;
+  uint32_t height;
+  PageEntry2D root;
+  BufferPool2D *pool;
+
+public:
+  PagedTree2D() : page_size(0), n_pages(0), n_points(0), height(0), root{}, pool(nullptr) {}
+  ~PagedTree2D() { close(); }
+  PagedTree2D(const PagedTree2D &) = delete;
+  PagedTree2D &operator=(const PagedTree2D &) = delete;
+
+  /**
+   *  Opens a page file.
+   *  @param path the file
+   *  @param n_frames frames of the buffer pool (at least the height of the tree)
+   *  @return false if the file cannot be read or is malformed
+   */
+  bool open(const std::string &path, size_t n_frames);
+
+  /**
+   *  Closes the file.
+   */
+  void close();
+
+  bool isOpen() const { return pool != nullptr; }
+  const PageEntry2D &getRoot() const { return root; }
+  hash_t getHash() const { return root.hash; }
+  uint32_t getPageSize() const { return page_size; }
+  uint64_t countPages() const { return n_pages; }
+  uint64_t size() const { return n_points; }
+  uint32_t getHeight() const { return height; }
+  BufferPool2D &getPool() { return *pool; }
+};
+
+/**
+ *  Read-only view of a whole page file held in memory, for instance mapped
+ *  from a file or a shared-memory segment. Pages are used in place.
+ */
+class PageImage2D {
+private:
+  const uint8_t *data;
+  uint32_t page_size;
+  uint64_t n_pages;
+  uint64_t n_points;
+  uint32_t height;
+  PageEntry2D root;
+
+public:
+  PageImage2D() : data(nullptr), page_size(0), n_pages(0), n_points(0), height(0), root{} {}
+
+  /**
+   *  Opens an image; the bytes must outlive the view.
+   *  @param data the bytes of the page file
+   *  @param size their number
+   *  @return false if the image is malformed or truncated
+   */
+  bool open(const uint8_t *data, size_t size);
+
+  /**
+   *  Returns a page, or nullptr if it is past the end of the image.
+   */
+  const uint8_t *fetch(uint32_t page) const;
+
+  /**
+   *  Pages are never evicted, so nothing is pinned.
+   */
+  void unpin(uint32_t) const {}
+
+  bool isOpen() const { return data != nullptr; }
+  const PageEntry2D &getRoot() const { return root; }
+  hash_t getHash() const { return root.hash; }
+  uint32_t getPageSize() const { return page_size; }
+  uint64_t countPages() const { return n_pages; }
+  uint64_t size() const { return n_points; }
+  uint32_t getHeight() const { return height; }
+};
+
+/**
+ *  Performs a 2D range query on a paged MR-tree. The verification object is
+ *  the same as range_query_2d on the in-memory tree.
+ *  @param tree the paged tree
+ *  @param query the query rectangle
+ *  @param stats optional statistics collector
+ *  @return the verification object, or nullptr on I/O error or if the
+ *          buffer pool has fewer frames than the height of the tree
+ */
+VObject2D *range_query_paged_2d(PagedTree2D &tree, const Rectangle &query,
+                                QueryStats2D *stats = nullptr);
+
+/**
+ *  Performs a 2D range query on a page file image. The verification object
+ *  is the same as range_query_2d on the in-memory tree.
+ *  @param image the page file image
+ *  @param query the query rectangle
+ *  @param stats optional statistics collector
+ *  @return the verification object, or nullptr if the image is not open or malformed
+ */
+VObject2D *range_query_paged_2d(const PageImage2D &image, const Rectangle &query,
+                                QueryStats2D *stats = nullptr);
+
+#endif
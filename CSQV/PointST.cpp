@@ -0,0 +1,113 @@
+/**
+ *  @file PointST.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "PointST.hpp"
+#include "csv.hpp"
+#include <cstdio>
+#include <iostream>
+
+/**
+ *  Parses an English month name.
+ */
+int parse_month(const std::string &name) {
+  static const char *MONTHS[12] = {
+    "January", "February", "March", "April", "May", "June", "July",
+    "August", "September", "October", "November", "December"
+  };
+  for (int m = 0; m < 12; m++) {
+    if (name == MONTHS[m]) return m + 1;
+  }
+  return 0;
+}
+
+/**
+ *  Parses a time of day in 12-hour format ("hh:mm am" or "hh:mm pm").
+ */
+int parse_time_of_day(const std::string &s) {
+  int hour, minute;
+  char suffix[3] = {0};
+  if (sscanf(s.c_str(), "%d:%d %2s", &hour, &minute, suffix) != 3) return -1;
+  if (hour < 1 || hour > 12 || minute < 0 || minute > 59) return -1;
+  hour %= 12;
+  if (suffix[0] == 'p' || suffix[0] == 'P') hour += 12;
+  return hour * 60 + minute;
+}
+
+/**
+ *  Parses a CSV file of crashes into spatio-temporal points.
+ *  Rows with an unknown month or malformed time are skipped.
+ */
+std::vector<PointST> load_st_points_file(const std::string &path) {
+  std::vector<PointST> points;
+  size_t skipped = 0;
+
+  try {
+    csv::CSVReader reader(path);
+    uint32_t id = 0;
+
+    for (csv::CSVRow& row : reader) {
+      int year = row["Year"].get<int>();
+      int month = parse_month(row["Month"].get<std::string>());
+      int minute = parse_time_of_day(row["Time"].get<std::string>());
+      if (month == 0 || minute < 0) {
+        skipped++;
+        continue;
+      }
+
+      PointST p;
+      p.id = id++;
+      p.c = {{row["x"].get<int32_t>(), row["y"].get<int32_t>(),
+              st_time_key(year, month, minute)}};
+      points.push_back(p);
+    }
+
+    std::cout << "Loaded " << points.size() << " spatio-temporal points from "
+              << path << std::endl;
+    if (skipped) {
+      std::cout << "Skipped " << skipped << " rows with malformed date/time" << std::endl;
+    }
+
+  } catch (const std::exception& e) {
+    std::cerr << "Error loading points file: " << e.what() << std::endl;
+  }
+
+  return points;
+}
+
+/**
+ *  Loads cuboid queries from CSV file.
+ */
+std::vector<Cuboid> load_st_queries(const std::string &path) {
+  std::vector<Cuboid> queries;
+
+  try {
+    csv::CSVReader reader(path);
+
+    for (csv::CSVRow& row : reader) {
+      Cuboid q;
+      q.lo = {{row[0].get<int32_t>(), row[1].get<int32_t>(), row[2].get<int32_t>()}};
+      q.hi = {{row[3].get<int32_t>(), row[4].get<int32_t>(), row[5].get<int32_t>()}};
+      queries.push_back(q);
+    }
+
+    std::cout << "Loaded " << queries.size() << " queries from " << path << std::endl;
+
+  } catch (const std::exception& e) {
+    std::cerr << "Error loading queries: " << e.what() << std::endl;
+  }
+
+  return queries;
+}
+
+/**
+ *  Counts the number of points inside a cuboid by brute force.
+ */
+size_t count_in_cuboid(const std::vector<PointST> &points, const Cuboid &q) {
+  size_t count = 0;
+  for (const PointST &p : points) {
+    if (q.contains(p)) count++;
+  }
+  return count;
+}
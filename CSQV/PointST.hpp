@@ -0,0 +1,116 @@
+/**
+ *  @file PointST.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Spatio-temporal points (x, y, time) indexed by a 3D MR-tree
+ */
+
+#ifndef POINTST_H
+#define POINTST_H
+
+#include "MRTree.hpp"
+#include <string>
+#include <vector>
+
+/**
+ *  A spatio-temporal point: c[0] = x, c[1] = y, c[2] = time key.
+ */
+typedef MRPoint<3, int32_t> PointST;
+
+/**
+ *  A cuboid query: a rectangle in space combined with a time interval.
+ */
+typedef MRBox<3, int32_t> Cuboid;
+
+/**
+ *  The spatio-temporal MR-tree, sorted on 3D Morton keys.
+ */
+template<size_t Cap>
+using MRTreeST = MRTree<3, int32_t, Cap, Cap, MortonCurve<3>, Sha256Hash>;
+
+/**
+ *  Number of time units (minutes) in a month slot of the time axis.
+ */
+#define ST_MINUTES_PER_MONTH 1440
+
+/**
+ *  First year of the time axis.
+ */
+#define ST_BASE_YEAR 1970
+
+/**
+ *  Computes the time key of an event.
+ *  The crash data only records year, month, weekday and time of day,
+ *  so the time axis is month-major: each month is a slot of 1440 minutes
+ *  and the minute of the day is the offset within the slot.
+ *  @param year the year
+ *  @param month the month (1-12)
+ *  @param minute minute of the day (0-1439)
+ *  @return the time key
+ */
+static inline int32_t st_time_key(int year, int month, int minute) {
+  return ((year - ST_BASE_YEAR) * 12 + (month - 1)) * ST_MINUTES_PER_MONTH + minute;
+}
+
+/**
+ *  Builds a cuboid covering a spatial rectangle over a range of months.
+ *  @param r the spatial rectangle
+ *  @param from_year first year
+ *  @param from_month first month (1-12)
+ *  @param to_year last year
+ *  @param to_month last month (1-12), included
+ *  @return the cuboid query
+ */
+static inline Cuboid st_cuboid(const Rectangle &r, int from_year, int from_month,
+                               int to_year, int to_month) {
+  return Cuboid{{{r.lx, r.ly, st_time_key(from_year, from_month, 0)}},
+                {{r.ux, r.uy, st_time_key(to_year, to_month, ST_MINUTES_PER_MONTH - 1)}}};
+}
+
+/**
+ *  Returns the spatial part of a cuboid.
+ */
+static inline Rectangle st_rect(const Cuboid &c) {
+  return Rectangle{c.lo[0], c.lo[1], c.hi[0], c.hi[1]};
+}
+
+/**
+ *  Parses an English month name (e.g. "December").
+ *  @param name the month name
+ *  @return the month (1-12), or 0 if the name is not recognized
+ */
+int parse_month(const std::string &name);
+
+/**
+ *  Parses a time of day in 12-hour format (e.g. "03:30 pm").
+ *  @param s the time string
+ *  @return the minute of the day (0-1439), or -1 on malformed input
+ */
+int parse_time_of_day(const std::string &s);
+
+/**
+ *  Parses a CSV file of crashes into spatio-temporal points.
+ *  Expected format: ID,Year,Month,Day,Time,x,y (columns are looked up
+ *  by name). Generates sequential IDs for points.
+ *  @param path full path of the input file
+ *  @return a list of spatio-temporal points
+ */
+std::vector<PointST> load_st_points_file(const std::string &path);
+
+/**
+ *  Loads cuboid queries from a CSV file.
+ *  Expected format: lx,ly,lt,ux,uy,ut
+ *  @param path path to the query file
+ *  @return vector of cuboid queries
+ */
+std::vector<Cuboid> load_st_queries(const std::string &path);
+
+/**
+ *  Counts the number of points inside a cuboid by brute force.
+ *  @param points list of spatio-temporal points
+ *  @param q the query cuboid
+ *  @return the number of points inside the cuboid
+ */
+size_t count_in_cuboid(const std::vector<PointST> &points, const Cuboid &q);
+
+#endif
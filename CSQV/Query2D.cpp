@@ -7,6 +7,7 @@
 #include "Query2D.hpp"
 #include "csv.hpp"
 #include <chrono>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <random>
@@ -40,10 +41,344 @@ size_t count_points_2d(VObject2D *vo) {
 }
 
 /**
- *  Performs a 2D range query on the MR-tree.
+ *  Wire tag of leaves carrying payload digests or projected records.
+ *  The other tags are the values of VObject2DType.
  */
-VObject2D *range_query_2d(Node2D *root, const struct Rectangle &query, 
-                          QueryStats2D *stats) {
+#define V2D_WIRE_PAYLOAD_LEAF 3
+
+/**
+ *  Returns the size in bytes of the wire encoding of a verification object.
+ */
+size_t vo_size_2d(VObject2D *vo) {
+  if (!vo) return 0;
+  
+  switch (vo->getType()) {
+    case V2D_LEAF: {
+      VLeaf2D *leaf = static_cast<VLeaf2D*>(vo);
+      size_t size = sizeof(uint8_t) + sizeof(uint32_t) +
+                    leaf->getSize() * (sizeof(uint32_t) + 2 * sizeof(int32_t));
+      if (!leaf->hasPayload()) return size;
+      size += sizeof(ColumnMask) + 2 * sizeof(uint32_t) +
+              leaf->getDigests().size() * SHA256_DIGEST_LENGTH;
+      for (const ProjectedRecord &r : leaf->getRecords()) {
+        size += 3 * sizeof(uint32_t) + r.digests.size() * SHA256_DIGEST_LENGTH;
+        for (const std::string &v : r.values) size += sizeof(uint32_t) + v.size();
+      }
+      return size;
+    }
+      
+    case V2D_PRUNED:
+      return sizeof(uint8_t) + 4 * sizeof(int32_t) + SHA256_DIGEST_LENGTH;
+      
+    case V2D_CONTAINER: {
+      VContainer2D *container = static_cast<VContainer2D*>(vo);
+      size_t total = sizeof(uint8_t) + sizeof(uint32_t);
+      for (size_t i = 0; i < container->size(); i++) {
+        total += vo_size_2d(container->get(i));
+      }
+      return total;
+    }
+  }
+  
+  return 0;
+}
+
+/**
+ *  Appends the raw bytes of a value to a byte vector.
+ */
+template <typename T>
+static inline void put_raw(std::vector<uint8_t> &out, const T &x) {
+  const uint8_t *ptr = reinterpret_cast<const uint8_t*>(&x);
+  out.insert(out.end(), ptr, ptr + sizeof(T));
+}
+
+/**
+ *  Serializes a verification object.
+ */
+void serialize_vo_2d(VObject2D *vo, std::vector<uint8_t> &out) {
+  if (!vo) return;
+  
+  switch (vo->getType()) {
+    case V2D_LEAF: {
+      VLeaf2D *leaf = static_cast<VLeaf2D*>(vo);
+      put_raw(out, static_cast<uint8_t>(leaf->hasPayload() ? V2D_WIRE_PAYLOAD_LEAF : V2D_LEAF));
+      put_raw(out, static_cast<uint32_t>(leaf->getSize()));
+      for (const Point2D &p : leaf->getPoints()) {
+        put_raw(out, p.id);
+        put_raw(out, p.loc.x);
+        put_raw(out, p.loc.y);
+      }
+      if (!leaf->hasPayload()) return;
+      put_raw(out, leaf->getMask());
+      put_raw(out, static_cast<uint32_t>(leaf->getDigests().size()));
+      for (const hash_t &d : leaf->getDigests()) out.insert(out.end(), d.begin(), d.end());
+      put_raw(out, static_cast<uint32_t>(leaf->getRecords().size()));
+      for (const ProjectedRecord &r : leaf->getRecords()) {
+        put_raw(out, r.id);
+        put_raw(out, static_cast<uint32_t>(r.values.size()));
+        for (const std::string &v : r.values) {
+          put_raw(out, static_cast<uint32_t>(v.size()));
+          out.insert(out.end(), v.begin(), v.end());
+        }
+        put_raw(out, static_cast<uint32_t>(r.digests.size()));
+        for (const hash_t &d : r.digests) out.insert(out.end(), d.begin(), d.end());
+      }
+      return;
+    }
+      
+    case V2D_PRUNED: {
+      VPruned2D *pruned = static_cast<VPruned2D*>(vo);
+      Rectangle r = pruned->getRect();
+      hash_t h = pruned->getHash();
+      put_raw(out, static_cast<uint8_t>(V2D_PRUNED));
+      put_raw(out, r.lx);
+      put_raw(out, r.ly);
+      put_raw(out, r.ux);
+      put_raw(out, r.uy);
+      out.insert(out.end(), h.begin(), h.end());
+      return;
+    }
+      
+    case V2D_CONTAINER: {
+      VContainer2D *container = static_cast<VContainer2D*>(vo);
+      put_raw(out, static_cast<uint8_t>(V2D_CONTAINER));
+      put_raw(out, static_cast<uint32_t>(container->size()));
+      for (size_t i = 0; i < container->size(); i++) {
+        serialize_vo_2d(container->get(i), out);
+      }
+      return;
+    }
+  }
+}
+
+/**
+ *  Serializes a verification object.
+ */
+std::vector<uint8_t> serialize_vo_2d(VObject2D *vo) {
+  std::vector<uint8_t> out;
+  out.reserve(vo_size_2d(vo));
+  serialize_vo_2d(vo, out);
+  return out;
+}
+
+/**
+ *  Bounds-checked reader over a serialized verification object.
+ */
+struct VOReader2D {
+  const uint8_t *data;
+  size_t size;
+  size_t pos;
+  
+  template <typename T>
+  bool get(T &x) {
+    if (size - pos < sizeof(T)) return false;
+    std::memcpy(&x, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+  
+  bool get_hash(hash_t &h) {
+    if (size - pos < h.size()) return false;
+    std::memcpy(h.data(), data + pos, h.size());
+    pos += h.size();
+    return true;
+  }
+  
+  bool get_string(std::string &s, uint32_t len) {
+    if (size - pos < len) return false;
+    s.assign(reinterpret_cast<const char*>(data + pos), len);
+    pos += len;
+    return true;
+  }
+  
+  /** True if n items of at least `bytes` bytes each can still be read. */
+  bool fits(uint64_t n, size_t bytes) const { return n <= (size - pos) / bytes; }
+};
+
+/**
+ *  Recursive step of the deserialization.
+ *  @param depth the number of containers enclosing the object
+ */
+static VObject2D *deserialize_vo_2d(VOReader2D &in, uint32_t depth) {
+  uint8_t tag;
+  if (!in.get(tag)) return nullptr;
+  
+  switch (tag) {
+    case V2D_LEAF:
+    case V2D_WIRE_PAYLOAD_LEAF: {
+      uint32_t n;
+      if (!in.get(n) || !in.fits(n, sizeof(uint32_t) + 2 * sizeof(int32_t))) return nullptr;
+      std::vector<Point2D> points(n);
+      for (Point2D &p : points) {
+        if (!in.get(p.id) || !in.get(p.loc.x) || !in.get(p.loc.y)) return nullptr;
+      }
+      if (tag == V2D_LEAF) return new VLeaf2D(points);
+      
+      ColumnMask mask;
+      uint32_t nd, nr;
+      if (!in.get(mask) || !in.get(nd) || !in.fits(nd, SHA256_DIGEST_LENGTH)) return nullptr;
+      std::vector<hash_t> digests(nd);
+      for (hash_t &d : digests) {
+        if (!in.get_hash(d)) return nullptr;
+      }
+      if (!in.get(nr) || !in.fits(nr, 3 * sizeof(uint32_t))) return nullptr;
+      std::vector<ProjectedRecord> records(nr);
+      for (ProjectedRecord &r : records) {
+        uint32_t nv, len, nrd;
+        r.mask = mask;
+        if (!in.get(r.id) || !in.get(nv) || !in.fits(nv, sizeof(uint32_t))) return nullptr;
+        r.values.resize(nv);
+        for (std::string &v : r.values) {
+          if (!in.get(len) || !in.get_string(v, len)) return nullptr;
+        }
+        if (!in.get(nrd) || !in.fits(nrd, SHA256_DIGEST_LENGTH)) return nullptr;
+        r.digests.resize(nrd);
+        for (hash_t &d : r.digests) {
+          if (!in.get_hash(d)) return nullptr;
+        }
+      }
+      return new VLeaf2D(points, std::move(digests), mask, std::move(records));
+    }
+      
+    case V2D_PRUNED: {
+      Rectangle r;
+      hash_t h;
+      if (!in.get(r.lx) || !in.get(r.ly) || !in.get(r.ux) || !in.get(r.uy) ||
+          !in.get_hash(h)) return nullptr;
+      return new VPruned2D(r, h);
+    }
+      
+    case V2D_CONTAINER: {
+      uint32_t n;
+      if (depth >= V2D_MAX_DEPTH || !in.get(n) || !in.fits(n, sizeof(uint8_t))) return nullptr;
+      VContainer2D *container = new VContainer2D();
+      for (uint32_t i = 0; i < n; i++) {
+        VObject2D *child = deserialize_vo_2d(in, depth + 1);
+        if (!child) {
+          delete_vo_2d(container);
+          return nullptr;
+        }
+        container->append(child);
+      }
+      return container;
+    }
+  }
+  
+  return nullptr;
+}
+
+/**
+ *  Deserializes a verification object.
+ */
+VObject2D *deserialize_vo_2d(const uint8_t *data, size_t size) {
+  VOReader2D in{data, size, 0};
+  VObject2D *vo = deserialize_vo_2d(in, 0);
+  if (vo && in.pos != size) {
+    delete_vo_2d(vo);
+    return nullptr;
+  }
+  return vo;
+}
+
+/**
+ *  Deserializes a verification object at the start of a byte sequence.
+ */
+VObject2D *deserialize_vo_2d(const uint8_t *data, size_t size, size_t &used) {
+  VOReader2D in{data, size, 0};
+  VObject2D *vo = deserialize_vo_2d(in, 0);
+  used = vo ? in.pos : 0;
+  return vo;
+}
+
+/**
+ *  Creates the verification object of a leaf. Payload digests are shipped
+ *  for all points, except matching points when a projection is requested.
+ */
+static VLeaf2D *make_vleaf_2d(LeafNode2D *leaf, const struct Rectangle &query,
+                              const AttributeStore *attrs, ColumnMask mask) {
+  if (!leaf->hasPayload()) return new VLeaf2D(leaf->getPoints());
+  if (!attrs) mask = 0;
+  
+  const std::vector<Point2D> &points = leaf->getPoints();
+  std::vector<hash_t> digests;
+  std::vector<ProjectedRecord> records;
+  for (size_t i = 0; i < points.size(); i++) {
+    if (mask && contains(points[i], query)) {
+      records.push_back(project_record(*attrs, points[i].id, mask));
+    } else {
+      digests.push_back(leaf->getDigests()[i]);
+    }
+  }
+  return new VLeaf2D(points, std::move(digests), mask, std::move(records));
+}
+
+/**
+ *  Ships a whole leaf in a verification object.
+ */
+VLeaf2D *ship_leaf_2d(LeafNode2D *leaf) {
+  return leaf->hasPayload()
+       ? new VLeaf2D(leaf->getPoints(), leaf->getDigests(), 0, std::vector<ProjectedRecord>())
+       : new VLeaf2D(leaf->getPoints());
+}
+
+/**
+ *  Emits a whole subtree: all nodes are opened and all leaves shipped.
+ */
+static VObject2D *emit_subtree_2d(Node2D *root, const struct Rectangle &query,
+                                  QueryStats2D *stats) {
+  if (stats) stats->nodes_visited++;
+  
+  if (root->getType() == N2D_LEAF) {
+    LeafNode2D *leaf = static_cast<LeafNode2D*>(root);
+    if (stats) stats->points_examined += leaf->size();
+    return make_vleaf_2d(leaf, query, nullptr, 0);
+  }
+  
+  VContainer2D *container = new VContainer2D();
+  for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+    container->append(emit_subtree_2d(child, query, stats));
+  }
+  return container;
+}
+
+/**
+ *  Recursive step of the 2D range query, with bulk emission of contained subtrees.
+ */
+static VObject2D *range_query_bulk_2d_rec(Node2D *root, const struct Rectangle &query,
+                                          QueryStats2D *stats) {
+  struct Rectangle node_rect = root->getRect();
+  if (root->getType() == N2D_LEAF || contains(query, node_rect)) {
+    return emit_subtree_2d(root, query, stats);
+  }
+  
+  if (stats) stats->nodes_visited++;
+  if (!overlap(node_rect, query)) {
+    if (stats) stats->nodes_pruned++;
+    return new VPruned2D(node_rect, root->getHash());
+  }
+  
+  VContainer2D *container = new VContainer2D();
+  for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+    container->append(range_query_bulk_2d_rec(child, query, stats));
+  }
+  return container;
+}
+
+/**
+ *  Performs a 2D range query with bulk emission of contained subtrees.
+ */
+VObject2D *range_query_bulk_2d(Node2D *root, const struct Rectangle &query,
+                               QueryStats2D *stats) {
+  if (!root) return nullptr;
+  return range_query_bulk_2d_rec(root, query, stats);
+}
+
+/**
+ *  Recursive step of the 2D range query, with optional projection.
+ */
+static VObject2D *range_query_2d(Node2D *root, const struct Rectangle &query,
+                                 const AttributeStore *attrs, ColumnMask mask,
+                                 QueryStats2D *stats) {
   if (!root) return nullptr;
   
   if (stats) stats->nodes_visited++;
@@ -52,13 +387,14 @@ VObject2D *range_query_2d(Node2D *root, const struct Rectangle &query,
   if (root->getType() == N2D_LEAF) {
     LeafNode2D *leaf = static_cast<LeafNode2D*>(root);
     if (stats) stats->points_examined += leaf->size();
-    return new VLeaf2D(leaf->getPoints());
+    return make_vleaf_2d(leaf, query, attrs, mask);
   }
   
-  // For internal nodes, check if MBR intersects with query
+  // For internal nodes, check if MBR overlaps the query (closed test, so
+  // that subtrees holding points on the query border are opened)
   struct Rectangle node_rect = root->getRect();
-  if (!intersect(node_rect, query)) {
-    // No intersection - prune this subtree
+  if (!overlap(node_rect, query)) {
+    // No overlap - prune this subtree
     if (stats) stats->nodes_pruned++;
     return new VPruned2D(node_rect, root->getHash());
   }
@@ -68,7 +404,7 @@ VObject2D *range_query_2d(Node2D *root, const struct Rectangle &query,
   IntNode2D *internal = static_cast<IntNode2D*>(root);
   
   for (Node2D *child : internal->getChildren()) {
-    VObject2D *child_vo = range_query_2d(child, query, stats);
+    VObject2D *child_vo = range_query_2d(child, query, attrs, mask, stats);
     container->append(child_vo);
   }
   
@@ -76,35 +412,158 @@ VObject2D *range_query_2d(Node2D *root, const struct Rectangle &query,
 }
 
 /**
- *  Verifies a 2D range query result.
+ *  Performs a 2D range query on the MR-tree.
  */
-VResult2D *verify_2d(VObject2D *vo, const struct Rectangle &query,
-                     QueryStats2D *stats) {
+VObject2D *range_query_2d(Node2D *root, const struct Rectangle &query, 
+                          QueryStats2D *stats) {
+  return range_query_2d(root, query, nullptr, 0, stats);
+}
+
+/**
+ *  Recursive step of the unauthenticated range query. Emit is called on
+ *  whole leaves inside the query and on single matching points otherwise.
+ */
+template <typename Emit>
+static void range_query_fast_2d(Node2D *root, const struct Rectangle &query,
+                                bool inside, Emit &emit, QueryStats2D *stats) {
+  if (stats) stats->nodes_visited++;
+  inside = inside || contains(query, root->getRect());
+  
+  if (root->getType() == N2D_LEAF) {
+    const std::vector<Point2D> &points = static_cast<LeafNode2D*>(root)->getPoints();
+    if (stats) stats->points_examined += points.size();
+    if (inside) {
+      emit(points.data(), points.size());
+    } else {
+      for (const Point2D &p : points) {
+        if (contains(p, query)) emit(&p, 1);
+      }
+    }
+    return;
+  }
+  
+  for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+    if (inside || overlap(child->getRect(), query)) {
+      range_query_fast_2d(child, query, inside, emit, stats);
+    } else if (stats) {
+      stats->nodes_pruned++;
+    }
+  }
+}
+
+/**
+ *  Performs a 2D range query without authentication into a vector.
+ */
+size_t range_query_fast_2d(Node2D *root, const struct Rectangle &query,
+                           std::vector<Point2D> &out, QueryStats2D *stats) {
+  size_t before = out.size();
+  if (!root || !overlap(root->getRect(), query)) return 0;
+  auto emit = [&out](const Point2D *p, size_t n) { out.insert(out.end(), p, p + n); };
+  range_query_fast_2d(root, query, false, emit, stats);
+  if (stats) stats->points_returned += out.size() - before;
+  return out.size() - before;
+}
+
+/**
+ *  Performs a 2D range query without authentication with a callback.
+ */
+size_t range_query_fast_2d(Node2D *root, const struct Rectangle &query,
+                           const std::function<void(const Point2D &)> &fn,
+                           QueryStats2D *stats) {
+  size_t count = 0;
+  if (!root || !overlap(root->getRect(), query)) return 0;
+  auto emit = [&fn, &count](const Point2D *p, size_t n) {
+    for (size_t i = 0; i < n; i++) fn(p[i]);
+    count += n;
+  };
+  range_query_fast_2d(root, query, false, emit, stats);
+  if (stats) stats->points_returned += count;
+  return count;
+}
+
+/**
+ *  Performs a 2D range query with attribute projection.
+ */
+VObject2D *range_query_projected_2d(Node2D *root, const struct Rectangle &query,
+                                    const AttributeStore &attrs, ColumnMask mask,
+                                    QueryStats2D *stats) {
+  return range_query_2d(root, query, &attrs, mask, stats);
+}
+
+/**
+ *  Encodings hashed during a verification, with their digests.
+ */
+typedef std::vector<std::pair<std::vector<uint8_t>, hash_t>> PendingDigests2D;
+
+/**
+ *  Computes the digest of an encoded leaf or node, looking it up in the
+ *  cache first; digests computed are staged in pending.
+ */
+static hash_t digest_2d(const Buffer &buf, DigestCache2D *cache, PendingDigests2D *pending) {
+  if (!cache) return sha256(buf);
+  hash_t digest;
+  if (cache->lookup(buf.data(), buf.size(), digest)) return digest;
+  digest = sha256(buf);
+  pending->emplace_back(std::vector<uint8_t>(buf.data(), buf.data() + buf.size()), digest);
+  return digest;
+}
+
+/**
+ *  Recursive step of the verification, with an optional digest cache.
+ *  If mask is given, leaves must carry exactly the requested columns.
+ */
+static VResult2D *verify_2d(VObject2D *vo, const struct Rectangle &query,
+                            QueryStats2D *stats, DigestCache2D *cache,
+                            PendingDigests2D *pending, const ColumnMask *mask) {
   if (!vo) return nullptr;
   
   switch (vo->getType()) {
     case V2D_LEAF: {
       // Reconstruct leaf node
       VLeaf2D *leaf = static_cast<VLeaf2D*>(vo);
+      if (mask && leaf->getMask() != *mask) return nullptr;
       const std::vector<Point2D> &all_points = leaf->getPoints();
       
       // Filter points that match the query
       std::vector<Point2D> matching_points;
+      std::vector<ProjectedRecord> matching_records;
       struct Rectangle leaf_mbr = EMPTY_RECT;
-      Buffer buf(all_points.size() * (sizeof(uint32_t) + 2 * sizeof(int32_t)));
+      bool payload = leaf->hasPayload();
+      Buffer buf(all_points.size() * (sizeof(uint32_t) + 2 * sizeof(int32_t) +
+                                      (payload ? SHA256_DIGEST_LENGTH : 0)));
+      size_t next_digest = 0, next_record = 0;
       
       for (const Point2D &p : all_points) {
+        bool match = contains(p, query);
         leaf_mbr = enlarge(leaf_mbr, p.loc);
-        put_point2d(buf, p);
         
-        if (contains(p, query)) {
+        if (!payload) {
+          put_point2d(buf, p);
+        } else {
+          // Missing digests or records leave a zero digest, so the root won't match.
+          hash_t digest{};
+          if (match && leaf->getMask()) {
+            if (next_record < leaf->getRecords().size()) {
+              ProjectedRecord rec = leaf->getRecords()[next_record++];
+              rec.id = p.id;
+              digest = projected_digest(rec);
+              matching_records.push_back(std::move(rec));
+            }
+          } else if (next_digest < leaf->getDigests().size()) {
+            digest = leaf->getDigests()[next_digest++];
+          }
+          put_point2d(buf, p, digest);
+        }
+        
+        if (match) {
           matching_points.push_back(p);
           if (stats) stats->points_returned++;
         }
       }
       
-      hash_t leaf_hash = sha256(buf);
-      return new VResult2D(leaf_mbr, leaf_hash, std::move(matching_points));
+      hash_t leaf_hash = digest_2d(buf, cache, pending);
+      return new VResult2D(leaf_mbr, leaf_hash, std::move(matching_points),
+                           std::move(matching_records));
     }
     
     case V2D_PRUNED: {
@@ -118,16 +577,21 @@ VResult2D *verify_2d(VObject2D *vo, const struct Rectangle &query,
       // Reconstruct internal node
       VContainer2D *container = static_cast<VContainer2D*>(vo);
       std::vector<Point2D> all_matching_points;
+      std::vector<ProjectedRecord> all_matching_records;
       struct Rectangle combined_mbr = EMPTY_RECT;
       Buffer buf(container->size() * (4*sizeof(int32_t) + SHA256_DIGEST_LENGTH));
       
       for (size_t i = 0; i < container->size(); i++) {
-        VResult2D *child_result = verify_2d(container->get(i), query, stats);
+        VResult2D *child_result = verify_2d(container->get(i), query, stats, cache, pending, mask);
+        if (!child_result) return nullptr;
         
         // Collect matching points
         const std::vector<Point2D> &child_points = child_result->getPoints();
         all_matching_points.insert(all_matching_points.end(),
                                   child_points.begin(), child_points.end());
+        const std::vector<ProjectedRecord> &child_records = child_result->getRecords();
+        all_matching_records.insert(all_matching_records.end(),
+                                    child_records.begin(), child_records.end());
         
         // Update combined MBR and hash buffer
         struct Rectangle child_rect = child_result->getRect();
@@ -141,15 +605,47 @@ VResult2D *verify_2d(VObject2D *vo, const struct Rectangle &query,
         delete child_result;
       }
       
-      hash_t combined_hash = sha256(buf);
+      hash_t combined_hash = digest_2d(buf, cache, pending);
       return new VResult2D(combined_mbr, combined_hash, 
-                          std::move(all_matching_points));
+                          std::move(all_matching_points),
+                          std::move(all_matching_records));
     }
   }
   
   return nullptr;
 }
 
+/**
+ *  Verifies a 2D range query result.
+ */
+VResult2D *verify_2d(VObject2D *vo, const struct Rectangle &query,
+                     QueryStats2D *stats) {
+  return verify_2d(vo, query, stats, nullptr, nullptr, nullptr);
+}
+
+/**
+ *  Verifies a projected 2D range query result against the requested columns.
+ */
+VResult2D *verify_projected_2d(VObject2D *vo, const struct Rectangle &query,
+                               ColumnMask mask, QueryStats2D *stats) {
+  return verify_2d(vo, query, stats, nullptr, nullptr, &mask);
+}
+
+/**
+ *  Verifies a 2D range query result with a digest cache. New digests are
+ *  only cached if the reconstructed root is the trusted one.
+ */
+VResult2D *verify_cached_2d(VObject2D *vo, const struct Rectangle &query,
+                            DigestCache2D &cache, const hash_t &root,
+                            QueryStats2D *stats) {
+  PendingDigests2D pending;
+  VResult2D *res = verify_2d(vo, query, stats, &cache, &pending, nullptr);
+  if (res && res->getHash() == root) {
+    for (const auto &p : pending) cache.insert(p.first.data(), p.first.size(), p.second);
+  }
+  return res;
+}
+
 /**
  *  Performs complete 2D range query with verification.
  */
@@ -214,6 +710,11 @@ void print_query_stats_2d(const QueryStats2D &stats) {
   std::cout << "  Query time: " << stats.query_time_us << " μs" << std::endl;
   std::cout << "  Verification time: " << stats.verify_time_us << " μs" << std::endl;
   std::cout << "  Total time: " << (stats.query_time_us + stats.verify_time_us) << " μs" << std::endl;
+  if (stats.estimated_results > 0) {
+    static const char *plans[] = {"tree", "bulk", "alternative index"};
+    std::cout << "  Estimated results: " << stats.estimated_results << std::endl;
+    std::cout << "  Plan: " << plans[stats.plan] << std::endl;
+  }
 }
 
 /**
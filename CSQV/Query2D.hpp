@@ -8,8 +8,10 @@
 #ifndef QUERY2D_H
 #define QUERY2D_H
 
+#include "DigestCache2D.hpp"
 #include "Node2D.hpp"
 #include "Point2D.hpp"
+#include <functional>
 
 /**
  *  Types of verification objects for 2D range queries.
@@ -35,13 +37,25 @@ public:
 class VLeaf2D : public VObject2D {
 private:
   std::vector<Point2D> points;
+  std::vector<hash_t> digests;          ///< Payload digests of the points not projected
+  ColumnMask mask;                      ///< Projected columns (0 = coordinates only)
+  std::vector<ProjectedRecord> records; ///< Projected records of the matching points
   
 public:
   VLeaf2D(const std::vector<Point2D> &points) 
-  : VObject2D(V2D_LEAF), points(points) {}
+  : VObject2D(V2D_LEAF), points(points), mask(0) {}
+
+  VLeaf2D(const std::vector<Point2D> &points, std::vector<hash_t> digests,
+          ColumnMask mask, std::vector<ProjectedRecord> records)
+  : VObject2D(V2D_LEAF), points(points), digests(std::move(digests)),
+    mask(mask), records(std::move(records)) {}
   
   const std::vector<Point2D> &getPoints() const { return points; }
   size_t getSize() const { return points.size(); }
+  const std::vector<hash_t> &getDigests() const { return digests; }
+  ColumnMask getMask() const { return mask; }
+  const std::vector<ProjectedRecord> &getRecords() const { return records; }
+  bool hasPayload() const { return !digests.empty() || mask != 0; }
 };
 
 /**
@@ -95,17 +109,26 @@ private:
   Rectangle rect;           ///< Reconstructed MBR
   hash_t hash;             ///< Reconstructed hash
   std::vector<Point2D> points; ///< Query result points
+  std::vector<ProjectedRecord> records; ///< Projected records of the result points
   
 public:
-  VResult2D(Rectangle r, hash_t h, std::vector<Point2D> points) 
-  : rect(r), hash(h), points(std::move(points)) {}
+  VResult2D(Rectangle r, hash_t h, std::vector<Point2D> points,
+            std::vector<ProjectedRecord> records = std::vector<ProjectedRecord>()) 
+  : rect(r), hash(h), points(std::move(points)), records(std::move(records)) {}
   
   Rectangle getRect() const { return rect; }
   hash_t getHash() const { return hash; }
   const std::vector<Point2D> &getPoints() const { return points; }
+  const std::vector<ProjectedRecord> &getRecords() const { return records; }
   size_t count() const { return points.size(); }
 };
 
+/**
+ *  Execution plans of a 2D range query: tree traversal, traversal with bulk
+ *  emission of subtrees contained in the query, or an alternative index.
+ */
+enum QueryPlan2D {QP2D_TREE, QP2D_BULK, QP2D_ALT};
+
 /**
  *  Query statistics for performance analysis.
  */
@@ -116,9 +139,12 @@ struct QueryStats2D {
   size_t points_returned;    ///< Points that match the query
   double query_time_us;      ///< Query execution time in microseconds
   double verify_time_us;     ///< Verification time in microseconds
+  double estimated_results;  ///< Result size estimated by the planner
+  QueryPlan2D plan;          ///< Plan chosen by the planner
   
   QueryStats2D() : nodes_visited(0), nodes_pruned(0), points_examined(0), 
-                   points_returned(0), query_time_us(0.0), verify_time_us(0.0) {}
+                   points_returned(0), query_time_us(0.0), verify_time_us(0.0),
+                   estimated_results(0.0), plan(QP2D_TREE) {}
 };
 
 /**
@@ -128,6 +154,54 @@ struct QueryStats2D {
  */
 size_t count_points_2d(VObject2D *vo);
 
+/**
+ *  Returns the size in bytes of the wire encoding of a verification object:
+ *  one type byte per object, leaf points and payloads, pruned MBRs and
+ *  digests, and child counts of containers.
+ *  @param vo a 2D verification object
+ *  @return the size in bytes
+ */
+size_t vo_size_2d(VObject2D *vo);
+
+/**
+ *  Appends the wire encoding of a verification object to a byte vector.
+ *  @param vo a 2D verification object
+ *  @param out the output bytes
+ */
+void serialize_vo_2d(VObject2D *vo, std::vector<uint8_t> &out);
+
+/**
+ *  Returns the wire encoding of a verification object.
+ *  @param vo a 2D verification object
+ *  @return the encoded bytes (vo_size_2d(vo) of them)
+ */
+std::vector<uint8_t> serialize_vo_2d(VObject2D *vo);
+
+/**
+ *  Maximum nesting of containers in a decoded verification object. An
+ *  MR-tree over 2^32 points is at most 33 levels deep, so deeper encodings
+ *  are malformed and are rejected before they exhaust the stack.
+ */
+#define V2D_MAX_DEPTH 64
+
+/**
+ *  Decodes a verification object.
+ *  @param data the encoded bytes
+ *  @param size the number of bytes
+ *  @return the verification object, or nullptr if the encoding is malformed
+ *          or nests containers deeper than V2D_MAX_DEPTH
+ */
+VObject2D *deserialize_vo_2d(const uint8_t *data, size_t size);
+
+/**
+ *  Decodes a verification object at the start of a byte sequence.
+ *  @param data the encoded bytes
+ *  @param size the number of bytes available
+ *  @param used receives the number of bytes decoded
+ *  @return the verification object, or nullptr if the encoding is malformed
+ */
+VObject2D *deserialize_vo_2d(const uint8_t *data, size_t size, size_t &used);
+
 /**
  *  Performs a 2D range query on the MR-tree.
  *  @param root the root of the 2D MR-tree
@@ -138,6 +212,60 @@ size_t count_points_2d(VObject2D *vo);
 VObject2D *range_query_2d(Node2D *root, const Rectangle &query, 
                           QueryStats2D *stats = nullptr);
 
+/**
+ *  Performs a 2D range query emitting the subtrees whose MBR lies inside the
+ *  query without testing their nodes, which pays off for large windows.
+ *  The verification object is verified with verify_2d.
+ *  @param root the root of the 2D MR-tree
+ *  @param query the query rectangle
+ *  @param stats optional statistics collector
+ *  @return verification object for the query
+ */
+VObject2D *range_query_bulk_2d(Node2D *root, const Rectangle &query,
+                               QueryStats2D *stats = nullptr);
+
+/**
+ *  Performs a 2D range query without authentication, for trusted consumers:
+ *  the points inside the query are appended to out, with no verification
+ *  object and no hashing. Subtrees inside the query are copied without
+ *  testing their points.
+ *  @param root the root of the 2D MR-tree
+ *  @param query the query rectangle
+ *  @param out the vector the matching points are appended to
+ *  @param stats optional statistics collector
+ *  @return the number of points appended
+ */
+size_t range_query_fast_2d(Node2D *root, const Rectangle &query,
+                           std::vector<Point2D> &out, QueryStats2D *stats = nullptr);
+
+/**
+ *  Performs a 2D range query without authentication, calling a function
+ *  on each point inside the query.
+ *  @param root the root of the 2D MR-tree
+ *  @param query the query rectangle
+ *  @param fn the function called on each matching point
+ *  @param stats optional statistics collector
+ *  @return the number of matching points
+ */
+size_t range_query_fast_2d(Node2D *root, const Rectangle &query,
+                           const std::function<void(const Point2D &)> &fn,
+                           QueryStats2D *stats = nullptr);
+
+/**
+ *  Performs a 2D range query returning a projection of the attributes
+ *  of the matching points. The tree must have been built with attrs.
+ *  Non-projected columns and non-matching points are replaced by digests.
+ *  @param root the root of the 2D MR-tree
+ *  @param query the query rectangle
+ *  @param attrs the attribute store the tree commits to
+ *  @param mask the projected columns (0 returns coordinates only)
+ *  @param stats optional statistics collector
+ *  @return verification object for the query
+ */
+VObject2D *range_query_projected_2d(Node2D *root, const Rectangle &query,
+                                    const AttributeStore &attrs, ColumnMask mask,
+                                    QueryStats2D *stats = nullptr);
+
 /**
  *  Verifies a 2D range query result and reconstructs the tree root.
  *  @param vo verification object from the query
@@ -148,6 +276,69 @@ VObject2D *range_query_2d(Node2D *root, const Rectangle &query,
 VResult2D *verify_2d(VObject2D *vo, const Rectangle &query,
                      QueryStats2D *stats = nullptr);
 
+/**
+ *  Verifies the result of range_query_projected_2d. Unlike verify_2d, every
+ *  leaf must carry exactly the requested columns, so a server cannot drop
+ *  columns from the projection.
+ *  @param vo verification object from the query
+ *  @param query the original query rectangle
+ *  @param mask the columns requested
+ *  @param stats optional statistics collector
+ *  @return verification result, or nullptr if the VO is malformed or a
+ *          leaf carries other columns than those requested
+ */
+VResult2D *verify_projected_2d(VObject2D *vo, const Rectangle &query,
+                               ColumnMask mask, QueryStats2D *stats = nullptr);
+
+/**
+ *  Verifies a 2D range query result, looking up the digests of shipped
+ *  leaves and opened nodes in a client-side cache before hashing them.
+ *  Digests computed are added to the cache only if the reconstructed root
+ *  equals the trusted one.
+ *  @param vo verification object from the query
+ *  @param query the original query rectangle
+ *  @param cache the digest cache
+ *  @param root the trusted root digest
+ *  @param stats optional statistics collector
+ *  @return verification result with reconstructed information
+ */
+VResult2D *verify_cached_2d(VObject2D *vo, const Rectangle &query,
+                            DigestCache2D &cache, const hash_t &root,
+                            QueryStats2D *stats = nullptr);
+
+/**
+ *  Ships a whole leaf in a verification object, with the digests of its
+ *  payloads if it has any, so that verifiers rebuild the leaf digest.
+ *  @param leaf the leaf to ship
+ *  @return a new VO leaf holding all points of the leaf
+ */
+VLeaf2D *ship_leaf_2d(LeafNode2D *leaf);
+
+/**
+ *  Rebuilds the MBR and digest of an internal node from the entries of a
+ *  VO container, encoded as make_internal_2d does.
+ *  @param container the VO container of the node
+ *  @param child called as child(i, rect, hash) for each entry i in turn;
+ *         verifies the entry and sets the MBR and digest of its subtree
+ *  @param rect receives the MBR of the node
+ *  @param hash receives the digest of the node
+ */
+template <typename Child>
+void verify_children_2d(VContainer2D *container, Child child, Rectangle &rect, hash_t &hash) {
+  Buffer buf(container->size() * (4 * sizeof(int32_t) + SHA256_DIGEST_LENGTH));
+  rect = EMPTY_RECT;
+  for (size_t i = 0; i < container->size(); i++) {
+    Rectangle child_rect;
+    hash_t child_hash;
+    child(i, child_rect, child_hash);
+    rect = enlarge(rect, child_rect);
+    buf.put(child_rect.lx).put(child_rect.ly)
+       .put(child_rect.ux).put(child_rect.uy)
+       .put_bytes(child_hash.data(), child_hash.size());
+  }
+  hash = sha256(buf);
+}
+
 /**
  *  Performs a complete 2D range query with verification.
  *  This is a convenience function that combines query and verification.
@@ -7,6 +7,7 @@
 
 #include "Point2D.hpp"
 #include "Query2D.hpp"
+#include "Scan2D.hpp"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -71,11 +72,13 @@ int main(int argc, char const *argv[]) {
   // Process each query and compute statistics
   std::cout << "Computing query statistics..." << std::endl;
   
+  // Count matching points of all queries in one vectorized pass
+  std::vector<size_t> counts = scan_count_many_2d(PointColumns2D(points), queries,
+                                                  SCAN2D_AUTO, 0);
+  
   for (size_t i = 0; i < queries.size(); i++) {
     const Rectangle &query = queries[i];
-    
-    // Count matching points
-    size_t matching = count_in_range(points, query);
+    size_t matching = counts[i];
     double fraction = (double)matching / points.size();
     
     // Write to file
@@ -101,8 +104,7 @@ int main(int argc, char const *argv[]) {
   size_t min_matching = SIZE_MAX;
   size_t max_matching = 0;
   
-  for (const Rectangle &query : queries) {
-    size_t matching = count_in_range(points, query);
+  for (size_t matching : counts) {
     total_matching += matching;
     min_matching = std::min(min_matching, matching);
     max_matching = std::max(max_matching, matching);
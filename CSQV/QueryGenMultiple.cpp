@@ -7,6 +7,7 @@
 
 #include "Point2D.hpp"
 #include "Query2D.hpp"
+#include "Scan2D.hpp"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -112,9 +113,13 @@ void write_query_file(const std::string &filename,
   size_t total_matching = 0;
   double total_area_selectivity = 0.0;
   
-  for (const Rectangle &query : queries) {
-    // Count matching points
-    size_t matching = count_in_range(points, query);
+  // Count matching points of all queries in one vectorized pass
+  std::vector<size_t> counts = scan_count_many_2d(PointColumns2D(points), queries,
+                                                  SCAN2D_AUTO, 0);
+  
+  for (size_t i = 0; i < queries.size(); i++) {
+    const Rectangle &query = queries[i];
+    size_t matching = counts[i];
     double point_fraction = (double)matching / points.size();
     
     // Calculate area-based selectivity
@@ -0,0 +1,133 @@
+/**
+ *  @file QueryServer.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Query server daemon: serves range, count and kNN queries with their
+ *  verification objects over a local socket, from a tree built in memory
+ *  or, for range queries, from a memory-mapped page file
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Heatmap2D.hpp"
+#include "PageFile2D.hpp"
+#include "Server2D.hpp"
+#include <iostream>
+#include <csignal>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static QueryServer2D *running = nullptr;
+
+static void handle_signal(int) {
+  if (running) running->stop();
+}
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <address> [threads]" << std::endl;
+  std::cout << "       " << program_name << " pages <page_file> <address> [threads]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  page_file: page file of a tree, mapped and served without loading it (range queries only)" << std::endl;
+  std::cout << "  address: unix:<path>, tcp:<port> (localhost) or tcp:<host>:<port>" << std::endl;
+  std::cout << "  threads: number of worker threads (default: 0 = all cores)" << std::endl;
+}
+
+/**
+ *  Maps a page file read-only, so its pages are read as queries touch them.
+ *  @return the mapped bytes, or nullptr on error
+ */
+static const uint8_t *map_page_file(const std::string &path, size_t &size) {
+#ifdef __linux__
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat st;
+  void *map = (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
+              ? mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+  if (fd >= 0) close(fd);
+  if (map != MAP_FAILED) {
+    size = st.st_size;
+    return static_cast<const uint8_t*>(map);
+  }
+#endif
+  std::cerr << "Error: cannot map page file " << path << std::endl;
+  return nullptr;
+}
+
+/**
+ *  Serves requests until a signal stops the server and prints its counters.
+ */
+static bool serve(QueryServer2D &server, size_t threads) {
+  running = &server;
+  std::signal(SIGINT, handle_signal);
+  std::signal(SIGTERM, handle_signal);
+  bool ok = server.run(threads);
+  running = nullptr;
+
+  const ServerStats2D &stats = server.getStats();
+  std::cout << "Connections: " << stats.connections << ", requests: " << stats.requests
+            << ", replies: " << stats.replies << std::endl;
+  std::cout << "Bytes in: " << stats.bytes_in << ", bytes out: " << stats.bytes_out
+            << ", reads paused at the in-flight limit: " << stats.paused << std::endl;
+  server.close();
+  return ok;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string address = argv[3];
+  size_t threads = (argc > 4) ? std::stoul(argv[4]) : 0;
+
+  if (std::string(argv[1]) == "pages") {
+    std::string page_file = argv[2];
+    size_t size = 0;
+    const uint8_t *data = map_page_file(page_file, size);
+    PageImage2D image;
+    if (data && !image.open(data, size)) {
+      std::cerr << "Error: malformed page file " << page_file << std::endl;
+    }
+    QueryServer2D server(image);
+    bool ok = image.isOpen() && server.listen(address);
+    if (ok) {
+      std::cout << "Serving " << image.size() << " points from " << page_file << " ("
+                << image.countPages() << " pages) on " << address << std::endl;
+      std::cout << "Root digest: " << toHex(image.getHash()) << std::endl;
+      ok = serve(server, threads);
+    }
+#ifdef __linux__
+    if (data) munmap(const_cast<uint8_t*>(data), size);
+#endif
+    return ok ? 0 : 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  Node2D *root = build_2d_tree(points, capacity);
+  CountTree2D counts(root);
+
+  QueryServer2D server(root, counts);
+  if (!server.listen(address)) {
+    delete_2d_tree(root);
+    return 1;
+  }
+
+  std::cout << "Serving " << points.size() << " points on " << address << std::endl;
+  std::cout << "Root digest: " << toHex(root->getHash()) << std::endl;
+  std::cout << "Count root digest: " << toHex(counts.getHash()) << std::endl;
+  bool ok = serve(server, threads);
+  delete_2d_tree(root);
+  return ok ? 0 : 1;
+}
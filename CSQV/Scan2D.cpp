@@ -0,0 +1,420 @@
+/**
+ *  @file Scan2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Scan2D.hpp"
+#include <algorithm>
+#include <thread>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN2D_X86
+#include <immintrin.h>
+#endif
+
+/**
+ *  Points per chunk when a scan is split among threads.
+ */
+#define SCAN2D_CHUNK 4096
+
+/**
+ *  Stores 2D points column by column.
+ */
+PointColumns2D::PointColumns2D(const std::vector<Point2D> &points) {
+  ids.reserve(points.size());
+  xs.reserve(points.size());
+  ys.reserve(points.size());
+  for (const Point2D &p : points) {
+    ids.push_back(p.id);
+    xs.push_back(p.loc.x);
+    ys.push_back(p.loc.y);
+  }
+}
+
+/**
+ *  Returns true if the CPU supports a kernel.
+ */
+bool scan_kernel_supported_2d(ScanKernel2D kernel) {
+  switch (kernel) {
+    case SCAN2D_AUTO:
+    case SCAN2D_SCALAR:
+      return true;
+#ifdef SCAN2D_X86
+    case SCAN2D_AVX2:
+      return __builtin_cpu_supports("avx2");
+    case SCAN2D_AVX512:
+      return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+      return false;
+  }
+}
+
+/**
+ *  Returns the fastest kernel supported by the CPU.
+ */
+ScanKernel2D best_scan_kernel_2d() {
+  static const ScanKernel2D best =
+    scan_kernel_supported_2d(SCAN2D_AVX512) ? SCAN2D_AVX512 :
+    scan_kernel_supported_2d(SCAN2D_AVX2) ? SCAN2D_AVX2 : SCAN2D_SCALAR;
+  return best;
+}
+
+/**
+ *  Returns the name of a kernel.
+ */
+const char *scan_kernel_name_2d(ScanKernel2D kernel) {
+  switch (kernel) {
+    case SCAN2D_AUTO: return "auto";
+    case SCAN2D_SCALAR: return "scalar";
+    case SCAN2D_AVX2: return "AVX2";
+    case SCAN2D_AVX512: return "AVX-512";
+  }
+  return "unknown";
+}
+
+/**
+ *  Resolves SCAN2D_AUTO and kernels the CPU does not support.
+ */
+static ScanKernel2D resolve_kernel(ScanKernel2D kernel) {
+  if (kernel == SCAN2D_AUTO || !scan_kernel_supported_2d(kernel)) return best_scan_kernel_2d();
+  return kernel;
+}
+
+/**
+ *  Returns the number of threads used to scan n points: 0 means one per
+ *  hardware thread, and every thread gets at least SCAN2D_CHUNK points.
+ */
+static size_t resolve_threads(size_t n, size_t threads) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  return std::max<size_t>(1, std::min(threads, (n + SCAN2D_CHUNK - 1) / SCAN2D_CHUNK));
+}
+
+/**
+ *  Splits [0, n) into one chunk per thread (multiples of SCAN2D_CHUNK)
+ *  and runs fn(begin, end, t) on each of them.
+ */
+template <typename Fn>
+static void parallel_chunks(size_t n, size_t threads, Fn fn) {
+  if (threads == 1) {
+    fn(0, n, 0);
+    return;
+  }
+  size_t per_thread = (n / SCAN2D_CHUNK + threads - 1) / threads * SCAN2D_CHUNK;
+  std::vector<std::thread> pool;
+  for (size_t t = 0; t < threads; t++) {
+    size_t begin = std::min(n, t * per_thread);
+    size_t end = (t + 1 == threads) ? n : std::min(n, begin + per_thread);
+    pool.emplace_back(fn, begin, end, t);
+  }
+  for (std::thread &th : pool) th.join();
+}
+
+/**
+ *  Returns 1 if point i is inside the rectangle, 0 otherwise, without branches.
+ */
+static inline size_t inside(const int32_t *xs, const int32_t *ys, size_t i, const Rectangle &q) {
+  return (q.lx <= xs[i]) & (xs[i] <= q.ux) & (q.ly <= ys[i]) & (ys[i] <= q.uy);
+}
+
+//
+// Scalar kernels
+//
+
+static size_t count_scalar(const int32_t *xs, const int32_t *ys, size_t begin, size_t end,
+                           const Rectangle &q) {
+  size_t count = 0;
+  for (size_t i = begin; i < end; i++) count += inside(xs, ys, i, q);
+  return count;
+}
+
+static void select_scalar(const int32_t *xs, const int32_t *ys, size_t begin, size_t end,
+                          const Rectangle &q, std::vector<uint32_t> &out) {
+  for (size_t i = begin; i < end; i++) {
+    if (inside(xs, ys, i, q)) out.push_back(i);
+  }
+}
+
+static void count_many_scalar(const int32_t *xs, const int32_t *ys, size_t begin, size_t end,
+                              const std::vector<Rectangle> &queries, size_t *counts) {
+  for (size_t i = begin; i < end; i++) {
+    for (size_t k = 0; k < queries.size(); k++) counts[k] += inside(xs, ys, i, queries[k]);
+  }
+}
+
+#ifdef SCAN2D_X86
+
+//
+// AVX2 kernels: 8 points, or 8 rectangles, per instruction
+//
+
+/**
+ *  Returns a mask with all bits set in the lanes whose point lies outside q.
+ */
+__attribute__((target("avx2")))
+static inline __m256i outside_avx2(__m256i x, __m256i y, __m256i lx, __m256i ly,
+                                   __m256i ux, __m256i uy) {
+  __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(lx, x), _mm256_cmpgt_epi32(x, ux));
+  return _mm256_or_si256(out, _mm256_or_si256(_mm256_cmpgt_epi32(ly, y),
+                                              _mm256_cmpgt_epi32(y, uy)));
+}
+
+__attribute__((target("avx2")))
+static size_t count_avx2(const int32_t *xs, const int32_t *ys, size_t begin, size_t end,
+                         const Rectangle &q) {
+  __m256i lx = _mm256_set1_epi32(q.lx), ly = _mm256_set1_epi32(q.ly);
+  __m256i ux = _mm256_set1_epi32(q.ux), uy = _mm256_set1_epi32(q.uy);
+  // Lanes of acc hold minus the number of points inside q.
+  __m256i acc = _mm256_setzero_si256();
+  __m256i all = _mm256_set1_epi32(-1);
+  size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys + i));
+    acc = _mm256_add_epi32(acc, _mm256_xor_si256(outside_avx2(x, y, lx, ly, ux, uy), all));
+  }
+  alignas(32) int32_t lanes[8];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  size_t count = 0;
+  for (int k = 0; k < 8; k++) count += static_cast<uint32_t>(-lanes[k]);
+  return count + count_scalar(xs, ys, i, end, q);
+}
+
+__attribute__((target("avx2")))
+static void select_avx2(const int32_t *xs, const int32_t *ys, size_t begin, size_t end,
+                        const Rectangle &q, std::vector<uint32_t> &out) {
+  __m256i lx = _mm256_set1_epi32(q.lx), ly = _mm256_set1_epi32(q.ly);
+  __m256i ux = _mm256_set1_epi32(q.ux), uy = _mm256_set1_epi32(q.uy);
+  size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys + i));
+    unsigned mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(outside_avx2(x, y, lx, ly, ux, uy))) & 0xFF;
+    while (mask) {
+      out.push_back(i + __builtin_ctz(mask));
+      mask &= mask - 1;
+    }
+  }
+  select_scalar(xs, ys, i, end, q, out);
+}
+
+__attribute__((target("avx2")))
+static void count_many_avx2(const int32_t *xs, const int32_t *ys, size_t begin, size_t end,
+                            const std::vector<Rectangle> &queries, size_t *counts) {
+  __m256i all = _mm256_set1_epi32(-1);
+  size_t k = 0;
+  for (; k + 8 <= queries.size(); k += 8) {
+    alignas(32) int32_t b[4][8];
+    for (int j = 0; j < 8; j++) {
+      b[0][j] = queries[k + j].lx; b[1][j] = queries[k + j].ly;
+      b[2][j] = queries[k + j].ux; b[3][j] = queries[k + j].uy;
+    }
+    __m256i lx = _mm256_load_si256(reinterpret_cast<const __m256i*>(b[0]));
+    __m256i ly = _mm256_load_si256(reinterpret_cast<const __m256i*>(b[1]));
+    __m256i ux = _mm256_load_si256(reinterpret_cast<const __m256i*>(b[2]));
+    __m256i uy = _mm256_load_si256(reinterpret_cast<const __m256i*>(b[3]));
+    // Each lane counts the points inside one rectangle; flushed before it can overflow.
+    for (size_t i = begin; i < end; ) {
+      size_t stop = std::min(end, i + (size_t(1) << 30));
+      __m256i acc = _mm256_setzero_si256();
+      for (; i < stop; i++) {
+        __m256i x = _mm256_set1_epi32(xs[i]), y = _mm256_set1_epi32(ys[i]);
+        acc = _mm256_sub_epi32(acc, _mm256_andnot_si256(outside_avx2(x, y, lx, ly, ux, uy), all));
+      }
+      alignas(32) uint32_t lanes[8];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+      for (int j = 0; j < 8; j++) counts[k + j] += lanes[j];
+    }
+  }
+  std::vector<Rectangle> rest(queries.begin() + k, queries.end());
+  count_many_scalar(xs, ys, begin, end, rest, counts + k);
+}
+
+//
+// AVX-512 kernels: 16 points, or 16 rectangles, per instruction
+//
+
+/**
+ *  Returns the mask of the lanes whose point lies inside q.
+ */
+__attribute__((target("avx512f")))
+static inline __mmask16 inside_avx512(__m512i x, __m512i y, __m512i lx, __m512i ly,
+                                      __m512i ux, __m512i uy) {
+  __mmask16 m = _mm512_cmpge_epi32_mask(x, lx);
+  m = _mm512_mask_cmple_epi32_mask(m, x, ux);
+  m = _mm512_mask_cmpge_epi32_mask(m, y, ly);
+  return _mm512_mask_cmple_epi32_mask(m, y, uy);
+}
+
+__attribute__((target("avx512f")))
+static size_t count_avx512(const int32_t *xs, const int32_t *ys, size_t begin, size_t end,
+                           const Rectangle &q) {
+  __m512i lx = _mm512_set1_epi32(q.lx), ly = _mm512_set1_epi32(q.ly);
+  __m512i ux = _mm512_set1_epi32(q.ux), uy = _mm512_set1_epi32(q.uy);
+  size_t count = 0;
+  size_t i = begin;
+  for (; i + 16 <= end; i += 16) {
+    __m512i x = _mm512_loadu_si512(xs + i);
+    __m512i y = _mm512_loadu_si512(ys + i);
+    count += __builtin_popcount(inside_avx512(x, y, lx, ly, ux, uy));
+  }
+  return count + count_scalar(xs, ys, i, end, q);
+}
+
+__attribute__((target("avx512f")))
+static void select_avx512(const int32_t *xs, const int32_t *ys, size_t begin, size_t end,
+                          const Rectangle &q, std::vector<uint32_t> &out) {
+  __m512i lx = _mm512_set1_epi32(q.lx), ly = _mm512_set1_epi32(q.ly);
+  __m512i ux = _mm512_set1_epi32(q.ux), uy = _mm512_set1_epi32(q.uy);
+  __m512i idx = _mm512_add_epi32(_mm512_set1_epi32(begin),
+    _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+  __m512i step = _mm512_set1_epi32(16);
+
+  // Matching positions are compressed directly into the output.
+  size_t base = out.size();
+  out.resize(base + (end - begin));
+  size_t n = 0;
+  size_t i = begin;
+  for (; i + 16 <= end; i += 16) {
+    __m512i x = _mm512_loadu_si512(xs + i);
+    __m512i y = _mm512_loadu_si512(ys + i);
+    __mmask16 m = inside_avx512(x, y, lx, ly, ux, uy);
+    _mm512_mask_compressstoreu_epi32(out.data() + base + n, m, idx);
+    n += __builtin_popcount(m);
+    idx = _mm512_add_epi32(idx, step);
+  }
+  out.resize(base + n);
+  select_scalar(xs, ys, i, end, q, out);
+}
+
+__attribute__((target("avx512f")))
+static void count_many_avx512(const int32_t *xs, const int32_t *ys, size_t begin, size_t end,
+                              const std::vector<Rectangle> &queries, size_t *counts) {
+  __m512i one = _mm512_set1_epi32(1);
+  size_t k = 0;
+  for (; k + 16 <= queries.size(); k += 16) {
+    alignas(64) int32_t b[4][16];
+    for (int j = 0; j < 16; j++) {
+      b[0][j] = queries[k + j].lx; b[1][j] = queries[k + j].ly;
+      b[2][j] = queries[k + j].ux; b[3][j] = queries[k + j].uy;
+    }
+    __m512i lx = _mm512_load_si512(b[0]), ly = _mm512_load_si512(b[1]);
+    __m512i ux = _mm512_load_si512(b[2]), uy = _mm512_load_si512(b[3]);
+    // Each lane counts the points inside one rectangle; flushed before it can overflow.
+    for (size_t i = begin; i < end; ) {
+      size_t stop = std::min(end, i + (size_t(1) << 30));
+      __m512i acc = _mm512_setzero_si512();
+      for (; i < stop; i++) {
+        __m512i x = _mm512_set1_epi32(xs[i]), y = _mm512_set1_epi32(ys[i]);
+        acc = _mm512_mask_add_epi32(acc, inside_avx512(x, y, lx, ly, ux, uy), acc, one);
+      }
+      alignas(64) uint32_t lanes[16];
+      _mm512_store_si512(lanes, acc);
+      for (int j = 0; j < 16; j++) counts[k + j] += lanes[j];
+    }
+  }
+  std::vector<Rectangle> rest(queries.begin() + k, queries.end());
+  count_many_scalar(xs, ys, begin, end, rest, counts + k);
+}
+
+#endif
+
+//
+// Dispatch
+//
+
+/**
+ *  Counts the points of [begin, end) inside q with a kernel.
+ */
+static size_t count_range(ScanKernel2D kernel, const PointColumns2D &cols,
+                          size_t begin, size_t end, const Rectangle &q) {
+  const int32_t *xs = cols.xs.data(), *ys = cols.ys.data();
+#ifdef SCAN2D_X86
+  if (kernel == SCAN2D_AVX512) return count_avx512(xs, ys, begin, end, q);
+  if (kernel == SCAN2D_AVX2) return count_avx2(xs, ys, begin, end, q);
+#endif
+  return count_scalar(xs, ys, begin, end, q);
+}
+
+/**
+ *  Appends the positions of the points of [begin, end) inside q with a kernel.
+ */
+static void select_range(ScanKernel2D kernel, const PointColumns2D &cols,
+                         size_t begin, size_t end, const Rectangle &q,
+                         std::vector<uint32_t> &out) {
+  const int32_t *xs = cols.xs.data(), *ys = cols.ys.data();
+#ifdef SCAN2D_X86
+  if (kernel == SCAN2D_AVX512) return select_avx512(xs, ys, begin, end, q, out);
+  if (kernel == SCAN2D_AVX2) return select_avx2(xs, ys, begin, end, q, out);
+#endif
+  select_scalar(xs, ys, begin, end, q, out);
+}
+
+/**
+ *  Adds the number of points of [begin, end) inside each rectangle with a kernel.
+ */
+static void count_many_range(ScanKernel2D kernel, const PointColumns2D &cols,
+                             size_t begin, size_t end, const std::vector<Rectangle> &queries,
+                             size_t *counts) {
+  const int32_t *xs = cols.xs.data(), *ys = cols.ys.data();
+#ifdef SCAN2D_X86
+  if (kernel == SCAN2D_AVX512) return count_many_avx512(xs, ys, begin, end, queries, counts);
+  if (kernel == SCAN2D_AVX2) return count_many_avx2(xs, ys, begin, end, queries, counts);
+#endif
+  count_many_scalar(xs, ys, begin, end, queries, counts);
+}
+
+/**
+ *  Counts the points inside a rectangle.
+ */
+size_t scan_count_2d(const PointColumns2D &cols, const Rectangle &q,
+                     ScanKernel2D kernel, size_t threads) {
+  kernel = resolve_kernel(kernel);
+  threads = resolve_threads(cols.size(), threads);
+  std::vector<size_t> partial(threads, 0);
+  parallel_chunks(cols.size(), threads, [&](size_t begin, size_t end, size_t t) {
+    partial[t] = count_range(kernel, cols, begin, end, q);
+  });
+  size_t count = 0;
+  for (size_t c : partial) count += c;
+  return count;
+}
+
+/**
+ *  Returns the points inside a rectangle, in input order.
+ */
+std::vector<Point2D> scan_range_query_2d(const PointColumns2D &cols, const Rectangle &q,
+                                         ScanKernel2D kernel, size_t threads) {
+  kernel = resolve_kernel(kernel);
+  threads = resolve_threads(cols.size(), threads);
+  std::vector<std::vector<uint32_t>> partial(threads);
+  parallel_chunks(cols.size(), threads, [&](size_t begin, size_t end, size_t t) {
+    select_range(kernel, cols, begin, end, q, partial[t]);
+  });
+
+  std::vector<Point2D> result;
+  for (const std::vector<uint32_t> &positions : partial) {
+    for (uint32_t i : positions) result.push_back(cols.get(i));
+  }
+  return result;
+}
+
+/**
+ *  Counts the points inside each of many rectangles in a single pass.
+ */
+std::vector<size_t> scan_count_many_2d(const PointColumns2D &cols,
+                                       const std::vector<Rectangle> &queries,
+                                       ScanKernel2D kernel, size_t threads) {
+  kernel = resolve_kernel(kernel);
+  threads = resolve_threads(cols.size(), threads);
+  std::vector<std::vector<size_t>> partial(threads, std::vector<size_t>(queries.size(), 0));
+  parallel_chunks(cols.size(), threads, [&](size_t begin, size_t end, size_t t) {
+    count_many_range(kernel, cols, begin, end, queries, partial[t].data());
+  });
+
+  std::vector<size_t> counts(queries.size(), 0);
+  for (const std::vector<size_t> &p : partial) {
+    for (size_t k = 0; k < counts.size(); k++) counts[k] += p[k];
+  }
+  return counts;
+}
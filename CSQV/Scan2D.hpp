@@ -0,0 +1,92 @@
+/**
+ *  @file Scan2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Brute-force scan kernels over columnar 2D points.
+ *
+ *  Coordinates are stored as separate x and y arrays so that the kernels can
+ *  compare 8 (AVX2) or 16 (AVX-512) points per instruction. The kernel is
+ *  selected at run time from the features of the CPU, with a portable scalar
+ *  fallback, and scans can be split among several threads. The results are
+ *  the same as count_in_range and range_query in Point2D.hpp.
+ */
+
+#ifndef SCAN2D_H
+#define SCAN2D_H
+
+#include "Point2D.hpp"
+#include <vector>
+
+/**
+ *  Scan kernels.
+ */
+enum ScanKernel2D {SCAN2D_AUTO, SCAN2D_SCALAR, SCAN2D_AVX2, SCAN2D_AVX512};
+
+/**
+ *  2D points stored column by column.
+ */
+struct PointColumns2D {
+  std::vector<uint32_t> ids; ///< Point IDs
+  std::vector<int32_t> xs;   ///< x-coordinates
+  std::vector<int32_t> ys;   ///< y-coordinates
+
+  PointColumns2D() {}
+  PointColumns2D(const std::vector<Point2D> &points);
+
+  size_t size() const { return xs.size(); }
+  Point2D get(size_t i) const { return Point2D(ids[i], xs[i], ys[i]); }
+};
+
+/**
+ *  Returns the fastest kernel supported by the CPU.
+ */
+ScanKernel2D best_scan_kernel_2d();
+
+/**
+ *  Returns true if the CPU supports a kernel.
+ *  @param kernel the kernel
+ */
+bool scan_kernel_supported_2d(ScanKernel2D kernel);
+
+/**
+ *  Returns the name of a kernel.
+ *  @param kernel the kernel
+ */
+const char *scan_kernel_name_2d(ScanKernel2D kernel);
+
+/**
+ *  Counts the points inside a rectangle.
+ *  @param cols the points
+ *  @param q the query rectangle
+ *  @param kernel the kernel (SCAN2D_AUTO selects the fastest one)
+ *  @param threads the number of threads (0 = one per hardware thread)
+ *  @return the number of points inside q
+ */
+size_t scan_count_2d(const PointColumns2D &cols, const Rectangle &q,
+                     ScanKernel2D kernel = SCAN2D_AUTO, size_t threads = 1);
+
+/**
+ *  Returns the points inside a rectangle, in input order.
+ *  @param cols the points
+ *  @param q the query rectangle
+ *  @param kernel the kernel (SCAN2D_AUTO selects the fastest one)
+ *  @param threads the number of threads (0 = one per hardware thread)
+ *  @return the points inside q
+ */
+std::vector<Point2D> scan_range_query_2d(const PointColumns2D &cols, const Rectangle &q,
+                                         ScanKernel2D kernel = SCAN2D_AUTO, size_t threads = 1);
+
+/**
+ *  Counts the points inside each of many rectangles in a single pass over
+ *  the points: each point is compared with 8 or 16 rectangles at once.
+ *  @param cols the points
+ *  @param queries the query rectangles
+ *  @param kernel the kernel (SCAN2D_AUTO selects the fastest one)
+ *  @param threads the number of threads (0 = one per hardware thread)
+ *  @return the number of points inside each rectangle
+ */
+std::vector<size_t> scan_count_many_2d(const PointColumns2D &cols,
+                                       const std::vector<Rectangle> &queries,
+                                       ScanKernel2D kernel = SCAN2D_AUTO, size_t threads = 1);
+
+#endif
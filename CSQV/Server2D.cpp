@@ -0,0 +1,615 @@
+/**
+ *  @file Server2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Server2D.hpp"
+#include "Knn2D.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+ServerRequest2D range_request_2d(uint32_t id, const Rectangle &query) {
+  return ServerRequest2D{SERVER2D_RANGE, id, {query.lx, query.ly, query.ux, query.uy}};
+}
+
+ServerRequest2D count_request_2d(uint32_t id, const Rectangle &query) {
+  return ServerRequest2D{SERVER2D_COUNT, id, {query.lx, query.ly, query.ux, query.uy}};
+}
+
+ServerRequest2D knn_request_2d(uint32_t id, int32_t x, int32_t y, uint32_t k) {
+  return ServerRequest2D{SERVER2D_KNN, id, {x, y, (int32_t) k, 0}};
+}
+
+ServerRequest2D roots_request_2d(uint32_t id) {
+  return ServerRequest2D{SERVER2D_ROOTS, id, {0, 0, 0, 0}};
+}
+
+/**
+ *  Appends the encoding of a request to a byte vector.
+ */
+void encode_request_2d(const ServerRequest2D &request, std::vector<uint8_t> &out) {
+  size_t start = out.size();
+  out.resize(start + SERVER2D_REQUEST_SIZE, 0);
+  uint8_t *p = out.data() + start;
+  p[0] = request.op;
+  std::memcpy(p + 4, &request.id, sizeof(uint32_t));
+  std::memcpy(p + 8, request.args, sizeof(request.args));
+}
+
+/**
+ *  Decodes a request.
+ */
+ServerRequest2D decode_request_2d(const uint8_t *data) {
+  ServerRequest2D request;
+  request.op = data[0];
+  std::memcpy(&request.id, data + 4, sizeof(uint32_t));
+  std::memcpy(request.args, data + 8, sizeof(request.args));
+  return request;
+}
+
+/**
+ *  Decodes a reply at the start of a byte sequence.
+ */
+bool decode_reply_2d(const uint8_t *data, size_t size, ServerReply2D &reply, size_t &used) {
+  uint64_t length;
+  if (size < SERVER2D_REPLY_HEADER) return false;
+  std::memcpy(&length, data + 8, sizeof(uint64_t));
+  if (length > size - SERVER2D_REPLY_HEADER) return false;
+  std::memcpy(&reply.id, data, sizeof(uint32_t));
+  reply.op = data[4];
+  reply.status = data[5];
+  reply.body.assign(data + SERVER2D_REPLY_HEADER, data + SERVER2D_REPLY_HEADER + length);
+  used = SERVER2D_REPLY_HEADER + length;
+  return true;
+}
+
+/**
+ *  Creates a server.
+ */
+QueryServer2D::QueryServer2D(Node2D *root, const CountTree2D &counts)
+: root(root), counts(&counts), image(nullptr), listen_fd(-1), epoll_fd(-1), wake_fd(-1),
+  stopping(false), next_conn(2), stats{0, 0, 0, 0, 0, 0}, quit(false) {}
+
+/**
+ *  Creates a server answering range queries from a page file image.
+ */
+QueryServer2D::QueryServer2D(const PageImage2D &image)
+: root(nullptr), counts(nullptr), image(&image), listen_fd(-1), epoll_fd(-1), wake_fd(-1),
+  stopping(false), next_conn(2), stats{0, 0, 0, 0, 0, 0}, quit(false) {}
+
+/**
+ *  Answers a request, appending the encoded reply.
+ */
+void QueryServer2D::answer(const ServerRequest2D &request, std::vector<uint8_t> &out) const {
+  size_t start = out.size();
+  out.resize(start + SERVER2D_REPLY_HEADER, 0);
+  uint8_t status = SERVER2D_OK;
+  Rectangle rect = {request.args[0], request.args[1], request.args[2], request.args[3]};
+  
+  switch (request.op) {
+    case SERVER2D_RANGE: {
+      VObject2D *vo = image ? range_query_paged_2d(*image, rect) : range_query_2d(root, rect);
+      if (!vo) {
+        status = SERVER2D_FAILED;
+        break;
+      }
+      serialize_vo_2d(vo, out);
+      delete_vo_2d(vo);
+      break;
+    }
+    case SERVER2D_COUNT: {
+      if (image) {
+        status = SERVER2D_UNSUPPORTED;
+        break;
+      }
+      if (rect.lx > rect.ux || rect.ly > rect.uy) {
+        status = SERVER2D_BAD_REQUEST;
+        break;
+      }
+      VHeat2D *vo = heatmap_query_2d(*counts, HeatmapGrid2D{rect, 1, 1});
+      serialize_heatmap_vo_2d(vo, out);
+      delete vo;
+      break;
+    }
+    case SERVER2D_KNN: {
+      if (image) {
+        status = SERVER2D_UNSUPPORTED;
+        break;
+      }
+      uint64_t radius = 0;
+      VObject2D *vo = (request.args[2] > 0)
+                      ? knn_query_2d(root, request.args[0], request.args[1], (uint32_t) request.args[2], radius)
+                      : nullptr;
+      if (!vo) {
+        status = SERVER2D_BAD_REQUEST;
+        break;
+      }
+      const uint8_t *r = reinterpret_cast<const uint8_t*>(&radius);
+      out.insert(out.end(), r, r + sizeof(radius));
+      serialize_vo_2d(vo, out);
+      delete_vo_2d(vo);
+      break;
+    }
+    case SERVER2D_ROOTS: {
+      hash_t tree_hash = image ? image->getHash() : root->getHash();
+      hash_t count_hash = image ? hash_t{} : counts->getHash();
+      uint64_t points = image ? image->size() : counts->size();
+      const uint8_t *n = reinterpret_cast<const uint8_t*>(&points);
+      out.insert(out.end(), tree_hash.begin(), tree_hash.end());
+      out.insert(out.end(), count_hash.begin(), count_hash.end());
+      out.insert(out.end(), n, n + sizeof(points));
+      break;
+    }
+    default:
+      status = SERVER2D_BAD_REQUEST;
+  }
+  
+  if (status != SERVER2D_OK) out.resize(start + SERVER2D_REPLY_HEADER);
+  uint64_t length = out.size() - start - SERVER2D_REPLY_HEADER;
+  uint8_t *p = out.data() + start;
+  std::memcpy(p, &request.id, sizeof(uint32_t));
+  p[4] = request.op;
+  p[5] = status;
+  std::memcpy(p + 8, &length, sizeof(uint64_t));
+}
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ *  Identifiers of the listening socket and of the wake-up event in epoll.
+ */
+#define SERVER2D_LISTEN_ID 0
+#define SERVER2D_WAKE_ID 1
+
+/**
+ *  Main loop of a worker thread: answers batches of jobs and hands the
+ *  replies to the event loop.
+ */
+void QueryServer2D::work() {
+  std::vector<Job2D> batch;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(job_mutex);
+      job_cv.wait(lock, [this]() { return quit || !jobs.empty(); });
+      if (quit) return;
+      // Take a share of the queue so that other workers get some too.
+      size_t n = std::max<size_t>(1, std::min<size_t>(32, jobs.size() / 2));
+      batch.assign(jobs.begin(), jobs.begin() + n);
+      jobs.erase(jobs.begin(), jobs.begin() + n);
+    }
+    
+    std::vector<Done2D> replies;
+    for (const Job2D &job : batch) {
+      if (replies.empty() || replies.back().conn != job.conn) replies.push_back(Done2D{job.conn, {}});
+      answer(job.request, replies.back().bytes);
+    }
+    
+    bool wake;
+    {
+      std::lock_guard<std::mutex> lock(done_mutex);
+      wake = done.empty();
+      for (Done2D &d : replies) done.push_back(std::move(d));
+    }
+    if (wake) {
+      uint64_t one = 1;
+      // The counter cannot overflow here, so the write cannot fail.
+      ssize_t unused = ::write(wake_fd, &one, sizeof(one));
+      (void) unused;
+    }
+  }
+}
+
+/**
+ *  Parses an address into a socket address; false if it is malformed.
+ */
+static bool parse_address_2d(const std::string &address, sockaddr_storage &addr, socklen_t &len) {
+  std::memset(&addr, 0, sizeof(addr));
+  if (address.compare(0, 5, "unix:") == 0) {
+    sockaddr_un *un = reinterpret_cast<sockaddr_un*>(&addr);
+    std::string path = address.substr(5);
+    if (path.empty() || path.size() >= sizeof(un->sun_path)) return false;
+    un->sun_family = AF_UNIX;
+    std::memcpy(un->sun_path, path.c_str(), path.size() + 1);
+    len = sizeof(sockaddr_un);
+    return true;
+  }
+  if (address.compare(0, 4, "tcp:") != 0) return false;
+  std::string rest = address.substr(4), host = "127.0.0.1", port = rest;
+  size_t colon = rest.rfind(':');
+  if (colon != std::string::npos) {
+    host = rest.substr(0, colon);
+    port = rest.substr(colon + 1);
+  }
+  addrinfo hints, *res = nullptr;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0 || !res) return false;
+  std::memcpy(&addr, res->ai_addr, res->ai_addrlen);
+  len = res->ai_addrlen;
+  freeaddrinfo(res);
+  return true;
+}
+
+/**
+ *  Disables Nagle's algorithm on TCP sockets, which would delay small replies.
+ */
+static void set_nodelay_2d(int fd, const sockaddr_storage &addr) {
+  int one = 1;
+  if (addr.ss_family == AF_INET) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+/**
+ *  Binds the listening socket.
+ */
+bool QueryServer2D::listen(const std::string &address) {
+  close();
+  sockaddr_storage addr;
+  socklen_t len;
+  if ((image ? !image->isOpen() : !root) || !parse_address_2d(address, addr, len)) {
+    std::cerr << "Error: cannot listen on " << address << std::endl;
+    return false;
+  }
+  listen_fd = socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  int one = 1;
+  if (listen_fd >= 0 && addr.ss_family == AF_INET) {
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  }
+  if (addr.ss_family == AF_UNIX) {
+    unix_path = reinterpret_cast<sockaddr_un*>(&addr)->sun_path;
+    unlink(unix_path.c_str());
+  }
+  if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+      ::listen(listen_fd, SOMAXCONN) != 0) {
+    std::cerr << "Error: cannot listen on " << address << ": " << std::strerror(errno) << std::endl;
+    close();
+    return false;
+  }
+  return true;
+}
+
+/**
+ *  Closes the listening socket.
+ */
+void QueryServer2D::close() {
+  if (listen_fd >= 0) ::close(listen_fd);
+  if (!unix_path.empty()) unlink(unix_path.c_str());
+  listen_fd = -1;
+  unix_path.clear();
+}
+
+/**
+ *  Makes run return.
+ */
+void QueryServer2D::stop() {
+  stopping = true;
+  uint64_t one = 1;
+  if (wake_fd >= 0) {
+    ssize_t unused = ::write(wake_fd, &one, sizeof(one));
+    (void) unused;
+  }
+}
+
+/**
+ *  Accepts the pending connections.
+ */
+void QueryServer2D::accept() {
+  for (;;) {
+    sockaddr_storage addr;
+    socklen_t len = sizeof(addr);
+    int fd = accept4(listen_fd, reinterpret_cast<sockaddr*>(&addr), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+    set_nodelay_2d(fd, addr);
+    uint64_t id = next_conn++;
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = id;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+      ::close(fd);
+      continue;
+    }
+    connections[id] = Connection2D{fd, {}, {}, 0, 0, EPOLLIN};
+    stats.connections++;
+  }
+}
+
+/**
+ *  Closes a connection; replies still being computed for it are dropped.
+ */
+void QueryServer2D::drop(uint64_t id) {
+  auto it = connections.find(id);
+  if (it == connections.end()) return;
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+  ::close(it->second.fd);
+  connections.erase(it);
+}
+
+/**
+ *  Reads the requests of a connection and queues them for the workers.
+ *  Reading stops once the requests buffered exceed what may still be queued.
+ */
+void QueryServer2D::read(uint64_t id) {
+  Connection2D &c = connections.at(id);
+  size_t room = std::max<size_t>(1, SERVER2D_MAX_INFLIGHT - c.inflight) * SERVER2D_REQUEST_SIZE;
+  uint8_t chunk[65536];
+  while (c.in.size() < room) {
+    ssize_t n = ::read(c.fd, chunk, sizeof(chunk));
+    if (n > 0) {
+      c.in.insert(c.in.end(), chunk, chunk + n);
+      stats.bytes_in += n;
+      if ((size_t) n < sizeof(chunk)) break;
+      continue;
+    }
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    drop(id);
+    return;
+  }
+  queue(id);
+  watch(id);
+}
+
+/**
+ *  Queues the complete requests of a connection for the workers, keeping
+ *  at most SERVER2D_MAX_INFLIGHT of them queued or being answered.
+ */
+void QueryServer2D::queue(uint64_t id) {
+  Connection2D &c = connections.at(id);
+  size_t count = std::min<size_t>(c.in.size() / SERVER2D_REQUEST_SIZE, SERVER2D_MAX_INFLIGHT - c.inflight);
+  if (count == 0) return;
+  {
+    std::lock_guard<std::mutex> lock(job_mutex);
+    for (size_t i = 0; i < count; i++) {
+      jobs.push_back(Job2D{id, decode_request_2d(c.in.data() + i * SERVER2D_REQUEST_SIZE)});
+    }
+  }
+  count > 1 ? job_cv.notify_all() : job_cv.notify_one();
+  c.in.erase(c.in.begin(), c.in.begin() + count * SERVER2D_REQUEST_SIZE);
+  c.inflight += count;
+  stats.requests += count;
+}
+
+/**
+ *  Updates the events of a connection: reads pause while too much output
+ *  is pending or too many requests are in flight.
+ */
+void QueryServer2D::watch(uint64_t id) {
+  Connection2D &c = connections.at(id);
+  size_t pending = c.out.size() - c.sent;
+  bool full = pending > SERVER2D_MAX_OUTPUT || c.inflight >= SERVER2D_MAX_INFLIGHT;
+  uint32_t events = (pending > 0 ? (uint32_t) EPOLLOUT : 0u) | (full ? 0u : (uint32_t) EPOLLIN);
+  if (events != c.events) {
+    if (c.inflight >= SERVER2D_MAX_INFLIGHT && (c.events & EPOLLIN)) stats.paused++;
+    epoll_event ev;
+    ev.events = events;
+    ev.data.u64 = id;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c.fd, &ev);
+    c.events = events;
+  }
+}
+
+/**
+ *  Writes as much pending output as the socket takes and updates the
+ *  events of the connection.
+ */
+void QueryServer2D::flush(uint64_t id) {
+  Connection2D &c = connections.at(id);
+  while (c.sent < c.out.size()) {
+    ssize_t n = ::send(c.fd, c.out.data() + c.sent, c.out.size() - c.sent, MSG_NOSIGNAL);
+    if (n > 0) {
+      c.sent += n;
+      stats.bytes_out += n;
+      continue;
+    }
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    drop(id);
+    return;
+  }
+  if (c.sent == c.out.size()) {
+    c.out.clear();
+    c.sent = 0;
+  } else if (c.sent > c.out.size() / 2) {
+    c.out.erase(c.out.begin(), c.out.begin() + c.sent);
+    c.sent = 0;
+  }
+  watch(id);
+}
+
+/**
+ *  Moves the replies computed by the workers to their connections, and
+ *  queues the requests held back while those were in flight.
+ */
+void QueryServer2D::deliver() {
+  uint64_t value;
+  while (::read(wake_fd, &value, sizeof(value)) > 0) {}
+  std::vector<Done2D> replies;
+  {
+    std::lock_guard<std::mutex> lock(done_mutex);
+    replies.swap(done);
+  }
+  std::vector<uint64_t> touched;
+  for (Done2D &d : replies) {
+    auto it = connections.find(d.conn);
+    if (it == connections.end()) continue;
+    std::vector<uint8_t> &out = it->second.out;
+    out.insert(out.end(), d.bytes.begin(), d.bytes.end());
+    for (size_t pos = 0; pos < d.bytes.size(); stats.replies++, it->second.inflight--) {
+      uint64_t length;
+      std::memcpy(&length, d.bytes.data() + pos + 8, sizeof(length));
+      pos += SERVER2D_REPLY_HEADER + length;
+    }
+    touched.push_back(d.conn);
+  }
+  std::sort(touched.begin(), touched.end());
+  touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+  for (uint64_t id : touched) {
+    queue(id);
+    flush(id);
+  }
+}
+
+/**
+ *  Serves requests until stop is called.
+ */
+bool QueryServer2D::run(size_t threads) {
+  if (listen_fd < 0) return false;
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.u64 = SERVER2D_LISTEN_ID;
+  bool ok = epoll_fd >= 0 && wake_fd >= 0 && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) == 0;
+  ev.data.u64 = SERVER2D_WAKE_ID;
+  ok = ok && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev) == 0;
+  if (!ok) {
+    std::cerr << "Error: cannot set up the event loop" << std::endl;
+    if (epoll_fd >= 0) ::close(epoll_fd);
+    if (wake_fd >= 0) ::close(wake_fd);
+    epoll_fd = wake_fd = -1;
+    return false;
+  }
+  
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  quit = false;
+  std::vector<std::thread> pool;
+  for (size_t t = 0; t < threads; t++) pool.emplace_back(&QueryServer2D::work, this);
+  
+  epoll_event events[64];
+  while (!stopping) {
+    int n = epoll_wait(epoll_fd, events, 64, -1);
+    if (n < 0 && errno != EINTR) break;
+    for (int i = 0; i < n; i++) {
+      uint64_t id = events[i].data.u64;
+      if (id == SERVER2D_LISTEN_ID) {
+        accept();
+      } else if (id == SERVER2D_WAKE_ID) {
+        deliver();
+      } else {
+        // A hung-up connection is dropped at once: it is reported even while
+        // its reads are paused, and its replies could not be written.
+        if (connections.count(id) && (events[i].events & (EPOLLHUP | EPOLLERR))) drop(id);
+        if (connections.count(id) && (events[i].events & EPOLLIN)) read(id);
+        if (connections.count(id) && (events[i].events & EPOLLOUT)) flush(id);
+      }
+    }
+  }
+  
+  {
+    std::lock_guard<std::mutex> lock(job_mutex);
+    quit = true;
+    jobs.clear();
+  }
+  job_cv.notify_all();
+  for (std::thread &t : pool) t.join();
+  while (!connections.empty()) drop(connections.begin()->first);
+  done.clear();
+  ::close(epoll_fd);
+  ::close(wake_fd);
+  epoll_fd = wake_fd = -1;
+  stopping = false;
+  return true;
+}
+
+/**
+ *  Connects to a server.
+ */
+bool ServerClient2D::connect(const std::string &address) {
+  close();
+  sockaddr_storage addr;
+  socklen_t len;
+  if (!parse_address_2d(address, addr, len)) return false;
+  fd = socket(addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0) {
+    close();
+    return false;
+  }
+  set_nodelay_2d(fd, addr);
+  return true;
+}
+
+/**
+ *  Closes the connection.
+ */
+void ServerClient2D::close() {
+  if (fd >= 0) ::close(fd);
+  fd = -1;
+  in.clear();
+  pos = 0;
+}
+
+/**
+ *  Sends a batch of requests in one write.
+ */
+bool ServerClient2D::send(const std::vector<ServerRequest2D> &requests) {
+  if (fd < 0) return false;
+  std::vector<uint8_t> buf;
+  buf.reserve(requests.size() * SERVER2D_REQUEST_SIZE);
+  for (const ServerRequest2D &r : requests) encode_request_2d(r, buf);
+  for (size_t off = 0; off < buf.size();) {
+    ssize_t n = ::send(fd, buf.data() + off, buf.size() - off, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    off += n;
+  }
+  return true;
+}
+
+/**
+ *  Waits for the next reply.
+ */
+bool ServerClient2D::receive(ServerReply2D &reply) {
+  if (fd < 0) return false;
+  size_t used;
+  while (!decode_reply_2d(in.data() + pos, in.size() - pos, reply, used)) {
+    if (pos > 0) {
+      in.erase(in.begin(), in.begin() + pos);
+      pos = 0;
+    }
+    uint8_t chunk[65536];
+    ssize_t n = ::read(fd, chunk, sizeof(chunk));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    in.insert(in.end(), chunk, chunk + n);
+  }
+  pos += used;
+  return true;
+}
+
+#else
+
+// No epoll: the server and the client cannot be used.
+
+bool QueryServer2D::listen(const std::string &address) {
+  std::cerr << "Error: the query server needs Linux (epoll), cannot listen on " << address << std::endl;
+  return false;
+}
+
+void QueryServer2D::close() {}
+void QueryServer2D::stop() { stopping = true; }
+bool QueryServer2D::run(size_t) { return false; }
+void QueryServer2D::accept() {}
+void QueryServer2D::drop(uint64_t) {}
+void QueryServer2D::read(uint64_t) {}
+void QueryServer2D::flush(uint64_t) {}
+void QueryServer2D::deliver() {}
+
+bool ServerClient2D::connect(const std::string &) { return false; }
+void ServerClient2D::close() {}
+bool ServerClient2D::send(const std::vector<ServerRequest2D> &) { return false; }
+bool ServerClient2D::receive(ServerReply2D &) { return false; }
+
+#endif
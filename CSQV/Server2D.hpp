@@ -0,0 +1,276 @@
+/**
+ *  @file Server2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Local query server: binary protocol, epoll server and blocking client.
+ *
+ *  The server listens on a Unix domain socket or on localhost TCP. An
+ *  epoll loop reads pipelined requests from every connection and hands
+ *  them to a pool of worker threads, which answer them on the shared tree
+ *  and pass the encoded replies back to the loop for writing. Replies on a
+ *  connection may come back out of order and carry the request ID.
+ *
+ *  Wire format (native endian):
+ *    request: u8 op, u8 0, u16 0, u32 id, 4 × i32 arguments
+ *             RANGE, COUNT: the query rectangle; KNN: x, y, k, unused
+ *    reply:   u32 id, u8 op, u8 status, u16 0, u64 length, then length bytes
+ *             RANGE: VO of range_query_2d (serialize_vo_2d)
+ *             COUNT: heatmap VO of the 1 × 1 grid over the rectangle
+ *             KNN:   u64 radius, then VO of knn_query_2d
+ *             ROOTS: MR-tree root digest, count-augmented root digest, u64 points
+ *
+ *  A server can also answer from a page file image (PageImage2D), e.g. a
+ *  memory-mapped page file larger than the tree it could build in memory.
+ *  It answers RANGE with range_query_paged_2d, whose VO is the same as
+ *  range_query_2d's; COUNT and KNN need the in-memory tree and get
+ *  SERVER2D_UNSUPPORTED, and the count digest in ROOTS is all zeros.
+ *
+ *  Addresses are "unix:<path>", "tcp:<port>" (127.0.0.1) or "tcp:<host>:<port>".
+ *  Linux only (epoll): elsewhere listen and connect fail.
+ */
+
+#ifndef SERVER2D_H
+#define SERVER2D_H
+
+#include "Heatmap2D.hpp"
+#include "PageFile2D.hpp"
+#include "Query2D.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ *  Request types.
+ */
+enum ServerOp2D {SERVER2D_RANGE = 1, SERVER2D_COUNT, SERVER2D_KNN, SERVER2D_ROOTS};
+
+/**
+ *  Reply statuses.
+ */
+enum ServerStatus2D {SERVER2D_OK = 0, SERVER2D_BAD_REQUEST, SERVER2D_FAILED, SERVER2D_UNSUPPORTED};
+
+/**
+ *  Sizes of a request and of a reply header.
+ */
+#define SERVER2D_REQUEST_SIZE 24
+#define SERVER2D_REPLY_HEADER 16
+
+/**
+ *  Pending output of a connection above which its requests are no longer read.
+ */
+#define SERVER2D_MAX_OUTPUT (64 << 20)
+
+/**
+ *  Requests of a connection queued or being answered above which its
+ *  requests are no longer read.
+ */
+#define SERVER2D_MAX_INFLIGHT 1024
+
+/**
+ *  A request.
+ */
+struct ServerRequest2D {
+  uint8_t op;
+  uint32_t id;
+  int32_t args[4];
+};
+
+/**
+ *  A decoded reply.
+ */
+struct ServerReply2D {
+  uint32_t id;
+  uint8_t op;
+  uint8_t status;
+  std::vector<uint8_t> body;
+};
+
+ServerRequest2D range_request_2d(uint32_t id, const Rectangle &query);
+ServerRequest2D count_request_2d(uint32_t id, const Rectangle &query);
+ServerRequest2D knn_request_2d(uint32_t id, int32_t x, int32_t y, uint32_t k);
+ServerRequest2D roots_request_2d(uint32_t id);
+
+/**
+ *  Appends the encoding of a request to a byte vector.
+ */
+void encode_request_2d(const ServerRequest2D &request, std::vector<uint8_t> &out);
+
+/**
+ *  Decodes a request from SERVER2D_REQUEST_SIZE bytes.
+ */
+ServerRequest2D decode_request_2d(const uint8_t *data);
+
+/**
+ *  Decodes a reply at the start of a byte sequence.
+ *  @param data the bytes received
+ *  @param size their number
+ *  @param reply receives the reply
+ *  @param used receives the number of bytes decoded
+ *  @return false if the reply is not complete yet
+ */
+bool decode_reply_2d(const uint8_t *data, size_t size, ServerReply2D &reply, size_t &used);
+
+/**
+ *  Counters of a server.
+ */
+struct ServerStats2D {
+  size_t connections; ///< Connections accepted
+  size_t requests;    ///< Requests read
+  size_t replies;     ///< Replies written to connections
+  size_t bytes_in;    ///< Bytes read
+  size_t bytes_out;   ///< Bytes written
+  size_t paused;      ///< Times reads of a connection paused at SERVER2D_MAX_INFLIGHT
+};
+
+/**
+ *  Query server over an MR-tree and its count-augmented commitment, or
+ *  over a page file image, which it does not own.
+ */
+class QueryServer2D {
+private:
+  /**
+   *  A client connection and its buffers.
+   */
+  struct Connection2D {
+    int fd;
+    std::vector<uint8_t> in;  ///< Bytes of incomplete requests
+    std::vector<uint8_t> out; ///< Encoded replies not written yet
+    size_t sent;              ///< Bytes of out already written
+    size_t inflight;          ///< Requests queued or being answered
+    uint32_t events;          ///< Events the connection is registered for
+  };
+
+  /**
+   *  A request of a connection, or the encoded replies for it.
+   */
+  struct Job2D {
+    uint64_t conn;
+    ServerRequest2D request;
+  };
+  struct Done2D {
+    uint64_t conn;
+    std::vector<uint8_t> bytes;
+  };
+
+  Node2D *root;
+  const CountTree2D *counts;
+  const PageImage2D *image;    ///< Page file image answered instead of root, or nullptr
+  int listen_fd;
+  int epoll_fd;
+  int wake_fd;                 ///< Signalled by workers and by stop
+  std::string unix_path;       ///< Socket file to remove on close
+  std::atomic<bool> stopping;
+  std::unordered_map<uint64_t, Connection2D> connections;
+  uint64_t next_conn;
+  ServerStats2D stats;
+
+  std::mutex job_mutex;
+  std::condition_variable job_cv;
+  std::deque<Job2D> jobs;
+  bool quit;                   ///< Tells the workers to exit
+  std::mutex done_mutex;
+  std::vector<Done2D> done;
+
+  void answer(const ServerRequest2D &request, std::vector<uint8_t> &out) const;
+  void work();
+  void accept();
+  void read(uint64_t id);
+  void queue(uint64_t id);
+  void watch(uint64_t id);
+  void flush(uint64_t id);
+  void deliver();
+  void drop(uint64_t id);
+
+public:
+  /**
+   *  Creates a server.
+   *  @param root the root of the 2D MR-tree
+   *  @param counts its count-augmented commitment
+   */
+  QueryServer2D(Node2D *root, const CountTree2D &counts);
+
+  /**
+   *  Creates a server answering range queries from a page file image.
+   *  @param image the open image
+   */
+  QueryServer2D(const PageImage2D &image);
+  ~QueryServer2D() { close(); }
+  QueryServer2D(const QueryServer2D &) = delete;
+  QueryServer2D &operator=(const QueryServer2D &) = delete;
+
+  /**
+   *  Binds the listening socket.
+   *  @param address the address to listen on
+   *  @return false if the address is malformed or cannot be bound
+   */
+  bool listen(const std::string &address);
+
+  /**
+   *  Serves requests until stop is called.
+   *  @param threads the number of worker threads (0 = one per hardware thread)
+   *  @return false if the server is not listening
+   */
+  bool run(size_t threads = 0);
+
+  /**
+   *  Makes run return. Safe to call from another thread or a signal handler.
+   */
+  void stop();
+
+  /**
+   *  Closes the listening socket.
+   */
+  void close();
+
+  const ServerStats2D &getStats() const { return stats; }
+};
+
+/**
+ *  Blocking client of a query server. One thread may send while another
+ *  receives.
+ */
+class ServerClient2D {
+private:
+  int fd;
+  std::vector<uint8_t> in; ///< Bytes received and not decoded yet
+  size_t pos;              ///< Bytes of in already decoded
+
+public:
+  ServerClient2D() : fd(-1), pos(0) {}
+  ~ServerClient2D() { close(); }
+  ServerClient2D(const ServerClient2D &) = delete;
+  ServerClient2D &operator=(const ServerClient2D &) = delete;
+
+  /**
+   *  Connects to a server.
+   *  @param address the server address
+   *  @return false if the connection fails
+   */
+  bool connect(const std::string &address);
+
+  /**
+   *  Closes the connection.
+   */
+  void close();
+
+  /**
+   *  Sends a batch of requests in one write.
+   *  @return false if the connection is broken
+   */
+  bool send(const std::vector<ServerRequest2D> &requests);
+
+  /**
+   *  Waits for the next reply.
+   *  @return false if the connection is closed or broken
+   */
+  bool receive(ServerReply2D &reply);
+
+  bool isOpen() const { return fd >= 0; }
+  int getFd() const { return fd; }
+};
+
+#endif
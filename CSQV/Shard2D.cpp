@@ -0,0 +1,228 @@
+/**
+ *  @file Shard2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Shard2D.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+/**
+ *  Runs fn(i) for i in [0, n) on up to the given number of threads
+ *  (0 = one per hardware thread), the calling thread included.
+ */
+template <typename Fn>
+static void parallel_for_2d(size_t n, size_t threads, Fn fn) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min(threads, n);
+  if (threads <= 1) {
+    for (size_t i = 0; i < n; i++) fn(i);
+    return;
+  }
+  std::atomic<size_t> next(0);
+  auto work = [&]() {
+    for (size_t i = next++; i < n; i = next++) fn(i);
+  };
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < threads; t++) pool.emplace_back(work);
+  work();
+  for (std::thread &th : pool) th.join();
+}
+
+/**
+ *  Starts the workers.
+ */
+ShardPool2D::ShardPool2D(size_t size) : fn(nullptr), n(0), next(0), tickets(0), running(0), stop(false) {
+  for (size_t w = 0; w < size; w++) workers.emplace_back(&ShardPool2D::work, this);
+}
+
+/**
+ *  Stops and joins the workers.
+ */
+ShardPool2D::~ShardPool2D() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  wake.notify_all();
+  for (std::thread &t : workers) t.join();
+}
+
+/**
+ *  Loop of a worker: joins the current loop when it gets a ticket.
+ */
+void ShardPool2D::work() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wake.wait(lock, [&]() { return stop || tickets > 0; });
+    if (stop) return;
+    tickets--;
+    running++;
+    lock.unlock();
+    for (size_t i = next++; i < n; i = next++) (*fn)(i);
+    lock.lock();
+    if (--running == 0 && tickets == 0) idle.notify_one();
+  }
+}
+
+/**
+ *  Runs a loop on the calling thread and the workers. Tickets still unused
+ *  when the calling thread runs out of iterations are withdrawn, so that it
+ *  never waits for a worker to wake up only to find nothing left.
+ */
+bool ShardPool2D::run(size_t count, size_t threads, const std::function<void(size_t)> &body) {
+  std::unique_lock<std::mutex> own(owner, std::try_to_lock);
+  if (!own) return false;
+  size_t helpers;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    fn = &body;
+    n = count;
+    next = 0;
+    helpers = tickets = std::min(workers.size(), std::min(threads, count) - 1);
+  }
+  for (size_t h = 0; h < helpers; h++) wake.notify_one();
+  for (size_t i = next++; i < count; i = next++) body(i);
+  std::unique_lock<std::mutex> lock(mutex);
+  tickets = 0;
+  idle.wait(lock, [&]() { return running == 0; });
+  return true;
+}
+
+/**
+ *  Splits points[begin, end) into k parts by median splits of the longer
+ *  side of their MBR, each part getting a share proportional to its number
+ *  of shards.
+ */
+static void kd_split_2d(std::vector<Point2D> &points, size_t begin, size_t end, size_t k,
+                        std::vector<std::vector<Point2D>> &parts) {
+  if (k == 1) {
+    parts.emplace_back(points.begin() + begin, points.begin() + end);
+    return;
+  }
+  Rectangle r = EMPTY_RECT;
+  for (size_t i = begin; i < end; i++) r = enlarge(r, points[i].loc);
+  bool by_x = (int64_t) r.ux - r.lx >= (int64_t) r.uy - r.ly;
+
+  size_t left = k / 2;
+  size_t mid = begin + (end - begin) * left / k;
+  std::nth_element(points.begin() + begin, points.begin() + mid, points.begin() + end,
+                   [by_x](const Point2D &a, const Point2D &b) {
+                     return by_x ? a.loc.x < b.loc.x : a.loc.y < b.loc.y;
+                   });
+  kd_split_2d(points, begin, mid, left, parts);
+  kd_split_2d(points, mid, end, k - left, parts);
+}
+
+/**
+ *  Splits the points into k parts.
+ */
+static std::vector<std::vector<Point2D>> split_2d(std::vector<Point2D> points, size_t k,
+                                                  ShardSplit2D split) {
+  std::vector<std::vector<Point2D>> parts;
+  parts.reserve(k);
+  if (split == SHARD2D_KD) {
+    kd_split_2d(points, 0, points.size(), k, parts);
+    return parts;
+  }
+  std::sort(points.begin(), points.end());
+  for (size_t i = 0; i < k; i++) {
+    parts.emplace_back(points.begin() + points.size() * i / k,
+                       points.begin() + points.size() * (i + 1) / k);
+  }
+  return parts;
+}
+
+/**
+ *  Creates an empty tree.
+ */
+ShardedTree2D::ShardedTree2D() : root(nullptr), total(0) {}
+
+/**
+ *  Frees the shards.
+ */
+ShardedTree2D::~ShardedTree2D() {
+  delete_2d_tree(root);
+}
+
+/**
+ *  Splits the points into shards and builds them in parallel.
+ */
+bool ShardedTree2D::build(const std::vector<Point2D> &points, size_t count, size_t capacity,
+                          ShardSplit2D split, size_t threads, const AttributeStore *attrs) {
+  if (points.empty() || count == 0 || capacity < 2) {
+    std::cerr << "Error: cannot build a sharded tree with " << points.size() << " points, "
+              << count << " shards and capacity " << capacity << std::endl;
+    return false;
+  }
+  delete_2d_tree(root);
+  root = nullptr;
+
+  std::vector<std::vector<Point2D>> parts = split_2d(points, std::min(count, points.size()), split);
+  shards.assign(parts.size(), nullptr);
+  parallel_for_2d(parts.size(), threads, [&](size_t i) {
+    shards[i] = build_2d_tree(parts[i], capacity, attrs);
+    std::vector<Point2D>().swap(parts[i]);
+  });
+
+  root = make_internal_2d(shards);
+  total = points.size();
+  
+  // Query threads beyond the hardware threads only add switches. The
+  // calling thread takes part in queries, so it needs one worker less.
+  size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min(std::min(threads == 0 ? hardware : threads, hardware), shards.size());
+  if (!pool || pool->size() != threads - 1) pool.reset(new ShardPool2D(threads - 1));
+  return true;
+}
+
+/**
+ *  Queries the shards overlapping the query on the workers and gathers their VOs.
+ */
+VObject2D *ShardedTree2D::query(const Rectangle &query, size_t threads, size_t *dispatched,
+                                QueryStats2D *stats) const {
+  if (dispatched) *dispatched = 0;
+  if (!root) return nullptr;
+  if (stats) stats->nodes_visited++;
+  if (!overlap(root->getRect(), query)) {
+    if (stats) stats->nodes_pruned++;
+    return new VPruned2D(root->getRect(), root->getHash());
+  }
+
+  // Shards outside the query are pruned here, the others are scattered.
+  std::vector<VObject2D*> vos(shards.size(), nullptr);
+  std::vector<size_t> hits;
+  for (size_t i = 0; i < shards.size(); i++) {
+    if (shards[i]->getType() == N2D_INT && !overlap(shards[i]->getRect(), query)) {
+      vos[i] = new VPruned2D(shards[i]->getRect(), shards[i]->getHash());
+      if (stats) {
+        stats->nodes_visited++;
+        stats->nodes_pruned++;
+      }
+    } else {
+      hits.push_back(i);
+    }
+  }
+  std::vector<QueryStats2D> shard_stats(hits.size());
+  std::function<void(size_t)> scatter = [&](size_t j) {
+    vos[hits[j]] = range_query_2d(shards[hits[j]], query, stats ? &shard_stats[j] : nullptr);
+  };
+  if (threads == 0) threads = pool->size() + 1;
+  if (hits.size() <= 1 || threads <= 1 || !pool->run(hits.size(), threads, scatter)) {
+    for (size_t j = 0; j < hits.size(); j++) scatter(j);
+  }
+
+  VContainer2D *container = new VContainer2D();
+  for (VObject2D *vo : vos) container->append(vo);
+  if (stats) {
+    for (const QueryStats2D &s : shard_stats) {
+      stats->nodes_visited += s.nodes_visited;
+      stats->nodes_pruned += s.nodes_pruned;
+      stats->points_examined += s.points_examined;
+    }
+  }
+  if (dispatched) *dispatched = hits.size();
+  return container;
+}
@@ -0,0 +1,148 @@
+/**
+ *  @file Shard2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Spatially sharded MR-tree with scatter-gather queries.
+ *
+ *  The points are split into K shards, either into K runs of consecutive
+ *  Morton codes or by k-d splits at the median of the longer side, and
+ *  each shard is built with build_2d_tree on its own thread. A combined
+ *  root commits to the shard roots exactly as make_internal_2d commits to
+ *  its children. A query is sent only to the shards it overlaps, which
+ *  run concurrently on worker threads kept by the tree, and their VOs are
+ *  gathered under one container, so the combined VO verifies with
+ *  verify_2d against the combined root.
+ */
+
+#ifndef SHARD2D_H
+#define SHARD2D_H
+
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ *  Ways of splitting the points into shards.
+ */
+enum ShardSplit2D {SHARD2D_MORTON, SHARD2D_KD};
+
+/**
+ *  Persistent worker threads running the shard queries of one query at a
+ *  time. Starting threads per query costs more than a small query.
+ */
+class ShardPool2D {
+private:
+  std::vector<std::thread> workers;
+  std::mutex owner;                      ///< Held by the thread running a loop
+  std::mutex mutex;
+  std::condition_variable wake;          ///< Signals a new loop or shutdown
+  std::condition_variable idle;          ///< Signals that the helpers are done
+  const std::function<void(size_t)> *fn; ///< Body of the current loop
+  size_t n;                              ///< Iterations of the current loop
+  std::atomic<size_t> next;              ///< Next iteration to run
+  size_t tickets;                        ///< Helpers wanted but not started yet
+  size_t running;                        ///< Helpers started and not done yet
+  bool stop;
+
+  void work();
+
+public:
+  /**
+   *  Starts the workers.
+   *  @param size the number of worker threads
+   */
+  explicit ShardPool2D(size_t size);
+
+  /**
+   *  Stops and joins the workers.
+   */
+  ~ShardPool2D();
+
+  ShardPool2D(const ShardPool2D &) = delete;
+  ShardPool2D &operator=(const ShardPool2D &) = delete;
+
+  size_t size() const { return workers.size(); }
+
+  /**
+   *  Runs fn(i) for i in [0, n) on the calling thread and up to threads - 1
+   *  workers, and waits for all iterations.
+   *  @return false, without running anything, if another thread is
+   *          running a loop on the pool
+   */
+  bool run(size_t n, size_t threads, const std::function<void(size_t)> &fn);
+};
+
+/**
+ *  MR-tree made of independent shards under a combined root.
+ */
+class ShardedTree2D {
+private:
+  std::vector<Node2D*> shards;       ///< Roots of the shards
+  Node2D *root;                      ///< Combined root, whose children are the shards
+  size_t total;                      ///< Number of points
+  std::unique_ptr<ShardPool2D> pool; ///< Query workers
+
+public:
+  ShardedTree2D();
+
+  /**
+   *  Frees the shards.
+   */
+  ~ShardedTree2D();
+
+  ShardedTree2D(const ShardedTree2D &) = delete;
+  ShardedTree2D &operator=(const ShardedTree2D &) = delete;
+
+  /**
+   *  Splits the points into shards and builds them in parallel.
+   *  @param points the points
+   *  @param count the number of shards (fewer if there are fewer points)
+   *  @param capacity the page capacity of the shards
+   *  @param split how the points are split
+   *  @param threads the number of build threads, and of query threads kept
+   *         for the tree, at most one per hardware thread (0 = one per
+   *         hardware thread)
+   *  @param attrs optional attribute store whose payloads the leaves commit to
+   *  @return false if there are no points or the parameters are invalid
+   */
+  bool build(const std::vector<Point2D> &points, size_t count, size_t capacity,
+             ShardSplit2D split = SHARD2D_KD, size_t threads = 0,
+             const AttributeStore *attrs = nullptr);
+
+  /**
+   *  Performs a range query on the shards overlapping the query, in
+   *  parallel, and combines their VOs. The result is the VO range_query_2d
+   *  returns for the combined root. A single shard, or a query made while
+   *  another one uses the workers, runs on the calling thread.
+   *  @param query the query rectangle
+   *  @param threads the number of query threads, at most those kept by
+   *         build (0 = all of them)
+   *  @param dispatched if not null, set to the number of shards queried
+   *  @param stats optional statistics collector
+   *  @return verification object for the query, nullptr if the tree is empty
+   */
+  VObject2D *query(const Rectangle &query, size_t threads = 0, size_t *dispatched = nullptr,
+                   QueryStats2D *stats = nullptr) const;
+
+  /**
+   *  Returns the combined root.
+   */
+  Node2D *getRoot() const { return root; }
+
+  /**
+   *  Returns the digest of the combined root.
+   */
+  hash_t getHash() const { return root ? root->getHash() : hash_t{}; }
+
+  size_t size() const { return total; }
+  size_t countShards() const { return shards.size(); }
+  Node2D *getShard(size_t i) const { return shards.at(i); }
+};
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ *  @file TestAppend.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for appends with resumable digests on the right spine
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "Append2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> [checkpoints] [num_queries]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points, appended in file order" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  checkpoints: number of points at which the tree is checked (default: 10)" << std::endl;
+  std::cout << "  num_queries: number of random queries per checkpoint (default: 20)" << std::endl;
+}
+
+/**
+ *  Returns the bytes a from-scratch rehash of the right spine would hash.
+ */
+static uint64_t spine_bytes(Node2D *node) {
+  uint64_t bytes = 0;
+  while (node->getType() == N2D_INT) {
+    IntNode2D *internal = static_cast<IntNode2D*>(node);
+    bytes += internal->size() * (4 * sizeof(int32_t) + SHA256_DIGEST_LENGTH);
+    node = internal->getChildren().back();
+  }
+  return bytes + static_cast<LeafNode2D*>(node)->size() * (sizeof(uint32_t) + 2 * sizeof(int32_t));
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 3) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  size_t checkpoints = (argc > 3) ? std::max<size_t>(1, std::stoul(argv[3])) : 10;
+  size_t num_queries = (argc > 4) ? std::stoul(argv[4]) : 20;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  // Plain appends, timed apart from the checks.
+  AppendTree2D timed(capacity);
+  auto append_start = high_resolution_clock::now();
+  if (!timed.append(points)) return 1;
+  auto append_end = high_resolution_clock::now();
+  auto bulk_start = high_resolution_clock::now();
+  Node2D *bulk = build_sorted_2d_tree(points, capacity);
+  auto bulk_end = high_resolution_clock::now();
+
+  size_t failures = 0;
+  if (timed.getHash() != bulk->getHash() || (int) timed.getHeight() != height_2d_tree(bulk)) failures++;
+  delete_2d_tree(bulk);
+
+  // Checkpoints: the tree must equal the bulk build of the prefix.
+  AppendTree2D tree(capacity);
+  uint64_t rehash_bytes = 0;
+  size_t next = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    tree.append(points[i]);
+    rehash_bytes += spine_bytes(tree.getRoot());
+    if (i + 1 < points.size() && i + 1 < (next + 1) * points.size() / checkpoints) continue;
+    next++;
+
+    std::vector<Point2D> prefix(points.begin(), points.begin() + i + 1);
+    Node2D *reference = build_sorted_2d_tree(prefix, capacity);
+    if (tree.getHash() != reference->getHash()) failures++;
+    for (const Rectangle &q : generate_random_queries_2d(compute_mbr(prefix), num_queries)) {
+      VObject2D *vo = range_query_2d(tree.getRoot(), q);
+      VResult2D *res = verify_2d(vo, q);
+      if (!res || res->getHash() != tree.getHash() || res->count() != count_in_range(prefix, q)) failures++;
+      delete res;
+      delete_vo_2d(vo);
+    }
+    delete_2d_tree(reference);
+  }
+
+  const AppendStats2D &stats = tree.getStats();
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== Appends with resumable digests ===" << std::endl;
+  std::cout << "Points: " << stats.appends << ", height: " << tree.getHeight() << std::endl;
+  std::cout << "Bytes hashed per append: " << (double) stats.hashed_bytes / stats.appends
+            << " (from-scratch spine rehash: " << (double) rehash_bytes / stats.appends << ")" << std::endl;
+  std::cout << "Digests per append: " << (double) stats.digests / stats.appends << std::endl;
+  std::cout << "Average append time: "
+            << duration_cast<nanoseconds>(append_end - append_start).count() / 1000.0 / points.size() << " μs" << std::endl;
+  std::cout << "Bulk build time: " << duration_cast<microseconds>(bulk_end - bulk_start).count() << " μs" << std::endl;
+
+  if (failures == 0) std::cout << "✓ The appended tree matches the bulk build at every checkpoint" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
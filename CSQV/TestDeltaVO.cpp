@@ -0,0 +1,147 @@
+/**
+ *  @file TestDeltaVO.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for delta verification objects, simulating a map client
+ *  panning and zooming over the data
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "Delta2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <num_moves> [window]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  num_moves: number of pan and zoom moves of the client window" << std::endl;
+  std::cout << "  window: window size as fraction of the data MBR (default: 0.05)" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  size_t num_moves = std::stoul(argv[3]);
+  double window = (argc > 4) ? std::stod(argv[4]) : 0.05;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+  hash_t trusted = root->getHash();
+
+  // The window starts at the centre; each move pans by a tenth of its size
+  // or zooms in or out by 10%.
+  Rectangle mbr = compute_mbr(points);
+  double w = (mbr.ux - (double) mbr.lx) * window;
+  double h = (mbr.uy - (double) mbr.ly) * window;
+  double cx = ((double) mbr.lx + mbr.ux) / 2, cy = ((double) mbr.ly + mbr.uy) / 2;
+  std::mt19937 gen(std::random_device{}());
+  std::uniform_int_distribution<int> move(0, 5);
+
+  ViewportClient2D client(trusted);
+  size_t failures = 0;
+  size_t full_bytes = 0, delta_bytes = 0;
+  double full_us = 0, delta_us = 0;
+
+  for (size_t i = 0; i < num_moves; i++) {
+    int m = move(gen);
+    if (m == 0) cx += w / 10;
+    else if (m == 1) cx -= w / 10;
+    else if (m == 2) cy += h / 10;
+    else if (m == 3) cy -= h / 10;
+    else {
+      double f = (m == 4) ? 0.9 : 1.1;
+      w *= f;
+      h *= f;
+    }
+    cx = std::min<double>(std::max<double>(cx, mbr.lx), mbr.ux);
+    cy = std::min<double>(std::max<double>(cy, mbr.ly), mbr.uy);
+    Rectangle q = {(int32_t) std::max<double>(cx - w / 2, INT32_MIN),
+                   (int32_t) std::max<double>(cy - h / 2, INT32_MIN),
+                   (int32_t) std::min<double>(cx + w / 2, INT32_MAX),
+                   (int32_t) std::min<double>(cy + h / 2, INT32_MAX)};
+
+    VObject2D *full = range_query_2d(root, q);
+    auto full_start = high_resolution_clock::now();
+    VResult2D *expected = verify_2d(full, q);
+    auto full_end = high_resolution_clock::now();
+    full_us += duration_cast<nanoseconds>(full_end - full_start).count() / 1000.0;
+    full_bytes += vo_size_2d(full);
+
+    VObject2D *delta = range_query_delta_2d(root, q, client.getPrevious(), client.getRoot());
+    auto delta_start = high_resolution_clock::now();
+    VResult2D *res = client.verify(delta, q);
+    auto delta_end = high_resolution_clock::now();
+    delta_us += duration_cast<nanoseconds>(delta_end - delta_start).count() / 1000.0;
+    delta_bytes += vo_size_2d(delta);
+
+    std::vector<Point2D> want;
+    range_query_fast_2d(root, q, want);
+    if (!res || expected->getHash() != trusted || res->count() != want.size()) failures++;
+    delete res;
+    delete expected;
+    delete_vo_2d(full);
+    delete_vo_2d(delta);
+  }
+
+  // Windows starting on the right edge of a subtree: the subtree only
+  // touches the window, which a strict overlap test would prune, although
+  // its rightmost points match.
+  std::vector<Node2D*> edges;
+  if (root->getType() != N2D_LEAF) edges = static_cast<IntNode2D*>(root)->getChildren();
+  for (Node2D *node : edges) {
+    Rectangle r = node->getRect();
+    Rectangle q = {r.ux, r.ly, (int32_t) std::min<double>(r.ux + w, INT32_MAX), r.uy};
+    std::vector<Point2D> want;
+    range_query_fast_2d(root, q, want);
+    VObject2D *delta = range_query_delta_2d(root, q, client.getPrevious(), client.getRoot());
+    VResult2D *res = client.verify(delta, q);
+    if (!res || res->count() != want.size()) failures++;
+    delete res;
+    delete_vo_2d(delta);
+  }
+
+  // A delta VO must be rejected by a client that does not hold the previous window.
+  if (client.hasPrevious()) {
+    Rectangle prev = client.getPrevious();
+    Rectangle q = {prev.lx + (prev.ux - prev.lx) / 10, prev.ly, prev.ux + (prev.ux - prev.lx) / 10, prev.uy};
+    VObject2D *full = range_query_2d(root, q);
+    VObject2D *delta = range_query_delta_2d(root, q, prev, trusted);
+    ViewportClient2D fresh(trusted);
+    VResult2D *res = fresh.verify(delta, q);
+    if (res && count_points_2d(delta) < count_points_2d(full)) failures++;
+    delete res;
+    delete_vo_2d(full);
+    delete_vo_2d(delta);
+  }
+  delete_2d_tree(root);
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== Delta VO ===" << std::endl;
+  std::cout << "Average full VO size: " << (double) full_bytes / num_moves << " bytes" << std::endl;
+  std::cout << "Average delta VO size: " << (double) delta_bytes / num_moves << " bytes ("
+            << (full_bytes ? 100.0 * delta_bytes / full_bytes : 0) << "%)" << std::endl;
+  std::cout << "Average full verification time: " << full_us / num_moves << " μs" << std::endl;
+  std::cout << "Average delta verification time: " << delta_us / num_moves << " μs" << std::endl;
+  std::cout << "Leaves cached by the client: " << client.countCachedLeaves() << std::endl;
+
+  if (failures == 0) std::cout << "✓ All delta answers match the full answers" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
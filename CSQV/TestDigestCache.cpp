@@ -0,0 +1,133 @@
+/**
+ *  @file TestDigestCache.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for the client-side verified-digest cache, simulating a
+ *  map client panning over the data
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <num_moves> [window] [cache_kb]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  num_moves: number of pan moves of the client window" << std::endl;
+  std::cout << "  window: window size as fraction of the data MBR (default: 0.05)" << std::endl;
+  std::cout << "  cache_kb: byte budget of the cache in KB (default: 16384)" << std::endl;
+}
+
+/**
+ *  Returns the first leaf of a verification object.
+ */
+static VLeaf2D *first_leaf(VObject2D *vo) {
+  if (!vo) return nullptr;
+  if (vo->getType() == V2D_LEAF) return static_cast<VLeaf2D*>(vo);
+  if (vo->getType() == V2D_CONTAINER) {
+    for (VObject2D *child : static_cast<VContainer2D*>(vo)->getChildren()) {
+      VLeaf2D *leaf = first_leaf(child);
+      if (leaf) return leaf;
+    }
+  }
+  return nullptr;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  size_t num_moves = std::stoul(argv[3]);
+  double window = (argc > 4) ? std::stod(argv[4]) : 0.05;
+  size_t cache_bytes = ((argc > 5) ? std::stoul(argv[5]) : 16384) * 1024;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+  hash_t trusted = root->getHash();
+
+  // The window starts at the centre and pans by a tenth of its size.
+  Rectangle mbr = compute_mbr(points);
+  int64_t w = (int64_t) ((mbr.ux - (int64_t) mbr.lx) * window);
+  int64_t h = (int64_t) ((mbr.uy - (int64_t) mbr.ly) * window);
+  int64_t cx = ((int64_t) mbr.lx + mbr.ux) / 2, cy = ((int64_t) mbr.ly + mbr.uy) / 2;
+  std::mt19937 gen(std::random_device{}());
+  std::uniform_int_distribution<int> dir(0, 3);
+
+  DigestCache2D cache(cache_bytes);
+  size_t failures = 0;
+  double plain_us = 0, cached_us = 0;
+
+  for (size_t i = 0; i < num_moves; i++) {
+    int d = dir(gen);
+    cx += (d == 0) ? w / 10 : (d == 1) ? -w / 10 : 0;
+    cy += (d == 2) ? h / 10 : (d == 3) ? -h / 10 : 0;
+    cx = std::min<int64_t>(std::max<int64_t>(cx, mbr.lx), mbr.ux);
+    cy = std::min<int64_t>(std::max<int64_t>(cy, mbr.ly), mbr.uy);
+    Rectangle q = {(int32_t) std::max<int64_t>(cx - w / 2, INT32_MIN),
+                   (int32_t) std::max<int64_t>(cy - h / 2, INT32_MIN),
+                   (int32_t) std::min<int64_t>(cx + w / 2, INT32_MAX),
+                   (int32_t) std::min<int64_t>(cy + h / 2, INT32_MAX)};
+
+    // The two verifications take turns going first, so neither gets warmer CPU caches.
+    VObject2D *vo = range_query_2d(root, q);
+    VResult2D *plain = nullptr, *cached = nullptr;
+    for (int k = 0; k < 2; k++) {
+      auto start = high_resolution_clock::now();
+      bool run_plain = (k == (int) (i % 2));
+      if (run_plain) plain = verify_2d(vo, q);
+      else cached = verify_cached_2d(vo, q, cache, trusted);
+      double us = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+      (run_plain ? plain_us : cached_us) += us;
+    }
+
+    if (plain->getHash() != trusted || cached->getHash() != trusted ||
+        cached->count() != plain->count()) failures++;
+    delete plain;
+    delete cached;
+    delete_vo_2d(vo);
+  }
+
+  // A tampered leaf must not be accepted, even when its original is cached.
+  Rectangle q = {(int32_t) (cx - w / 2), (int32_t) (cy - h / 2), (int32_t) (cx + w / 2), (int32_t) (cy + h / 2)};
+  VObject2D *vo = range_query_2d(root, q);
+  VResult2D *warm = verify_cached_2d(vo, q, cache, trusted);
+  delete warm;
+  VLeaf2D *leaf = first_leaf(vo);
+  if (leaf) {
+    std::vector<Point2D> forged = leaf->getPoints();
+    forged[0].loc.x++;
+    *leaf = VLeaf2D(forged);
+    VResult2D *res = verify_cached_2d(vo, q, cache, trusted);
+    if (res->getHash() == trusted) failures++;
+    delete res;
+  }
+  delete_vo_2d(vo);
+  delete_2d_tree(root);
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== Digest cache ===" << std::endl;
+  std::cout << "Average verification time without cache: " << plain_us / num_moves << " μs" << std::endl;
+  std::cout << "Average verification time with cache: " << cached_us / num_moves << " μs" << std::endl;
+  std::cout << "Hit rate: " << cache.hitRate() * 100 << "%, " << cache.size() << " entries, "
+            << cache.sizeInBytes() << " bytes, " << cache.getEvictions() << " evictions" << std::endl;
+
+  if (failures == 0) std::cout << "✓ All answers verified and the forged leaf was rejected" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
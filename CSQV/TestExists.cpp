@@ -0,0 +1,115 @@
+/**
+ *  @file TestExists.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for verified existence queries
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "Exists2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <num_queries> <capacity>" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  num_queries: number of random queries, half of them tiny (mostly empty)" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t num_queries = std::stoul(argv[2]);
+  size_t capacity = std::stoul(argv[3]);
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  Rectangle mbr = compute_mbr(points);
+  std::vector<Rectangle> queries = generate_random_queries_2d(mbr, num_queries - num_queries / 2);
+  std::mt19937 gen(std::random_device{}());
+  std::uniform_int_distribution<int32_t> xs(mbr.lx, mbr.ux), ys(mbr.ly, mbr.uy);
+  int32_t w = std::max<int32_t>(1, (int32_t) ((mbr.ux - (int64_t) mbr.lx) / 1000));
+  int32_t h = std::max<int32_t>(1, (int32_t) ((mbr.uy - (int64_t) mbr.ly) / 1000));
+  for (size_t i = 0; i < num_queries / 2; i++) {
+    int32_t x = xs(gen), y = ys(gen);
+    queries.push_back({x, y, (int32_t) std::min<int64_t>((int64_t) x + w, INT32_MAX),
+                       (int32_t) std::min<int64_t>((int64_t) y + h, INT32_MAX)});
+  }
+
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+  hash_t trusted = root->getHash();
+
+  size_t failures = 0, found = 0;
+  size_t exists_bytes = 0, empty_bytes = 0, full_bytes = 0, empty_full_bytes = 0;
+  double exists_us = 0, full_us = 0;
+
+  for (const Rectangle &q : queries) {
+    bool expected = count_in_range(points, q) > 0;
+
+    auto exists_start = high_resolution_clock::now();
+    VObject2D *vo = exists_query_2d(root, q);
+    VResult2D *res = verify_exists_2d(vo, q);
+    auto full_start = high_resolution_clock::now();
+    VObject2D *full = range_query_2d(root, q);
+    VResult2D *all = verify_2d(full, q);
+    auto full_end = high_resolution_clock::now();
+    exists_us += duration_cast<nanoseconds>(full_start - exists_start).count() / 1000.0;
+    full_us += duration_cast<nanoseconds>(full_end - full_start).count() / 1000.0;
+
+    if (!res || res->getHash() != trusted || (res->count() > 0) != expected ||
+        (expected && !contains(res->getPoints()[0], q))) failures++;
+    if (expected) {
+      found++;
+      exists_bytes += vo_size_2d(vo);
+      full_bytes += vo_size_2d(full);
+    } else {
+      empty_bytes += vo_size_2d(vo);
+      empty_full_bytes += vo_size_2d(full);
+    }
+
+    delete res;
+    delete all;
+    delete_vo_2d(vo);
+    delete_vo_2d(full);
+  }
+
+  // A pruned root rebuilds the trusted root but must not prove emptiness.
+  const Point2D &p = points[0];
+  Rectangle q = {p.loc.x, p.loc.y, p.loc.x, p.loc.y};
+  VPruned2D forged(root->getRect(), trusted);
+  VResult2D *res = verify_exists_2d(&forged, q);
+  if (res) failures++;
+  delete res;
+  delete_2d_tree(root);
+
+  size_t empty = queries.size() - found;
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== Existence queries ===" << std::endl;
+  std::cout << "Non-empty: " << found << ", empty: " << empty << std::endl;
+  std::cout << "Average existence proof: " << (found ? (double) exists_bytes / found : 0)
+            << " bytes (full VO: " << (found ? (double) full_bytes / found : 0) << " bytes)" << std::endl;
+  std::cout << "Average emptiness proof: " << (empty ? (double) empty_bytes / empty : 0)
+            << " bytes (full VO: " << (empty ? (double) empty_full_bytes / empty : 0) << " bytes)" << std::endl;
+  std::cout << "Average existence query and verification time: " << exists_us / queries.size() << " μs" << std::endl;
+  std::cout << "Average full query and verification time: " << full_us / queries.size() << " μs" << std::endl;
+
+  if (failures == 0) std::cout << "✓ All existence answers are correct" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
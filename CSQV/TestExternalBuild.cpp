@@ -0,0 +1,96 @@
+/**
+ *  @file TestExternalBuild.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for the external-memory bulk build
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "ExternalBuild2D.hpp"
+#include <cstdio>
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <memory_kb> <page_file> [tmp_dir] [num_queries]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  memory_kb: memory budget of sorting and merging in KB" << std::endl;
+  std::cout << "  page_file: page file to build" << std::endl;
+  std::cout << "  tmp_dir: directory of the temporary run files (default: .)" << std::endl;
+  std::cout << "  num_queries: number of random queries checked on the result (default: 100)" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 5) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  size_t memory = std::stoul(argv[3]) * 1024;
+  std::string page_file = argv[4];
+  std::string tmp_dir = (argc > 5) ? argv[5] : ".";
+  size_t num_queries = (argc > 6) ? std::stoul(argv[6]) : 100;
+
+  ExternalBuildConfig2D config = {capacity, memory, tmp_dir, PAGE2D_DEFAULT_SIZE};
+  ExternalBuildStats2D stats;
+  auto build_start = high_resolution_clock::now();
+  bool built = external_build_2d(data_file, page_file, config, &stats);
+  auto build_end = high_resolution_clock::now();
+
+  PagedTree2D tree;
+  if (!built || !tree.open(page_file, 64)) {
+    std::cerr << "Error: external build failed" << std::endl;
+    return 1;
+  }
+
+  // Reference: the in-memory build over the same order.
+  std::vector<Point2D> points = load_points_file(data_file);
+  std::sort(points.begin(), points.end(), external_less_2d);
+  auto memory_start = high_resolution_clock::now();
+  Node2D *root = build_sorted_2d_tree(points, capacity);
+  auto memory_end = high_resolution_clock::now();
+
+  size_t failures = 0;
+  if (tree.getHash() != root->getHash() || tree.size() != points.size()) failures++;
+
+  for (const Rectangle &q : generate_random_queries_2d(compute_mbr(points), num_queries)) {
+    VObject2D *vo = range_query_paged_2d(tree, q);
+    VResult2D *res = vo ? verify_2d(vo, q) : nullptr;
+    VResult2D *expected = query_and_verify_2d(root, q);
+    if (!res || res->getHash() != tree.getHash() || res->count() != expected->count()) failures++;
+    delete res;
+    delete expected;
+    delete_vo_2d(vo);
+  }
+  delete_2d_tree(root);
+
+  // Runs that cannot be written must fail the build, not shorten the tree.
+  if (stats.runs > 0) {
+    ExternalBuildConfig2D bad = config;
+    bad.tmp_dir = tmp_dir + "/csqv-missing-dir";
+    if (external_build_2d(data_file, page_file + ".bad", bad)) failures++;
+    std::remove((page_file + ".bad").c_str());
+  }
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== External build (budget " << memory << " bytes) ===" << std::endl;
+  std::cout << "Points: " << stats.points << ", runs: " << stats.runs
+            << ", intermediate merge passes: " << stats.merge_passes << std::endl;
+  std::cout << "Peak sort/merge buffers: " << stats.peak_bytes << " bytes (points: "
+            << stats.points * sizeof(Point2D) << " bytes), spilled: " << stats.spilled_bytes << " bytes" << std::endl;
+  std::cout << "External build time: " << duration_cast<milliseconds>(build_end - build_start).count() << " ms" << std::endl;
+  std::cout << "In-memory build time: " << duration_cast<milliseconds>(memory_end - memory_start).count() << " ms" << std::endl;
+
+  if (failures == 0) std::cout << "✓ The external build matches the in-memory build" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
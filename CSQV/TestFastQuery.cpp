@@ -0,0 +1,97 @@
+/**
+ *  @file TestFastQuery.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program comparing the unauthenticated range query with the
+ *  authenticated one
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <query_file|num_queries> <capacity>" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  query_file: CSV file with format lx,ly,ux,uy,matching,fraction" << std::endl;
+  std::cout << "  num_queries: number of random queries (instead of a query file)" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  std::string query_arg = argv[2];
+  size_t capacity = std::stoul(argv[3]);
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  std::vector<Rectangle> queries;
+  if (query_arg.find_first_not_of("0123456789") == std::string::npos) {
+    queries = generate_random_queries_2d(compute_mbr(points), std::stoul(query_arg));
+  } else {
+    queries = load_queries_2d(query_arg);
+  }
+  if (queries.empty()) {
+    std::cerr << "Error: No queries loaded" << std::endl;
+    return 1;
+  }
+
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+
+  double verified_us = 0, fast_us = 0, callback_us = 0;
+  size_t failures = 0, returned = 0;
+  std::vector<Point2D> out;
+
+  for (const Rectangle &q : queries) {
+    size_t expected = count_in_range(points, q);
+
+    auto verified_start = high_resolution_clock::now();
+    VResult2D *res = query_and_verify_2d(root, q);
+    auto fast_start = high_resolution_clock::now();
+    out.clear();
+    size_t n = range_query_fast_2d(root, q, out);
+    auto callback_start = high_resolution_clock::now();
+    size_t counted = 0;
+    range_query_fast_2d(root, q, [&counted](const Point2D &) { counted++; });
+    auto callback_end = high_resolution_clock::now();
+
+    verified_us += duration_cast<nanoseconds>(fast_start - verified_start).count() / 1000.0;
+    fast_us += duration_cast<nanoseconds>(callback_start - fast_start).count() / 1000.0;
+    callback_us += duration_cast<nanoseconds>(callback_end - callback_start).count() / 1000.0;
+
+    bool inside = true;
+    for (const Point2D &p : out) inside = inside && contains(p, q);
+    if (n != expected || counted != expected || !inside || res->count() > expected) failures++;
+    returned += n;
+    delete res;
+  }
+  delete_2d_tree(root);
+
+  size_t m = queries.size();
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== Unauthenticated range query ===" << std::endl;
+  std::cout << "Average points returned: " << (double) returned / m << std::endl;
+  std::cout << "Average query_and_verify_2d time: " << verified_us / m << " μs" << std::endl;
+  std::cout << "Average fast query time (vector): " << fast_us / m << " μs" << std::endl;
+  std::cout << "Average fast query time (callback): " << callback_us / m << " μs" << std::endl;
+  std::cout << "Speedup: " << std::setprecision(1) << verified_us / fast_us << "x" << std::endl;
+
+  if (failures == 0) std::cout << "✓ All results match count_in_range" << std::endl;
+  else std::cout << "✗ " << failures << " queries failed" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
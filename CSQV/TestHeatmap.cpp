@@ -0,0 +1,138 @@
+/**
+ *  @file TestHeatmap.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for authenticated density heatmaps
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "Heatmap2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <cells> [num_areas]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  cells: number of grid cells along each axis" << std::endl;
+  std::cout << "  num_areas: number of random areas besides the whole data MBR (default: 20)" << std::endl;
+}
+
+/**
+ *  Encodes a summary nested in the given number of one-child containers.
+ */
+static std::vector<uint8_t> nested_heatmap_vo(uint32_t depth) {
+  VHeat2D *vo = new VHeat2D(Rectangle{0, 0, 0, 0}, 1, hash_t{});
+  for (uint32_t i = 0; i < depth; i++) {
+    VHeat2D *container = new VHeat2D();
+    container->append(vo);
+    vo = container;
+  }
+  std::vector<uint8_t> bytes;
+  serialize_heatmap_vo_2d(vo, bytes);
+  delete vo;
+  return bytes;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  uint32_t cells = (uint32_t) std::stoul(argv[3]);
+  size_t num_areas = (argc > 4) ? std::stoul(argv[4]) : 20;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty() || cells == 0) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+  auto build_start = high_resolution_clock::now();
+  CountTree2D tree(root);
+  auto build_end = high_resolution_clock::now();
+  hash_t trusted = tree.getHash();
+
+  Rectangle mbr = compute_mbr(points);
+  std::vector<Rectangle> areas = {mbr};
+  std::vector<Rectangle> random = generate_random_queries_2d(mbr, num_areas, 0.1, 0.5);
+  areas.insert(areas.end(), random.begin(), random.end());
+
+  size_t failures = 0, heat_bytes = 0, full_bytes = 0;
+  double heat_us = 0, full_us = 0;
+
+  for (const Rectangle &area : areas) {
+    HeatmapGrid2D grid = {area, cells, cells};
+
+    auto heat_start = high_resolution_clock::now();
+    VHeat2D *vo = heatmap_query_2d(tree, grid);
+    HeatmapResult2D res = verify_heatmap_2d(vo, grid);
+    auto full_start = high_resolution_clock::now();
+    VObject2D *full = range_query_2d(root, area);
+    VResult2D *all = verify_2d(full, area);
+    auto full_end = high_resolution_clock::now();
+    heat_us += duration_cast<nanoseconds>(full_start - heat_start).count() / 1000.0;
+    full_us += duration_cast<nanoseconds>(full_end - full_start).count() / 1000.0;
+    heat_bytes += heatmap_vo_size_2d(vo);
+    full_bytes += vo_size_2d(full);
+
+    if (!res.valid || res.hash != trusted || res.counts != heatmap_counts_2d(points, grid)) failures++;
+    delete vo;
+    delete all;
+    delete_vo_2d(full);
+  }
+
+  // Summarizing the whole tree must not pass unless the grid has one cell.
+  HeatmapGrid2D grid = {mbr, cells, cells};
+  const CountEntry2D &top = tree.getEntry(root);
+  VHeat2D forged(root->getRect(), top.count, top.hash);
+  HeatmapResult2D res = verify_heatmap_2d(&forged, grid);
+  if (res.valid && res.counts != heatmap_counts_2d(points, grid)) failures++;
+
+  // On a single cell over the data MBR the whole tree is one summary. Its
+  // count is bound by the trusted digest, so a forged total must not verify.
+  HeatmapGrid2D single = {mbr, 1, 1};
+  VHeat2D *honest = heatmap_query_2d(tree, single);
+  HeatmapResult2D total = verify_heatmap_2d(honest, single);
+  if (!total.valid || total.hash != trusted || total.counts[0] != points.size()) failures++;
+  delete honest;
+  VHeat2D forged_total(root->getRect(), 7, top.hash);
+  HeatmapResult2D bad = verify_heatmap_2d(&forged_total, single);
+  bool forged_rejected = !bad.valid || bad.hash != trusted;
+  if (!forged_rejected) failures++;
+  delete_2d_tree(root);
+
+  // Containers nested deeper than any tree must be rejected, not recursed into.
+  std::vector<uint8_t> deepest = nested_heatmap_vo(V2D_MAX_DEPTH), too_deep = nested_heatmap_vo(V2D_MAX_DEPTH + 1);
+  VHeat2D *accepted = deserialize_heatmap_vo_2d(deepest.data(), deepest.size());
+  VHeat2D *rejected = deserialize_heatmap_vo_2d(too_deep.data(), too_deep.size());
+  bool deep_rejected = !rejected;
+  if (!accepted || !deep_rejected) failures++;
+  delete accepted;
+  delete rejected;
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== Heatmap " << cells << "x" << cells << " ===" << std::endl;
+  std::cout << "Count-augmented commitment computed in "
+            << duration_cast<microseconds>(build_end - build_start).count() << " μs" << std::endl;
+  std::cout << "Average heatmap VO size: " << (double) heat_bytes / areas.size() << " bytes (range VO: "
+            << (double) full_bytes / areas.size() << " bytes)" << std::endl;
+  std::cout << "Average heatmap query and verification time: " << heat_us / areas.size() << " μs" << std::endl;
+  std::cout << "Average range query and verification time: " << full_us / areas.size() << " μs" << std::endl;
+
+  std::cout << (forged_rejected ? "✓ Forged root summary rejected" : "✗ Forged root summary accepted") << std::endl;
+  std::cout << (deep_rejected ? "✓ Over-deep VO rejected" : "✗ Over-deep VO accepted") << std::endl;
+  if (failures == 0) std::cout << "✓ All heatmaps match the brute-force counts" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
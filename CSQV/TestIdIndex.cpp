@@ -0,0 +1,122 @@
+/**
+ *  @file TestIdIndex.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for verified point lookups by ID
+ */
+
+#include "Point2D.hpp"
+#include "MBTree2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <fanout> <num_lookups> [range_width]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  fanout: entries per leaf and children per internal node" << std::endl;
+  std::cout << "  num_lookups: number of random lookups (half of them for absent IDs)" << std::endl;
+  std::cout << "  range_width: width of the ID-range scans (default: 100)" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t fanout = std::stoul(argv[2]);
+  size_t num_lookups = std::stoul(argv[3]);
+  uint32_t width = (argc > 4) ? std::stoul(argv[4]) : 100;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  auto build_start = high_resolution_clock::now();
+  MBTree2D tree(MBT_KEY_ID, fanout, points);
+  auto build_end = high_resolution_clock::now();
+  std::cout << "ID index built in "
+            << duration_cast<milliseconds>(build_end - build_start).count()
+            << " ms (height " << tree.height() << ")" << std::endl;
+  std::cout << "Root: " << toHex(tree.getHash()) << std::endl << std::endl;
+
+  std::mt19937 gen(std::random_device{}());
+  uint32_t max_id = 0;
+  for (const Point2D &p : points) max_id = std::max(max_id, p.id);
+  std::uniform_int_distribution<uint32_t> present(0, max_id);
+  std::uniform_int_distribution<uint32_t> absent(max_id + 1, max_id + 1000);
+
+  size_t failures = 0, found = 0, proof_bytes = 0;
+  double lookup_us = 0, verify_us = 0, scan_us = 0;
+
+  for (size_t i = 0; i < num_lookups; i++) {
+    uint32_t id = (i % 2 == 0) ? present(gen) : absent(gen);
+
+    auto lookup_start = high_resolution_clock::now();
+    MBProof2D proof = mb_lookup_2d(tree, id);
+    auto lookup_end = high_resolution_clock::now();
+    MBResult2D res = verify_mb_range_2d(proof, id, id);
+    auto verify_end = high_resolution_clock::now();
+
+    // Linear scan, the only access path of the spatial index.
+    size_t expected = 0;
+    for (const Point2D &p : points) expected += (p.id == id);
+    auto scan_end = high_resolution_clock::now();
+
+    lookup_us += duration_cast<nanoseconds>(lookup_end - lookup_start).count() / 1000.0;
+    verify_us += duration_cast<nanoseconds>(verify_end - lookup_end).count() / 1000.0;
+    scan_us += duration_cast<nanoseconds>(scan_end - verify_end).count() / 1000.0;
+    proof_bytes += mb_proof_size_2d(proof);
+
+    if (!res.valid || res.hash != tree.getHash() || res.points.size() != expected) failures++;
+    found += res.points.size();
+  }
+
+  // ID-range scans.
+  size_t range_failures = 0, range_points = 0;
+  for (size_t i = 0; i < num_lookups; i++) {
+    uint32_t lo = present(gen);
+    MBProof2D proof = mb_range_query_2d(tree, lo, (uint64_t) lo + width - 1);
+    MBResult2D res = verify_mb_range_2d(proof, lo, (uint64_t) lo + width - 1);
+    size_t expected = 0;
+    for (const Point2D &p : points) expected += (p.id >= lo && p.id - lo < width);
+    if (!res.valid || res.hash != tree.getHash() || res.points.size() != expected) range_failures++;
+    range_points += res.points.size();
+  }
+
+  // Malformed proofs must be rejected without reading out of bounds.
+  MBProof2D wrapped = mb_lookup_2d(tree, present(gen));
+  wrapped.runs = {{UINT64_MAX, 1}};
+  wrapped.entries.clear();
+  wrapped.digests.clear();
+  if (verify_mb_range_2d(wrapped, 0, UINT32_MAX).valid) range_failures++;
+  MBProof2D no_fanout = mb_lookup_2d(tree, present(gen));
+  no_fanout.fanout = 0;
+  if (verify_mb_range_2d(no_fanout, 0, UINT32_MAX).valid) range_failures++;
+
+  std::cout << "=== Lookups ===" << std::endl;
+  std::cout << "Lookups: " << num_lookups << " (" << found << " found)" << std::endl;
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "Average proof time: " << lookup_us / num_lookups << " μs" << std::endl;
+  std::cout << "Average verification time: " << verify_us / num_lookups << " μs" << std::endl;
+  std::cout << "Average linear scan time: " << scan_us / num_lookups << " μs" << std::endl;
+  std::cout << "Average proof size: " << std::setprecision(1)
+            << (double) proof_bytes / num_lookups << " bytes" << std::endl;
+  std::cout << "Average points per ID-range scan: "
+            << (double) range_points / num_lookups << std::endl;
+
+  if (failures == 0 && range_failures == 0) {
+    std::cout << "✓ All lookups and scans verified" << std::endl;
+  } else {
+    std::cout << "✗ " << failures << " lookups and " << range_failures
+              << " scans failed" << std::endl;
+  }
+  return (failures == 0 && range_failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+/**
+ *  @file TestIndexCompare.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Compares the MR-tree with the Z-order Merkle B+-tree on the same data
+ *  and queries: query and verification time, proof size and correctness.
+ */
+
+#include "Point2D.hpp"
+#include "Index2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <query_file|num_queries> <capacity> [max_intervals]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  query_file: CSV file with format lx,ly,ux,uy,matching,fraction" << std::endl;
+  std::cout << "  num_queries: number of random queries (instead of a query file)" << std::endl;
+  std::cout << "  capacity: leaf capacity of the MR-tree and fanout of the B+-tree" << std::endl;
+  std::cout << "  max_intervals: maximum Z-intervals per query (default: "
+            << DEFAULT_MAX_INTERVALS << ")" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  std::string query_arg = argv[2];
+  size_t capacity = std::stoul(argv[3]);
+  size_t max_intervals = (argc > 4) ? std::stoul(argv[4]) : DEFAULT_MAX_INTERVALS;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  std::vector<Rectangle> queries;
+  if (query_arg.find_first_not_of("0123456789") == std::string::npos) {
+    queries = generate_random_queries_2d(compute_mbr(points), std::stoul(query_arg));
+  } else {
+    queries = load_queries_2d(query_arg);
+  }
+  if (queries.empty()) {
+    std::cerr << "Error: No queries loaded" << std::endl;
+    return 1;
+  }
+
+  std::vector<size_t> expected(queries.size(), 0);
+  for (size_t i = 0; i < queries.size(); i++) {
+    for (const Point2D &p : points) expected[i] += contains(p, queries[i]);
+  }
+
+  std::vector<std::unique_ptr<SpatialIndex2D>> indexes;
+  std::vector<long long> build_ms;
+  for (int k = 0; k < 2; k++) {
+    auto build_start = high_resolution_clock::now();
+    if (k == 0) indexes.emplace_back(new MRTreeIndex2D(points, capacity));
+    else indexes.emplace_back(new MBTreeIndex2D(points, capacity, max_intervals));
+    auto build_end = high_resolution_clock::now();
+    build_ms.push_back(duration_cast<milliseconds>(build_end - build_start).count());
+  }
+
+  std::cout << "Points: " << points.size() << ", queries: " << queries.size()
+            << ", capacity: " << capacity << ", max intervals: " << max_intervals
+            << std::endl << std::endl;
+
+  size_t total_failures = 0;
+  for (size_t k = 0; k < indexes.size(); k++) {
+    const SpatialIndex2D &index = *indexes[k];
+    QueryStats2D stats;
+    size_t failures = 0, proof_bytes = 0, returned = 0;
+
+    for (size_t i = 0; i < queries.size(); i++) {
+      IndexResult2D res = index.query(queries[i], &stats);
+      proof_bytes += res.proof_bytes;
+      returned += res.points.size();
+      if (!res.valid || res.points.size() != expected[i]) failures++;
+    }
+
+    size_t n = queries.size();
+    std::cout << "=== " << index.getName() << " ===" << std::endl;
+    std::cout << "Build time: " << build_ms[k] << " ms" << std::endl;
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "Average query time: " << stats.query_time_us / (n * 1000.0) << " ms" << std::endl;
+    std::cout << "Average verification time: " << stats.verify_time_us / (n * 1000.0) << " ms" << std::endl;
+    std::cout << "Average total time: "
+              << (stats.query_time_us + stats.verify_time_us) / (n * 1000.0) << " ms" << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "Average proof size: " << proof_bytes / (n * 1024.0) << " KB" << std::endl;
+    std::cout << "Average points examined: " << (double) stats.points_examined / n << std::endl;
+    std::cout << "Average points returned: " << (double) returned / n << std::endl;
+    if (failures == 0) std::cout << "✓ All queries verified" << std::endl;
+    else std::cout << "✗ " << failures << " queries failed" << std::endl;
+    std::cout << std::endl;
+    total_failures += failures;
+  }
+
+  return total_failures == 0 ? 0 : 1;
+}
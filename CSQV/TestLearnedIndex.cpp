@@ -0,0 +1,128 @@
+/**
+ *  @file TestLearnedIndex.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for the learned model locating leaves of the Z-order
+ *  Merkle B+-tree
+ */
+
+#include "Point2D.hpp"
+#include "MBTree2D.hpp"
+#include "ZOrder2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <fanout> <num_queries> [epsilon]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  fanout: entries per leaf and children per internal node" << std::endl;
+  std::cout << "  num_queries: number of random lookups and rectangle queries" << std::endl;
+  std::cout << "  epsilon: maximum error of the model (default: "
+            << DEFAULT_LEARNED_EPSILON << ")" << std::endl;
+}
+
+/**
+ *  Runs rectangle queries, verifying every proof, and returns the average
+ *  proof time in microseconds.
+ */
+static double run_rect_queries(const MBTree2D &tree, const std::vector<Rectangle> &queries,
+                               std::vector<size_t> &sizes, size_t &failures) {
+  double query_us = 0;
+  for (size_t i = 0; i < queries.size(); i++) {
+    auto start = high_resolution_clock::now();
+    MBProof2D proof = mb_rect_query_2d(tree, queries[i]);
+    auto end = high_resolution_clock::now();
+    query_us += duration_cast<nanoseconds>(end - start).count() / 1000.0;
+
+    MBResult2D res = verify_mb_rect_2d(proof, queries[i]);
+    if (!res.valid || res.hash != tree.getHash()) failures++;
+    sizes.push_back(mb_proof_size_2d(proof));
+  }
+  return query_us / queries.size();
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t fanout = std::stoul(argv[2]);
+  size_t num_queries = std::stoul(argv[3]);
+  size_t epsilon = (argc > 4) ? std::stoul(argv[4]) : DEFAULT_LEARNED_EPSILON;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  MBTree2D tree(MBT_KEY_Z, fanout, points);
+  auto model_start = high_resolution_clock::now();
+  tree.buildModel(epsilon);
+  auto model_end = high_resolution_clock::now();
+  const LearnedIndex2D &model = tree.getModel();
+
+  // A separator-keyed B+-tree directory stores one key per leaf.
+  size_t leaves = tree.height() ? tree.getLevels()[0].size() : 0;
+  size_t directory_bytes = leaves * sizeof(uint64_t);
+  std::cout << "Entries: " << tree.size() << ", leaves: " << leaves
+            << ", height: " << tree.height() << std::endl;
+  std::cout << "Model built in " << duration_cast<microseconds>(model_end - model_start).count()
+            << " μs: " << model.countSegments() << " segments, epsilon " << model.getEpsilon()
+            << ", " << model.sizeInBytes() << " bytes" << std::endl;
+  std::cout << "Separator key directory: " << directory_bytes << " bytes" << std::endl << std::endl;
+
+  // Point lookups: half existing keys, half random keys in the key range.
+  const std::vector<uint64_t> &keys = tree.getKeys();
+  std::mt19937_64 gen(std::random_device{}());
+  std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+  std::uniform_int_distribution<uint64_t> any(keys.front(), keys.back());
+  std::vector<uint64_t> probes(num_queries);
+  for (size_t i = 0; i < num_queries; i++) probes[i] = (i % 2 == 0) ? keys[pick(gen)] : any(gen);
+
+  size_t mismatches = 0, sink = 0;
+  auto bin_start = high_resolution_clock::now();
+  for (uint64_t k : probes) sink += std::lower_bound(keys.begin(), keys.end(), k) - keys.begin();
+  auto bin_end = high_resolution_clock::now();
+  for (uint64_t k : probes) sink -= tree.lowerBound(k);
+  auto model_lookup_end = high_resolution_clock::now();
+  for (uint64_t k : probes) {
+    size_t expected = std::lower_bound(keys.begin(), keys.end(), k) - keys.begin();
+    if (tree.lowerBound(k) != expected) mismatches++;
+  }
+
+  std::cout << "=== Key lookups ===" << std::endl;
+  std::cout << std::fixed << std::setprecision(4);
+  std::cout << "Binary search: "
+            << duration_cast<nanoseconds>(bin_end - bin_start).count() / 1000.0 / num_queries
+            << " μs" << std::endl;
+  std::cout << "Learned model: "
+            << duration_cast<nanoseconds>(model_lookup_end - bin_end).count() / 1000.0 / num_queries
+            << " μs" << std::endl;
+
+  // Rectangle queries with and without the model must yield identical proofs.
+  std::vector<Rectangle> queries = generate_random_queries_2d(compute_mbr(points), num_queries);
+  std::vector<size_t> with_model, without_model;
+  size_t failures = 0;
+  double learned_us = run_rect_queries(tree, queries, with_model, failures);
+  tree.dropModel();
+  double binary_us = run_rect_queries(tree, queries, without_model, failures);
+  if (with_model != without_model) mismatches++;
+
+  std::cout << std::endl << "=== Rectangle queries ===" << std::endl;
+  std::cout << "Average proof time (binary search): " << binary_us << " μs" << std::endl;
+  std::cout << "Average proof time (learned model): " << learned_us << " μs" << std::endl;
+
+  if (mismatches == 0 && failures == 0 && sink == 0) {
+    std::cout << "✓ Learned lookups match binary search and all proofs verified" << std::endl;
+    return 0;
+  }
+  std::cout << "✗ " << mismatches << " mismatches, " << failures << " failed proofs" << std::endl;
+  return 1;
+}
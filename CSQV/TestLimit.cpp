@@ -0,0 +1,116 @@
+/**
+ *  @file TestLimit.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for verified LIMIT-N range queries in curve order
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "Limit2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <query_file|num_queries> <capacity> <limit>" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  query_file: CSV file with format lx,ly,ux,uy,matching,fraction" << std::endl;
+  std::cout << "  num_queries: number of random queries (instead of a query file)" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  limit: maximum number of points per query" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 5) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  std::string query_arg = argv[2];
+  size_t capacity = std::stoul(argv[3]);
+  size_t limit = std::stoul(argv[4]);
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  std::vector<Rectangle> queries;
+  if (query_arg.find_first_not_of("0123456789") == std::string::npos) {
+    queries = generate_random_queries_2d(compute_mbr(points), std::stoul(query_arg));
+  } else {
+    queries = load_queries_2d(query_arg);
+  }
+  if (queries.empty()) {
+    std::cerr << "Error: No queries loaded" << std::endl;
+    return 1;
+  }
+
+  // The build sorts tree_points, which is then the curve order of the tree.
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+  hash_t trusted = root->getHash();
+
+  size_t failures = 0, limited = 0;
+  size_t limit_bytes = 0, full_bytes = 0;
+  double limit_us = 0, full_us = 0;
+
+  for (const Rectangle &q : queries) {
+    std::vector<uint32_t> expected;
+    size_t matching = 0;
+    for (const Point2D &p : tree_points) {
+      if (!contains(p, q)) continue;
+      if (expected.size() <= limit) expected.push_back(p.id);
+      matching++;
+    }
+
+    auto limit_start = high_resolution_clock::now();
+    VObject2D *vo = limit_query_2d(root, q, limit);
+    VResult2D *res = verify_limit_2d(vo, q, limit);
+    auto full_start = high_resolution_clock::now();
+    VResult2D *all = query_and_verify_2d(root, q);
+    auto full_end = high_resolution_clock::now();
+    limit_us += duration_cast<nanoseconds>(full_start - limit_start).count() / 1000.0;
+    full_us += duration_cast<nanoseconds>(full_end - full_start).count() / 1000.0;
+    limit_bytes += vo_size_2d(vo);
+    VObject2D *full = range_query_2d(root, q);
+    full_bytes += vo_size_2d(full);
+    delete_vo_2d(full);
+
+    bool ok = res && res->getHash() == trusted && res->count() == std::min(limit, expected.size());
+    for (size_t i = 0; ok && i < res->count(); i++) ok = res->getPoints()[i].id == expected[i];
+    if (!ok) failures++;
+
+    // The proof may answer LIMIT limit + 1 only if its last leaf holds that
+    // match too; otherwise the truncated answer must be rejected.
+    if (matching > limit) {
+      limited++;
+      VResult2D *more = verify_limit_2d(vo, q, limit + 1);
+      if (more && (more->count() != limit + 1 || more->getPoints()[limit].id != expected[limit])) failures++;
+      delete more;
+    }
+
+    delete res;
+    delete all;
+    delete_vo_2d(vo);
+  }
+  delete_2d_tree(root);
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== LIMIT " << limit << " queries ===" << std::endl;
+  std::cout << "Queries with more than " << limit << " matches: " << limited << "/" << queries.size() << std::endl;
+  std::cout << "Average LIMIT VO size: " << (double) limit_bytes / queries.size() << " bytes (full VO: "
+            << (double) full_bytes / queries.size() << " bytes)" << std::endl;
+  std::cout << "Average LIMIT query and verification time: " << limit_us / queries.size() << " μs" << std::endl;
+  std::cout << "Average full query and verification time: " << full_us / queries.size() << " μs" << std::endl;
+
+  if (failures == 0) std::cout << "✓ All answers are the first matches in curve order" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
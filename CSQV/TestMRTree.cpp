@@ -0,0 +1,141 @@
+/**
+ *  @file TestMRTree.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Compares the compile-time specialized MR-tree with the 2D MR-tree
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "MRTree.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <query_file> <capacity>" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  query_file: CSV file with format lx,ly,ux,uy,matching,fraction" << std::endl;
+  std::cout << "  capacity: one of 16, 32, 64, 128, 256, 512" << std::endl;
+}
+
+/**
+ *  Builds the specialized tree with the given capacity, checks its root digest
+ *  against the 2D MR-tree and runs all queries on both trees.
+ *  Points must already be sorted by build_2d_tree.
+ */
+template<size_t Cap>
+int run_test(const std::vector<Point2D> &points, Node2D *root,
+             const std::vector<Rectangle> &queries) {
+  auto build_start = high_resolution_clock::now();
+  MRTree2D<Cap> *tree = new MRTree2D<Cap>();
+  tree->build(to_mr_points(points));
+  auto build_end = high_resolution_clock::now();
+
+  std::cout << "Specialized tree built in "
+            << duration_cast<milliseconds>(build_end - build_start).count()
+            << " ms (height " << tree->getHeight() << ", "
+            << tree->countLeaves() << " leaves)" << std::endl;
+
+  bool same_root = (tree->getRootHash() == root->getHash());
+  std::cout << "Root digest: " << toHex(tree->getRootHash()) << std::endl;
+  std::cout << (same_root ? "✓ Root digest matches the 2D MR-tree"
+                          : "✗ Root digest differs from the 2D MR-tree") << std::endl;
+
+  QueryStats2D base_total, spec_total;
+  size_t mismatches = 0, invalid = 0;
+
+  for (const Rectangle &q : queries) {
+    QueryStats2D base_stats, spec_stats;
+
+    VResult2D *base = query_and_verify_2d(root, q, &base_stats);
+    typename MRTree2D<Cap>::VResult spec = tree->query_and_verify(to_mr_box(q), &spec_stats);
+
+    if (!spec.valid || spec.hash != root->getHash()) invalid++;
+    if (!base || base->count() != spec.points.size()) mismatches++;
+
+    base_total.query_time_us += base_stats.query_time_us;
+    base_total.verify_time_us += base_stats.verify_time_us;
+    spec_total.query_time_us += spec_stats.query_time_us;
+    spec_total.verify_time_us += spec_stats.verify_time_us;
+    delete base;
+  }
+
+  double n = queries.size() * 1000.0;
+  std::cout << std::endl << "=== Average times (ms) ===" << std::endl;
+  std::cout << std::fixed << std::setprecision(4);
+  std::cout << "2D MR-tree:        query " << base_total.query_time_us / n
+            << ", verify " << base_total.verify_time_us / n << std::endl;
+  std::cout << "Specialized tree:  query " << spec_total.query_time_us / n
+            << ", verify " << spec_total.verify_time_us / n << std::endl;
+  std::cout << "Invalid proofs: " << invalid << std::endl;
+  std::cout << "Result count mismatches: " << mismatches << std::endl;
+
+  // A VO nested deeper than any tree can be must be rejected, not recursed into.
+  typename MRTree2D<Cap>::VO deep;
+  typedef typename MRTree2D<Cap>::VOEntry entry_t;
+  for (uint32_t i = 0; i < MRTree2D<Cap>::MAX_HEIGHT; i++) {
+    deep.entries.push_back(entry_t{MRTree2D<Cap>::VO_OPEN, 1, {}, {}});
+  }
+  deep.entries.push_back(entry_t{MRTree2D<Cap>::VO_LEAF, 1, {}, {}});
+  deep.points.push_back(to_mr_point(points[0]));
+  bool deep_rejected = !MRTree2D<Cap>::verify(deep, to_mr_box(queries[0])).valid;
+  std::cout << (deep_rejected ? "✓ Over-deep VO rejected" : "✗ Over-deep VO accepted") << std::endl;
+
+  delete tree;
+  return (same_root && invalid == 0 && mismatches == 0 && deep_rejected) ? 0 : 1;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  std::string query_file = argv[2];
+  size_t capacity = std::stoul(argv[3]);
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  std::vector<Rectangle> queries = load_queries_2d(query_file);
+  if (queries.empty()) {
+    std::cerr << "Error: No queries loaded" << std::endl;
+    return 1;
+  }
+
+  // build_2d_tree sorts the points, so both trees see the same order.
+  Node2D *root = build_2d_tree(points, capacity);
+
+  // Strips along the right and top edges of the root's children: each child
+  // only touches its strip, so both trees must open it to find its border points.
+  if (root->getType() != N2D_LEAF) {
+    for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+      Rectangle r = child->getRect();
+      queries.push_back({r.ux, r.ly, r.ux, r.uy});
+      queries.push_back({r.lx, r.uy, r.ux, r.uy});
+    }
+  }
+
+  int ret;
+  switch (capacity) {
+    case 16:  ret = run_test<16>(points, root, queries); break;
+    case 32:  ret = run_test<32>(points, root, queries); break;
+    case 64:  ret = run_test<64>(points, root, queries); break;
+    case 128: ret = run_test<128>(points, root, queries); break;
+    case 256: ret = run_test<256>(points, root, queries); break;
+    case 512: ret = run_test<512>(points, root, queries); break;
+    default:
+      std::cerr << "Error: Unsupported capacity " << capacity << std::endl;
+      ret = 1;
+  }
+
+  delete_2d_tree(root);
+  return ret;
+}
@@ -0,0 +1,116 @@
+/**
+ *  @file TestPagedTree.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for the out-of-core MR-tree with a buffer pool
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "PageFile2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <query_file|num_queries> <capacity> <page_file> [frames] [page_size]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  query_file: CSV file with format lx,ly,ux,uy,matching,fraction" << std::endl;
+  std::cout << "  num_queries: number of random queries (instead of a query file)" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  page_file: page file to write" << std::endl;
+  std::cout << "  frames: number of frames of the buffer pool (default: 64)" << std::endl;
+  std::cout << "  page_size: page size in bytes (default: " << PAGE2D_DEFAULT_SIZE << ")" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 5) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  std::string query_arg = argv[2];
+  size_t capacity = std::stoul(argv[3]);
+  std::string page_file = argv[4];
+  size_t frames = (argc > 5) ? std::stoul(argv[5]) : 64;
+  uint32_t page_size = (argc > 6) ? (uint32_t) std::stoul(argv[6]) : PAGE2D_DEFAULT_SIZE;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  std::vector<Rectangle> queries;
+  if (query_arg.find_first_not_of("0123456789") == std::string::npos) {
+    queries = generate_random_queries_2d(compute_mbr(points), std::stoul(query_arg));
+  } else {
+    queries = load_queries_2d(query_arg);
+  }
+  if (queries.empty()) {
+    std::cerr << "Error: No queries loaded" << std::endl;
+    return 1;
+  }
+
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+  hash_t trusted = root->getHash();
+
+  // Strips along the right edges of the root's children, which only touch
+  // them: the paged query must open them just as the in-memory one does.
+  if (root->getType() != N2D_LEAF) {
+    for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+      Rectangle r = child->getRect();
+      queries.push_back({r.ux, r.ly, r.ux, r.uy});
+    }
+  }
+
+  auto write_start = high_resolution_clock::now();
+  bool written = write_page_file_2d(root, page_file, page_size);
+  auto write_end = high_resolution_clock::now();
+  PagedTree2D tree;
+  if (!written || !tree.open(page_file, frames)) {
+    std::cerr << "Error: cannot write or open the page file" << std::endl;
+    delete_2d_tree(root);
+    return 1;
+  }
+
+  size_t failures = 0;
+  double paged_us = 0, memory_us = 0;
+  if (tree.getHash() != trusted || tree.size() != points.size()) failures++;
+
+  for (const Rectangle &q : queries) {
+    auto paged_start = high_resolution_clock::now();
+    VObject2D *vo = range_query_paged_2d(tree, q);
+    auto memory_start = high_resolution_clock::now();
+    VObject2D *expected = range_query_2d(root, q);
+    auto memory_end = high_resolution_clock::now();
+    paged_us += duration_cast<nanoseconds>(memory_start - paged_start).count() / 1000.0;
+    memory_us += duration_cast<nanoseconds>(memory_end - memory_start).count() / 1000.0;
+
+    VResult2D *res = vo ? verify_2d(vo, q) : nullptr;
+    if (!res || res->getHash() != trusted || serialize_vo_2d(vo) != serialize_vo_2d(expected)) failures++;
+    delete res;
+    delete_vo_2d(vo);
+    delete_vo_2d(expected);
+  }
+  delete_2d_tree(root);
+
+  const BufferPoolStats2D &stats = tree.getPool().getStats();
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== Paged tree ===" << std::endl;
+  std::cout << "Wrote " << tree.countPages() << " pages of " << tree.getPageSize() << " bytes (height "
+            << tree.getHeight() << ") in " << duration_cast<milliseconds>(write_end - write_start).count() << " ms" << std::endl;
+  std::cout << "Buffer pool: " << frames << " frames, hit rate " << stats.hitRate() * 100 << "%, "
+            << stats.misses << " page reads, " << stats.evictions << " evictions" << std::endl;
+  std::cout << "Average paged query time: " << paged_us / queries.size() << " μs" << std::endl;
+  std::cout << "Average in-memory query time: " << memory_us / queries.size() << " μs" << std::endl;
+
+  if (failures == 0) std::cout << "✓ All paged VOs match the in-memory ones" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
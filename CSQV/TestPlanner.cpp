@@ -0,0 +1,117 @@
+/**
+ *  @file TestPlanner.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for the selectivity estimator and the query planner
+ */
+
+#include "Point2D.hpp"
+#include "Index2D.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <num_queries> [bulk_fraction] [alt_max_results]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: leaf capacity of the MR-tree and fanout of the B+-tree" << std::endl;
+  std::cout << "  num_queries: number of queries, split among tiny, medium and huge windows" << std::endl;
+  std::cout << "  bulk_fraction: estimated fraction of the points for bulk emission (default: 0.25)" << std::endl;
+  std::cout << "  alt_max_results: estimated results up to which the B+-tree is used (default: 1000)" << std::endl;
+}
+
+/**
+ *  Returns the p-th percentile of a list of values.
+ */
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0.0;
+  std::sort(v.begin(), v.end());
+  return v[std::min(v.size() - 1, (size_t) (p * v.size()))];
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  size_t num_queries = std::stoul(argv[3]);
+  PlannerConfig2D config;
+  if (argc > 4) config.bulk_fraction = std::stod(argv[4]);
+  if (argc > 5) config.alt_max_results = std::stod(argv[5]);
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  Rectangle mbr = compute_mbr(points);
+  std::vector<Rectangle> queries = generate_random_queries_2d(mbr, num_queries / 3, 0.001, 0.01);
+  std::vector<Rectangle> medium = generate_random_queries_2d(mbr, num_queries / 3, 0.01, 0.1);
+  std::vector<Rectangle> huge = generate_random_queries_2d(mbr, num_queries - 2 * (num_queries / 3), 0.5, 1.0);
+  queries.insert(queries.end(), medium.begin(), medium.end());
+  queries.insert(queries.end(), huge.begin(), huge.end());
+
+  MRTreeIndex2D tree(points, capacity);
+  PlannedIndex2D planned(points, capacity,
+                         std::unique_ptr<SpatialIndex2D>(new MBTreeIndex2D(points, capacity)),
+                         config);
+  std::cout << "Histogram: " << planned.getHistogram().sizeInBytes() << " bytes" << std::endl;
+
+  // Windows starting on the right edge of each child of the root, which only
+  // touch it: a thin strip for the tree plan and the whole area to its right
+  // for the bulk plan. Every plan must find the child's points on the edge.
+  Node2D *root = tree.getRoot();
+  if (root && root->getType() != N2D_LEAF) {
+    for (Node2D *child : static_cast<IntNode2D*>(root)->getChildren()) {
+      Rectangle r = child->getRect();
+      queries.push_back({r.ux, r.ly, r.ux, r.uy});
+      queries.push_back({r.ux, mbr.ly, mbr.ux, mbr.uy});
+    }
+  }
+
+  std::vector<double> tree_ms, planned_ms, q_errors;
+  size_t plans[3] = {0, 0, 0};
+  size_t failures = 0;
+
+  for (const Rectangle &q : queries) {
+    size_t expected = count_in_range(points, q);
+
+    QueryStats2D tree_stats, planned_stats;
+    IndexResult2D a = tree.query(q, &tree_stats);
+    IndexResult2D b = planned.query(q, &planned_stats);
+    if (!a.valid || !b.valid || a.points.size() != expected || b.points.size() != expected) failures++;
+
+    tree_ms.push_back((tree_stats.query_time_us + tree_stats.verify_time_us) / 1000.0);
+    planned_ms.push_back((planned_stats.query_time_us + planned_stats.verify_time_us) / 1000.0);
+    plans[planned_stats.plan]++;
+
+    double est = planned_stats.estimated_results + 1, act = expected + 1.0;
+    q_errors.push_back(std::max(est, act) / std::min(est, act));
+  }
+
+  std::cout << std::fixed << std::setprecision(4);
+  std::cout << "=== Estimator ===" << std::endl;
+  std::cout << "Median q-error: " << percentile(q_errors, 0.5) << std::endl;
+  std::cout << "95th percentile q-error: " << percentile(q_errors, 0.95) << std::endl;
+  std::cout << "Plans: " << plans[QP2D_TREE] << " tree, " << plans[QP2D_BULK] << " bulk, "
+            << plans[QP2D_ALT] << " alternative index" << std::endl << std::endl;
+
+  const char *names[] = {"Tree only", "Planned"};
+  std::vector<double> *times[] = {&tree_ms, &planned_ms};
+  for (int k = 0; k < 2; k++) {
+    double sum = 0;
+    for (double t : *times[k]) sum += t;
+    std::cout << "=== " << names[k] << " ===" << std::endl;
+    std::cout << "Average total time: " << sum / queries.size() << " ms" << std::endl;
+    std::cout << "Median total time: " << percentile(*times[k], 0.5) << " ms" << std::endl;
+    std::cout << "99th percentile total time: " << percentile(*times[k], 0.99) << " ms" << std::endl;
+  }
+
+  if (failures == 0) std::cout << "✓ All queries verified" << std::endl;
+  else std::cout << "✗ " << failures << " queries failed" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/**
+ *  @file TestProjection2D.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for 2D range queries returning authenticated attribute projections
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "Attributes2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <query_file> <capacity> [column ...]" << std::endl;
+  std::cout << "  data_file: CSV file with columns x, y and any number of attributes" << std::endl;
+  std::cout << "  query_file: CSV file with format lx,ly,ux,uy,matching,fraction" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  column: attribute to return (none returns coordinates only)" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  std::string query_file = argv[2];
+  size_t capacity = std::stoul(argv[3]);
+  std::vector<std::string> names(argv + 4, argv + argc);
+
+  std::vector<Point2D> points;
+  AttributeStore attrs = load_records_file(data_file, points);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  ColumnMask mask = attrs.mask(names);
+  std::cout << "Projected columns:";
+  for (size_t i = 0; i < attrs.getColumns().size(); i++) {
+    if (mask & (ColumnMask(1) << i)) std::cout << " " << attrs.getColumns()[i];
+  }
+  std::cout << (mask ? "" : " (coordinates only)") << std::endl;
+
+  std::vector<Rectangle> queries = load_queries_2d(query_file);
+  if (queries.empty()) {
+    std::cerr << "Error: No queries loaded" << std::endl;
+    return 1;
+  }
+
+  auto build_start = high_resolution_clock::now();
+  Node2D *root = build_2d_tree(points, capacity, &attrs);
+  auto build_end = high_resolution_clock::now();
+  std::cout << "Tree with payload digests built in "
+            << duration_cast<milliseconds>(build_end - build_start).count()
+            << " ms" << std::endl;
+  print_2d_tree_stats(root);
+
+  size_t failures = 0, total_points = 0;
+  double query_us = 0, verify_us = 0;
+
+  for (const Rectangle &q : queries) {
+    auto query_start = high_resolution_clock::now();
+    VObject2D *vo = range_query_projected_2d(root, q, attrs, mask);
+    auto query_end = high_resolution_clock::now();
+    VResult2D *res = verify_projected_2d(vo, q, mask);
+    auto verify_end = high_resolution_clock::now();
+
+    query_us += duration_cast<microseconds>(query_end - query_start).count();
+    verify_us += duration_cast<microseconds>(verify_end - query_end).count();
+
+    bool ok = res && res->getHash() == root->getHash() &&
+              res->count() == count_in_range(points, q) &&
+              res->getRecords().size() == (mask ? res->count() : 0);
+    for (size_t i = 0; ok && i < res->getRecords().size(); i++) {
+      const ProjectedRecord &rec = res->getRecords()[i];
+      const std::vector<std::string> &full = attrs.get(rec.id);
+      size_t v = 0;
+      for (size_t c = 0; c < full.size(); c++) {
+        if ((mask & (ColumnMask(1) << c)) && rec.values[v++] != full[c]) ok = false;
+      }
+    }
+    // An answer without the requested columns must be rejected.
+    if (mask && res && res->count() > 0) {
+      VObject2D *stripped = range_query_projected_2d(root, q, attrs, 0);
+      VResult2D *bad = verify_projected_2d(stripped, q, mask);
+      if (bad) ok = false;
+      delete bad;
+      delete_vo_2d(stripped);
+    }
+    if (!ok) failures++;
+    if (res) total_points += res->count();
+
+    delete res;
+    delete_vo_2d(vo);
+  }
+
+  double n = queries.size() * 1000.0;
+  std::cout << std::endl << "=== Summary ===" << std::endl;
+  std::cout << "Queries: " << queries.size() << std::endl;
+  std::cout << "Average points returned: " << std::fixed << std::setprecision(2)
+            << (double)total_points / queries.size() << std::endl;
+  std::cout << "Average query time: " << std::setprecision(4) << query_us / n << " ms" << std::endl;
+  std::cout << "Average verification time: " << verify_us / n << " ms" << std::endl;
+  if (failures == 0) {
+    std::cout << "✓ All projections verified" << std::endl;
+  } else {
+    std::cout << "✗ " << failures << " queries failed" << std::endl;
+  }
+
+  delete_2d_tree(root);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+/**
+ *  @file TestSTQuery.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for spatio-temporal (x, y, time) range queries with verification
+ */
+
+#include "PointST.hpp"
+#include "MRTree.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> [query_file | num_queries]" << std::endl;
+  std::cout << "  data_file: CSV file with format ID,Year,Month,Day,Time,x,y" << std::endl;
+  std::cout << "  capacity: one of 32, 64, 128, 256" << std::endl;
+  std::cout << "  query_file: CSV file with format lx,ly,lt,ux,uy,ut" << std::endl;
+  std::cout << "  num_queries: number of random queries (default: 100), each covering" << std::endl;
+  std::cout << "               10% of the data extent in space and one year in time" << std::endl;
+}
+
+/**
+ *  Generates random cuboid queries: a square window over 10% of the
+ *  spatial extent and a random range of 12 consecutive months.
+ */
+std::vector<Cuboid> generate_st_queries(const Cuboid &domain, size_t num_queries) {
+  std::vector<Cuboid> queries;
+  std::mt19937 gen(std::random_device{}());
+
+  int32_t w = (domain.hi[0] - domain.lo[0]) / 10;
+  int32_t h = (domain.hi[1] - domain.lo[1]) / 10;
+  int32_t months = (domain.hi[2] - domain.lo[2]) / ST_MINUTES_PER_MONTH + 1;
+  int32_t first_month = domain.lo[2] / ST_MINUTES_PER_MONTH;
+
+  std::uniform_int_distribution<int32_t> x_dist(domain.lo[0], domain.hi[0] - w);
+  std::uniform_int_distribution<int32_t> y_dist(domain.lo[1], domain.hi[1] - h);
+  std::uniform_int_distribution<int32_t> m_dist(0, std::max(0, months - 12));
+
+  for (size_t i = 0; i < num_queries; i++) {
+    int32_t lx = x_dist(gen), ly = y_dist(gen);
+    int32_t lt = (first_month + m_dist(gen)) * ST_MINUTES_PER_MONTH;
+    queries.push_back(Cuboid{{{lx, ly, lt}},
+                             {{lx + w, ly + h, lt + 12 * ST_MINUTES_PER_MONTH - 1}}});
+  }
+  return queries;
+}
+
+template<size_t Cap>
+int run_test(const std::vector<PointST> &points, const std::vector<Cuboid> &queries) {
+  auto build_start = high_resolution_clock::now();
+  MRTreeST<Cap> *tree = new MRTreeST<Cap>();
+  tree->build(points);
+  auto build_end = high_resolution_clock::now();
+
+  std::cout << "3D MR-tree built in "
+            << duration_cast<milliseconds>(build_end - build_start).count()
+            << " ms (height " << tree->getHeight() << ", "
+            << tree->countLeaves() << " leaves)" << std::endl << std::endl;
+
+  hash_t root_hash = tree->getRootHash();
+  QueryStats2D total;
+  size_t failures = 0, spatial_only = 0;
+
+  for (const Cuboid &q : queries) {
+    QueryStats2D stats;
+    typename MRTreeST<Cap>::VResult res = tree->query_and_verify(q, &stats);
+
+    if (!res.valid || res.hash != root_hash ||
+        res.points.size() != count_in_cuboid(points, q)) {
+      failures++;
+    }
+
+    // Number of points a purely spatial query would have shipped.
+    Cuboid all_time = q;
+    all_time.lo[2] = std::numeric_limits<int32_t>::min();
+    all_time.hi[2] = std::numeric_limits<int32_t>::max();
+    spatial_only += count_in_cuboid(points, all_time);
+
+    total.nodes_visited += stats.nodes_visited;
+    total.nodes_pruned += stats.nodes_pruned;
+    total.points_examined += stats.points_examined;
+    total.points_returned += stats.points_returned;
+    total.query_time_us += stats.query_time_us;
+    total.verify_time_us += stats.verify_time_us;
+  }
+
+  double n = queries.size();
+  std::cout << "=== Summary ===" << std::endl;
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "Queries: " << queries.size() << std::endl;
+  std::cout << "Average nodes visited: " << total.nodes_visited / n << std::endl;
+  std::cout << "Average nodes pruned: " << total.nodes_pruned / n << std::endl;
+  std::cout << "Average points examined: " << total.points_examined / n << std::endl;
+  std::cout << "Average points returned: " << total.points_returned / n << std::endl;
+  std::cout << "Average points of the spatial-only query: " << spatial_only / n << std::endl;
+  std::cout << std::setprecision(4);
+  std::cout << "Average query time: " << total.query_time_us / (n * 1000.0) << " ms" << std::endl;
+  std::cout << "Average verification time: " << total.verify_time_us / (n * 1000.0) << " ms" << std::endl;
+
+  if (failures == 0) {
+    std::cout << "✓ All queries verified and match brute force" << std::endl;
+  } else {
+    std::cout << "✗ " << failures << " queries failed" << std::endl;
+  }
+
+  delete tree;
+  return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 3) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+
+  std::vector<PointST> points = load_st_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+
+  Cuboid domain = Cuboid::empty();
+  for (const PointST &p : points) domain.enlarge(p);
+
+  std::vector<Cuboid> queries;
+  std::string arg = (argc > 3) ? argv[3] : "100";
+  if (arg.find_first_not_of("0123456789") == std::string::npos) {
+    queries = generate_st_queries(domain, std::stoul(arg));
+  } else {
+    queries = load_st_queries(arg);
+  }
+  if (queries.empty()) {
+    std::cerr << "Error: No queries loaded" << std::endl;
+    return 1;
+  }
+
+  switch (capacity) {
+    case 32:  return run_test<32>(points, queries);
+    case 64:  return run_test<64>(points, queries);
+    case 128: return run_test<128>(points, queries);
+    case 256: return run_test<256>(points, queries);
+    default:
+      std::cerr << "Error: Unsupported capacity " << capacity << std::endl;
+      return 1;
+  }
+}
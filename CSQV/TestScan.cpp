@@ -0,0 +1,111 @@
+/**
+ *  @file TestScan.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for the vectorized brute-force scan kernels
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "Scan2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <num_queries> [threads] [capacity]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  num_queries: number of random queries" << std::endl;
+  std::cout << "  threads: number of scan threads (default: 0 = one per hardware thread)" << std::endl;
+  std::cout << "  capacity: leaf capacity of the MR-tree baseline (default: 64)" << std::endl;
+}
+
+/**
+ *  Returns the microseconds elapsed since a time point.
+ */
+static double elapsed_us(high_resolution_clock::time_point start) {
+  return duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 3) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t num_queries = std::stoul(argv[2]);
+  size_t threads = (argc > 3) ? std::stoul(argv[3]) : 0;
+  size_t capacity = (argc > 4) ? std::stoul(argv[4]) : 64;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  PointColumns2D cols(points);
+  std::vector<Rectangle> queries = generate_random_queries_2d(compute_mbr(points), num_queries);
+
+  // Scalar loop over std::vector<Point2D>: the reference.
+  std::vector<size_t> expected(queries.size());
+  auto ref_start = high_resolution_clock::now();
+  for (size_t i = 0; i < queries.size(); i++) expected[i] = count_in_range(points, queries[i]);
+  double ref_us = elapsed_us(ref_start);
+
+  std::cout << "Points: " << points.size() << ", queries: " << queries.size()
+            << ", best kernel: " << scan_kernel_name_2d(best_scan_kernel_2d()) << std::endl << std::endl;
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "count_in_range (reference): " << ref_us / queries.size() << " μs/query" << std::endl;
+
+  size_t failures = 0;
+  for (ScanKernel2D kernel : {SCAN2D_SCALAR, SCAN2D_AVX2, SCAN2D_AVX512}) {
+    if (!scan_kernel_supported_2d(kernel)) continue;
+    for (size_t t : {size_t(1), threads}) {
+      auto count_start = high_resolution_clock::now();
+      for (size_t i = 0; i < queries.size(); i++) {
+        failures += (scan_count_2d(cols, queries[i], kernel, t) != expected[i]);
+      }
+      double count_us = elapsed_us(count_start);
+
+      auto select_start = high_resolution_clock::now();
+      for (size_t i = 0; i < queries.size(); i++) {
+        failures += (scan_range_query_2d(cols, queries[i], kernel, t).size() != expected[i]);
+      }
+      double select_us = elapsed_us(select_start);
+
+      auto many_start = high_resolution_clock::now();
+      failures += (scan_count_many_2d(cols, queries, kernel, t) != expected);
+      double many_us = elapsed_us(many_start);
+
+      std::cout << scan_kernel_name_2d(kernel) << " (" << (t ? std::to_string(t) : "all")
+                << " threads): count " << count_us / queries.size()
+                << " μs/query, select " << select_us / queries.size()
+                << " μs/query, many " << many_us / queries.size() << " μs/query" << std::endl;
+      if (t == 1 && threads == 1) break;
+    }
+  }
+
+  // The index, for comparison: query without and with verification.
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+  double tree_us = 0, verified_us = 0;
+  for (const Rectangle &q : queries) {
+    auto start = high_resolution_clock::now();
+    VObject2D *vo = range_query_2d(root, q);
+    tree_us += elapsed_us(start);
+    VResult2D *res = verify_2d(vo, q);
+    verified_us += elapsed_us(start);
+    delete res;
+    delete_vo_2d(vo);
+  }
+  delete_2d_tree(root);
+  std::cout << "MR-tree query: " << tree_us / queries.size() << " μs/query, with verification "
+            << verified_us / queries.size() << " μs/query" << std::endl;
+
+  if (failures == 0) std::cout << "✓ All kernels match count_in_range" << std::endl;
+  else std::cout << "✗ " << failures << " mismatches" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
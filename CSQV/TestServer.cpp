@@ -0,0 +1,231 @@
+/**
+ *  @file TestServer.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for the query server: pipelined range, count and kNN
+ *  requests verified end to end
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "Heatmap2D.hpp"
+#include "Knn2D.hpp"
+#include "Server2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <address> [threads] [num_requests] [batch] [page_file]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  address: unix:<path>, tcp:<port> (localhost) or tcp:<host>:<port>" << std::endl;
+  std::cout << "  threads: number of server worker threads (default: 0 = all cores)" << std::endl;
+  std::cout << "  num_requests: number of range, count and kNN requests (default: 3000)" << std::endl;
+  std::cout << "  batch: requests sent before reading replies (default: 64)" << std::endl;
+  std::cout << "  page_file: if given, the tree is also written there and served from its image" << std::endl;
+}
+
+/**
+ *  Checks a reply against the trusted roots and the points.
+ */
+static bool check_reply(const ServerReply2D &reply, const ServerRequest2D &request,
+                        const std::vector<Point2D> &points, const hash_t &root, const hash_t &count_root) {
+  if (reply.status != SERVER2D_OK || reply.op != request.op) return false;
+  const int32_t *a = request.args;
+  Rectangle q = {a[0], a[1], a[2], a[3]};
+
+  if (request.op == SERVER2D_RANGE) {
+    VObject2D *vo = deserialize_vo_2d(reply.body.data(), reply.body.size());
+    VResult2D *res = vo ? verify_2d(vo, q) : nullptr;
+    bool ok = res && res->getHash() == root && res->count() == count_in_range(points, q);
+    delete res;
+    delete_vo_2d(vo);
+    return ok;
+  }
+  if (request.op == SERVER2D_COUNT) {
+    HeatmapGrid2D grid = {q, 1, 1};
+    VHeat2D *vo = deserialize_heatmap_vo_2d(reply.body.data(), reply.body.size());
+    bool ok = vo != nullptr;
+    if (ok) {
+      HeatmapResult2D res = verify_heatmap_2d(vo, grid);
+      ok = res.valid && res.hash == count_root && res.counts == heatmap_counts_2d(points, grid);
+    }
+    delete vo;
+    return ok;
+  }
+
+  // kNN: the radius precedes the VO of the window.
+  uint64_t radius;
+  if (reply.body.size() < sizeof(radius)) return false;
+  std::memcpy(&radius, reply.body.data(), sizeof(radius));
+  VObject2D *vo = deserialize_vo_2d(reply.body.data() + sizeof(radius), reply.body.size() - sizeof(radius));
+  VResult2D *res = vo ? verify_knn_2d(vo, a[0], a[1], (uint32_t) a[2], radius) : nullptr;
+  bool ok = res && res->getHash() == root;
+  if (ok) {
+    std::vector<Point2D> expected = knn_scan_2d(points, a[0], a[1], (uint32_t) a[2]);
+    ok = expected.size() == res->count();
+    for (size_t i = 0; ok && i < expected.size(); i++) ok = expected[i].id == res->getPoints()[i].id;
+  }
+  delete res;
+  delete_vo_2d(vo);
+  return ok;
+}
+
+/**
+ *  Serves the tree from a page file image: range replies must verify
+ *  against the root, count and kNN requests must be refused.
+ *  @return the number of failures
+ */
+static size_t test_paged(Node2D *root, const std::vector<Point2D> &points, const std::string &page_file,
+                         const std::string &address, size_t threads, const std::vector<Rectangle> &windows) {
+  if (!write_page_file_2d(root, page_file)) return 1;
+  std::ifstream file(page_file, std::ios::binary);
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  PageImage2D image;
+  if (!image.open(bytes.data(), bytes.size())) return 1;
+
+  QueryServer2D server(image);
+  if (!server.listen(address)) return 1;
+  std::thread loop([&server, threads]() { server.run(threads); });
+
+  size_t failures = 0;
+  std::vector<ServerRequest2D> requests = {roots_request_2d(0), count_request_2d(1, windows[0]),
+                                           knn_request_2d(2, windows[0].lx, windows[0].ly, 1)};
+  for (size_t i = 0; i < windows.size(); i++) requests.push_back(range_request_2d(3 + i, windows[i]));
+
+  ServerClient2D client;
+  ServerReply2D reply;
+  hash_t trusted_root = root->getHash();
+  if (!client.connect(address) || !client.send(requests)) failures++;
+  for (size_t i = 0; failures == 0 && i < requests.size(); i++) {
+    if (!client.receive(reply) || reply.id >= requests.size()) {
+      failures++;
+      break;
+    }
+    const ServerRequest2D &request = requests[reply.id];
+    if (request.op == SERVER2D_ROOTS) {
+      if (reply.body.size() != 2 * SHA256_DIGEST_LENGTH + sizeof(uint64_t) ||
+          std::memcmp(reply.body.data(), trusted_root.data(), SHA256_DIGEST_LENGTH) != 0) failures++;
+    } else if (request.op != SERVER2D_RANGE) {
+      if (reply.status != SERVER2D_UNSUPPORTED) failures++;
+    } else if (!check_reply(reply, request, points, trusted_root, hash_t{})) {
+      failures++;
+    }
+  }
+
+  client.close();
+  server.stop();
+  loop.join();
+  server.close();
+  std::cout << "Page file: " << image.countPages() << " pages, " << windows.size()
+            << " range requests answered from its image" << std::endl;
+  return failures;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  std::string address = argv[3];
+  size_t threads = (argc > 4) ? std::stoul(argv[4]) : 0;
+  size_t num_requests = (argc > 5) ? std::stoul(argv[5]) : 3000;
+  size_t batch = (argc > 6) ? std::max<size_t>(1, std::stoul(argv[6])) : 64;
+  std::string page_file = (argc > 7) ? argv[7] : "";
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+  CountTree2D counts(root);
+
+  QueryServer2D server(root, counts);
+  if (!server.listen(address)) {
+    delete_2d_tree(root);
+    return 1;
+  }
+  std::thread loop([&server, threads]() { server.run(threads); });
+
+  // Mixed requests: range, count and kNN in turn.
+  Rectangle mbr = compute_mbr(points);
+  std::vector<Rectangle> windows = generate_random_queries_2d(mbr, num_requests);
+  std::mt19937 rng(7);
+  std::vector<ServerRequest2D> requests;
+  for (size_t i = 0; i < num_requests; i++) {
+    const Rectangle &q = windows[i];
+    if (i % 3 == 0) requests.push_back(range_request_2d(i, q));
+    else if (i % 3 == 1) requests.push_back(count_request_2d(i, q));
+    else requests.push_back(knn_request_2d(i, q.lx + (q.ux - q.lx) / 2, q.ly + (q.uy - q.ly) / 2, 1 + rng() % 16));
+  }
+
+  size_t failures = 0;
+  ServerClient2D client;
+  ServerReply2D reply;
+  hash_t trusted_root = root->getHash(), trusted_counts = counts.getHash();
+  if (!client.connect(address) || !client.send({roots_request_2d(UINT32_MAX)}) || !client.receive(reply) ||
+      reply.body.size() != 2 * SHA256_DIGEST_LENGTH + sizeof(uint64_t) ||
+      std::memcmp(reply.body.data(), trusted_root.data(), SHA256_DIGEST_LENGTH) != 0 ||
+      std::memcmp(reply.body.data() + SHA256_DIGEST_LENGTH, trusted_counts.data(), SHA256_DIGEST_LENGTH) != 0) {
+    failures++;
+  }
+
+  // Pipelined batches: all replies of a batch are read after sending it.
+  std::vector<bool> answered(num_requests, false);
+  size_t vo_bytes = 0;
+  auto start = high_resolution_clock::now();
+  for (size_t i = 0; i < num_requests && failures == 0; i += batch) {
+    std::vector<ServerRequest2D> chunk(requests.begin() + i, requests.begin() + std::min(num_requests, i + batch));
+    if (!client.send(chunk)) {
+      failures++;
+      break;
+    }
+    for (size_t j = 0; j < chunk.size(); j++) {
+      if (!client.receive(reply) || reply.id >= num_requests || answered[reply.id]) {
+        failures++;
+        break;
+      }
+      answered[reply.id] = true;
+      vo_bytes += reply.body.size();
+      if (!check_reply(reply, requests[reply.id], points, trusted_root, trusted_counts)) failures++;
+    }
+  }
+  auto end = high_resolution_clock::now();
+
+  // Malformed requests get an error reply.
+  ServerRequest2D bad = knn_request_2d(0, 0, 0, 0);
+  if (!client.send({bad}) || !client.receive(reply) || reply.status != SERVER2D_BAD_REQUEST) failures++;
+
+  client.close();
+  server.stop();
+  loop.join();
+  server.close();
+  if (!page_file.empty()) failures += test_paged(root, points, page_file, address, threads, windows);
+  delete_2d_tree(root);
+
+  double us = duration_cast<microseconds>(end - start).count();
+  const ServerStats2D &stats = server.getStats();
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== Query server on " << address << " (batches of " << batch << ") ===" << std::endl;
+  std::cout << "Requests: " << stats.requests << ", replies: " << stats.replies
+            << ", average reply: " << (double) vo_bytes / num_requests << " bytes" << std::endl;
+  std::cout << "Reads paused at " << SERVER2D_MAX_INFLIGHT << " requests in flight: " << stats.paused << " times" << std::endl;
+  std::cout << "Throughput: " << num_requests / (us / 1e6) << " requests/s (including client verification)" << std::endl;
+
+  if (failures == 0) std::cout << "✓ All replies verify against the trusted roots" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
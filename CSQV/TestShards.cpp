@@ -0,0 +1,111 @@
+/**
+ *  @file TestShards.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for the sharded MR-tree with scatter-gather queries
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "Shard2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <shards> [threads] [num_queries]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  shards: number of shards" << std::endl;
+  std::cout << "  threads: number of build and query threads (default: 0 = all cores)" << std::endl;
+  std::cout << "  num_queries: number of random queries (default: 1000)" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  size_t count = std::stoul(argv[3]);
+  size_t threads = (argc > 4) ? std::stoul(argv[4]) : 0;
+  size_t num_queries = (argc > 5) ? std::stoul(argv[5]) : 1000;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  std::vector<Rectangle> queries = generate_random_queries_2d(compute_mbr(points), num_queries);
+
+  std::vector<Point2D> tree_points = points;
+  auto single_start = high_resolution_clock::now();
+  Node2D *single = build_2d_tree(tree_points, capacity);
+  auto single_end = high_resolution_clock::now();
+  double single_us = 0;
+  for (const Rectangle &q : queries) {
+    auto start = high_resolution_clock::now();
+    VObject2D *vo = range_query_2d(single, q);
+    single_us += duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+    delete_vo_2d(vo);
+  }
+  delete_2d_tree(single);
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "Single tree build time: " << duration_cast<microseconds>(single_end - single_start).count()
+            << " μs, average query time: " << single_us / queries.size() << " μs" << std::endl;
+
+  size_t failures = 0;
+  const char *names[] = {"Morton", "k-d"};
+  for (ShardSplit2D split : {SHARD2D_MORTON, SHARD2D_KD}) {
+    ShardedTree2D tree;
+    auto build_start = high_resolution_clock::now();
+    if (!tree.build(points, count, capacity, split, threads)) return 1;
+    auto build_end = high_resolution_clock::now();
+
+    // The combined VO must verify, hold every matching point and match
+    // the VO of a query on the combined root.
+    auto check = [&](const Rectangle &q, VObject2D *vo) {
+      VObject2D *expected = range_query_2d(tree.getRoot(), q);
+      VResult2D *res = verify_2d(vo, q);
+      if (!res || res->getHash() != tree.getHash() || res->count() != count_in_range(points, q) ||
+          vo_size_2d(vo) != vo_size_2d(expected)) failures++;
+      delete res;
+      delete_vo_2d(vo);
+      delete_vo_2d(expected);
+    };
+
+    double query_us = 0, dispatched_total = 0;
+    for (const Rectangle &q : queries) {
+      size_t dispatched = 0;
+      auto start = high_resolution_clock::now();
+      VObject2D *vo = tree.query(q, threads, &dispatched);
+      query_us += duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+      dispatched_total += dispatched;
+      check(q, vo);
+    }
+
+    // Strips along the right and top edges of each shard, which only touch
+    // it: the shard must still be queried for its points on the edge.
+    for (Node2D *shard : static_cast<IntNode2D*>(tree.getRoot())->getChildren()) {
+      Rectangle r = shard->getRect();
+      for (const Rectangle &q : {Rectangle{r.ux, r.ly, r.ux, r.uy}, Rectangle{r.lx, r.uy, r.ux, r.uy}}) {
+        check(q, tree.query(q, threads));
+      }
+    }
+
+    std::cout << "=== " << names[split] << " split into " << tree.countShards() << " shards ===" << std::endl;
+    std::cout << "Build time: " << duration_cast<microseconds>(build_end - build_start).count() << " μs" << std::endl;
+    std::cout << "Average shards queried: " << dispatched_total / queries.size() << std::endl;
+    std::cout << "Average query time: " << query_us / queries.size() << " μs" << std::endl;
+  }
+
+  if (failures == 0) std::cout << "✓ All combined VOs verify against the combined root" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/**
+ *  @file TestTileStore.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Builds a tile-pyramid VO store and serves random tile requests from it
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "TileStore2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <cstring>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <max_zoom> <store_file> [num_requests]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  max_zoom: tiles are stored for zoom levels 0 to max_zoom" << std::endl;
+  std::cout << "  store_file: tile store file to build" << std::endl;
+  std::cout << "  num_requests: number of random tile requests (default: 1000)" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 5) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  uint32_t max_zoom = (uint32_t) std::stoul(argv[3]);
+  std::string store_file = argv[4];
+  size_t num_requests = (argc > 5) ? std::stoul(argv[5]) : 1000;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+  hash_t trusted = root->getHash();
+
+  std::vector<uint32_t> zooms;
+  for (uint32_t z = 0; z <= max_zoom; z++) zooms.push_back(z);
+  auto build_start = high_resolution_clock::now();
+  size_t tiles = build_tile_store_2d(root, zooms, store_file);
+  auto build_end = high_resolution_clock::now();
+
+  TileStore2D store;
+  if (tiles == 0 || !store.open(store_file)) {
+    std::cerr << "Error: cannot build or open the tile store" << std::endl;
+    delete_2d_tree(root);
+    return 1;
+  }
+
+  std::mt19937 gen(std::random_device{}());
+  std::uniform_int_distribution<uint32_t> zoom(0, max_zoom);
+  size_t failures = 0, hits = 0;
+  double store_us = 0, live_us = 0;
+
+  for (size_t i = 0; i < num_requests; i++) {
+    uint32_t z = zoom(gen);
+    std::uniform_int_distribution<uint32_t> tile(0, (uint32_t) ((1ULL << z) - 1));
+    uint32_t x = tile(gen), y = tile(gen);
+    Rectangle q = tile_rect_2d(store.getMBR(), z, x, y);
+
+    auto store_start = high_resolution_clock::now();
+    size_t size;
+    const uint8_t *bytes = store.lookup(z, x, y, size);
+    auto live_start = high_resolution_clock::now();
+    VObject2D *live = range_query_2d(root, q);
+    std::vector<uint8_t> expected = serialize_vo_2d(live);
+    auto live_end = high_resolution_clock::now();
+    store_us += duration_cast<nanoseconds>(live_start - store_start).count() / 1000.0;
+    live_us += duration_cast<nanoseconds>(live_end - live_start).count() / 1000.0;
+
+    // Empty tiles are not stored; stored ones must verify like the live VO.
+    VResult2D *live_res = verify_2d(live, q);
+    if (bytes) {
+      hits++;
+      VObject2D *vo = deserialize_vo_2d(bytes, size);
+      VResult2D *res = vo ? verify_2d(vo, q) : nullptr;
+      if (!res || res->getHash() != trusted || res->count() != live_res->count() ||
+          size != expected.size() || std::memcmp(bytes, expected.data(), size) != 0) failures++;
+      delete res;
+      delete_vo_2d(vo);
+    } else if (live_res->count() != 0) {
+      failures++;
+    }
+    delete live_res;
+    delete_vo_2d(live);
+  }
+  delete_2d_tree(root);
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== Tile store (zoom 0-" << max_zoom << ") ===" << std::endl;
+  std::cout << "Stored " << tiles << " tiles, " << store.sizeInBytes() << " bytes, in "
+            << duration_cast<milliseconds>(build_end - build_start).count() << " ms" << std::endl;
+  std::cout << "Requests served from the store: " << hits << "/" << num_requests << std::endl;
+  std::cout << "Average store lookup time: " << store_us / num_requests << " μs" << std::endl;
+  std::cout << "Average live query and serialization time: " << live_us / num_requests << " μs" << std::endl;
+
+  if (failures == 0) std::cout << "✓ All stored tiles match the live VOs" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
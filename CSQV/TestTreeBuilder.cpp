@@ -0,0 +1,97 @@
+/**
+ *  @file TestTreeBuilder.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for the push-based streaming tree builder
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "TreeBuilder2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <batch_size> [page_file]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  batch_size: number of points pushed per batch" << std::endl;
+  std::cout << "  page_file: if given, also stream the tree into this page file" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  size_t batch_size = std::max<size_t>(1, std::stoul(argv[3]));
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  std::sort(points.begin(), points.end());
+
+  auto bulk_start = high_resolution_clock::now();
+  Node2D *reference = build_sorted_2d_tree(points, capacity);
+  auto bulk_end = high_resolution_clock::now();
+
+  // Push the points batch by batch, tracking the builder's pending entries.
+  size_t failures = 0, peak = 0;
+  auto push_start = high_resolution_clock::now();
+  TreeBuilder2D<NodeSink2D> builder(NodeSink2D(), capacity);
+  for (size_t i = 0; i < points.size(); i += batch_size) {
+    std::vector<Point2D> batch(points.begin() + i, points.begin() + std::min(points.size(), i + batch_size));
+    if (!builder.add(batch)) failures++;
+    peak = std::max(peak, builder.pending());
+  }
+  if (!builder.finish()) failures++;
+  auto push_end = high_resolution_clock::now();
+  Node2D *root = builder.getRoot();
+
+  if (builder.getHash() != reference->getHash() || builder.size() != points.size() ||
+      (int) builder.getHeight() != height_2d_tree(reference)) failures++;
+
+  // Out-of-order points must be rejected.
+  if (points.size() > 1 && points.front() < points.back()) {
+    TreeBuilder2D<NodeSink2D> bad(NodeSink2D(), capacity);
+    if (!bad.add(points.back()) || bad.add(points.front())) failures++;
+  }
+
+  if (argc > 4) {
+    PageWriter2D writer;
+    PagedTree2D tree;
+    TreeBuilder2D<PageSink2D> paged(PageSink2D(writer), capacity);
+    if (!writer.open(argv[4]) || !paged.add(points) || !paged.finish() ||
+        !tree.open(argv[4], 16) || tree.getHash() != reference->getHash()) failures++;
+  }
+
+  for (const Rectangle &q : generate_random_queries_2d(compute_mbr(points), 100)) {
+    VResult2D *res = query_and_verify_2d(root, q);
+    VResult2D *expected = query_and_verify_2d(reference, q);
+    if (res->getHash() != expected->getHash() || res->count() != expected->count()) failures++;
+    delete res;
+    delete expected;
+  }
+  delete_2d_tree(root);
+  delete_2d_tree(reference);
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== Streaming tree builder (batches of " << batch_size << ") ===" << std::endl;
+  std::cout << "Peak pending entries: " << peak << " (points: " << points.size() << ")" << std::endl;
+  std::cout << "Streaming build time: " << duration_cast<microseconds>(push_end - push_start).count() << " μs" << std::endl;
+  std::cout << "Bulk build time: " << duration_cast<microseconds>(bulk_end - bulk_start).count() << " μs" << std::endl;
+
+  if (failures == 0) std::cout << "✓ The streaming build matches the bulk build" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
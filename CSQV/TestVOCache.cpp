@@ -0,0 +1,155 @@
+/**
+ *  @file TestVOCache.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for the server-side caches of serialized verification objects
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "VOCache2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <num_queries> <num_tiles> [quantum] [cache_kb]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  num_queries: number of queries, drawn with a skewed distribution from the tiles" << std::endl;
+  std::cout << "  num_tiles: number of distinct popular windows" << std::endl;
+  std::cout << "  quantum: grid step queries are snapped to (default: 1 = exact)" << std::endl;
+  std::cout << "  cache_kb: byte budget of each cache in KB (default: 65536)" << std::endl;
+}
+
+/**
+ *  Checks a serialized VO against the trusted root and the expected result size.
+ */
+static bool check(const VOBytes2D &bytes, const Rectangle &q, const hash_t &root, size_t expected) {
+  VObject2D *vo = deserialize_vo_2d(bytes->data(), bytes->size());
+  if (!vo) return false;
+  VResult2D *res = verify_2d(vo, q);
+  bool ok = res && res->getHash() == root && res->count() == expected;
+  delete res;
+  delete_vo_2d(vo);
+  return ok;
+}
+
+/**
+ *  Encodes a leaf nested in the given number of one-child containers.
+ */
+static std::vector<uint8_t> nested_vo(uint32_t depth) {
+  VObject2D *vo = new VLeaf2D(std::vector<Point2D>());
+  for (uint32_t i = 0; i < depth; i++) {
+    VContainer2D *container = new VContainer2D();
+    container->append(vo);
+    vo = container;
+  }
+  std::vector<uint8_t> bytes = serialize_vo_2d(vo);
+  delete_vo_2d(vo);
+  return bytes;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 5) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  size_t num_queries = std::stoul(argv[3]);
+  size_t num_tiles = std::stoul(argv[4]);
+  int32_t quantum = (argc > 5) ? std::stoi(argv[5]) : 1;
+  size_t cache_bytes = ((argc > 6) ? std::stoul(argv[6]) : 65536) * 1024;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+
+  // Popular windows, requested with a skewed distribution and small jitter.
+  std::vector<Rectangle> tiles = generate_random_queries_2d(compute_mbr(points), num_tiles, 0.01, 0.05);
+  std::mt19937 gen(std::random_device{}());
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::uniform_int_distribution<int32_t> jitter(0, quantum / 4);
+  std::vector<Rectangle> queries(num_queries);
+  for (Rectangle &q : queries) {
+    q = tiles[std::min(num_tiles - 1, (size_t) (num_tiles * u(gen) * u(gen)))];
+    q.lx += jitter(gen);
+    q.ly += jitter(gen);
+    q.ux = std::max(q.lx, q.ux - jitter(gen));
+    q.uy = std::max(q.ly, q.uy - jitter(gen));
+  }
+
+  // Without the cache: build and serialize every VO.
+  size_t failures = 0, bytes_sent = 0;
+  double plain_us = 0;
+  for (const Rectangle &q : queries) {
+    auto start = high_resolution_clock::now();
+    VObject2D *vo = range_query_2d(root, q);
+    VOBytes2D bytes = std::make_shared<const std::vector<uint8_t>>(serialize_vo_2d(vo));
+    plain_us += duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+    delete_vo_2d(vo);
+    if (!check(bytes, q, root->getHash(), count_in_range(points, q))) failures++;
+  }
+
+  // With the cache.
+  VOCache2D cache(cache_bytes, cache_bytes, quantum);
+  double cached_us = 0;
+  for (const Rectangle &q : queries) {
+    auto start = high_resolution_clock::now();
+    VOBytes2D bytes = cache.query(root, q);
+    cached_us += duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+    bytes_sent += bytes->size();
+    if (!check(bytes, q, root->getHash(), count_in_range(points, q))) failures++;
+  }
+
+  const VOCacheStats2D &qs = cache.getQueryStats();
+  const VOCacheStats2D &ss = cache.getSubtreeStats();
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== VO cache ===" << std::endl;
+  std::cout << "Average time without cache: " << plain_us / num_queries << " μs" << std::endl;
+  std::cout << "Average time with cache: " << cached_us / num_queries << " μs" << std::endl;
+  std::cout << "Average VO size: " << (double) bytes_sent / num_queries << " bytes" << std::endl;
+  std::cout << "Query cache: hit rate " << qs.hitRate() * 100 << "%, " << qs.entries
+            << " entries, " << qs.bytes << " bytes, " << qs.evictions << " evictions" << std::endl;
+  std::cout << "Subtree cache: hit rate " << ss.hitRate() * 100 << "%, " << ss.entries
+            << " entries, " << ss.bytes << " bytes, " << ss.evictions << " evictions" << std::endl;
+
+  // After an update the root changes, so no stale VO may be served.
+  std::vector<Point2D> updated = points;
+  updated.push_back(Point2D(UINT32_MAX, tiles[0].lx, tiles[0].ly));
+  std::vector<Point2D> updated_tree_points = updated;
+  Node2D *updated_root = build_2d_tree(updated_tree_points, capacity);
+  size_t hits_before = qs.hits;
+  for (const Rectangle &t : tiles) {
+    VOBytes2D bytes = cache.query(updated_root, t);
+    if (!check(bytes, t, updated_root->getHash(), count_in_range(updated, t))) failures++;
+  }
+  if (cache.getQueryStats().hits != hits_before) failures++;
+  std::cout << "Stale hits after update: " << cache.getQueryStats().hits - hits_before << std::endl;
+
+  // Containers nested deeper than any tree must be rejected, not recursed into.
+  std::vector<uint8_t> deepest = nested_vo(V2D_MAX_DEPTH), too_deep = nested_vo(V2D_MAX_DEPTH + 1);
+  VObject2D *accepted = deserialize_vo_2d(deepest.data(), deepest.size());
+  VObject2D *rejected = deserialize_vo_2d(too_deep.data(), too_deep.size());
+  if (!accepted || rejected) failures++;
+  std::cout << (rejected ? "✗ Over-deep VO accepted" : "✓ Over-deep VO rejected") << std::endl;
+  delete_vo_2d(accepted);
+  delete_vo_2d(rejected);
+
+  delete_2d_tree(root);
+  delete_2d_tree(updated_root);
+
+  if (failures == 0) std::cout << "✓ All cached VOs verified" << std::endl;
+  else std::cout << "✗ " << failures << " VOs failed" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
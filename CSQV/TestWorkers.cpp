@@ -0,0 +1,116 @@
+/**
+ *  @file TestWorkers.cpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Test program for query worker processes over a tree in shared memory
+ */
+
+#include "Point2D.hpp"
+#include "Node2D.hpp"
+#include "Query2D.hpp"
+#include "Workers2D.hpp"
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <cstdio>
+
+using namespace std::chrono;
+
+void print_usage(const char* program_name) {
+  std::cout << "Usage: " << program_name << " <data_file> <capacity> <page_file> <workers> [num_queries] [depth]" << std::endl;
+  std::cout << "  data_file: CSV file with 2D points" << std::endl;
+  std::cout << "  capacity: Maximum number of points per leaf node" << std::endl;
+  std::cout << "  page_file: page file written for the shared segment (removed at the end)" << std::endl;
+  std::cout << "  workers: number of worker processes" << std::endl;
+  std::cout << "  num_queries: number of random queries per batch (default: 1000)" << std::endl;
+  std::cout << "  depth: requests in flight per worker (default: " << WORKER2D_DEFAULT_DEPTH << ")" << std::endl;
+}
+
+/**
+ *  Checks the replies of a batch against the trusted root and the points.
+ */
+static size_t check_replies(const std::vector<std::vector<uint8_t>> &replies, const std::vector<Rectangle> &queries,
+                            const std::vector<Point2D> &points, const hash_t &root) {
+  size_t failures = 0;
+  for (size_t i = 0; i < queries.size(); i++) {
+    VObject2D *vo = deserialize_vo_2d(replies[i].data(), replies[i].size());
+    VResult2D *res = vo ? verify_2d(vo, queries[i]) : nullptr;
+    if (!res || res->getHash() != root || res->count() != count_in_range(points, queries[i])) failures++;
+    delete res;
+    delete_vo_2d(vo);
+  }
+  return failures;
+}
+
+int main(int argc, char const *argv[]) {
+  if (argc < 5) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string data_file = argv[1];
+  size_t capacity = std::stoul(argv[2]);
+  std::string page_file = argv[3];
+  size_t n_workers = std::stoul(argv[4]);
+  size_t num_queries = (argc > 5) ? std::stoul(argv[5]) : 1000;
+  size_t depth = (argc > 6) ? std::stoul(argv[6]) : WORKER2D_DEFAULT_DEPTH;
+
+  std::vector<Point2D> points = load_points_file(data_file);
+  if (points.empty()) {
+    std::cerr << "Error: No points loaded from data file" << std::endl;
+    return 1;
+  }
+  std::vector<Point2D> tree_points = points;
+  Node2D *root = build_2d_tree(tree_points, capacity);
+  hash_t digest = root->getHash();
+  bool written = write_page_file_2d(root, page_file);
+
+  // Reference: the same queries answered and encoded in this process.
+  std::vector<Rectangle> queries = generate_random_queries_2d(compute_mbr(points), num_queries);
+  auto local_start = high_resolution_clock::now();
+  for (const Rectangle &q : queries) {
+    VObject2D *vo = range_query_2d(root, q);
+    std::vector<uint8_t> bytes = serialize_vo_2d(vo);
+    delete_vo_2d(vo);
+  }
+  auto local_end = high_resolution_clock::now();
+  delete_2d_tree(root);
+
+  SharedTree2D shared;
+  WorkerPool2D pool;
+  std::string segment = "/csqv-workers-" + std::to_string(system_clock::now().time_since_epoch().count() % 1000000007);
+  if (!written || !shared.create(segment, page_file) || !pool.start(segment, n_workers)) {
+    std::remove(page_file.c_str());
+    std::cerr << "Error: cannot set up the workers" << std::endl;
+    return 1;
+  }
+  std::remove(page_file.c_str());
+
+  size_t failures = 0;
+  std::vector<std::vector<uint8_t>> replies;
+  auto batch_start = high_resolution_clock::now();
+  if (!pool.query(queries, replies, depth)) failures++;
+  auto batch_end = high_resolution_clock::now();
+  failures += check_replies(replies, queries, points, digest);
+
+  // A killed worker is restarted and its requests are answered again.
+  pool.kill(0);
+  if (!pool.query(queries, replies, depth)) failures++;
+  failures += check_replies(replies, queries, points, digest);
+  if (pool.getStats().restarts == 0) failures++;
+  pool.stop();
+
+  double batch_us = duration_cast<microseconds>(batch_end - batch_start).count();
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "=== " << n_workers << " worker processes on a shared tree ===" << std::endl;
+  std::cout << "Shared segment: " << shared.sizeInBytes() << " bytes (points: "
+            << points.size() * sizeof(Point2D) << " bytes)" << std::endl;
+  std::cout << "Batch time: " << batch_us / 1000.0 << " ms (" << queries.size() / (batch_us / 1e6) << " queries/s)" << std::endl;
+  std::cout << "In-process time: " << duration_cast<microseconds>(local_end - local_start).count() / 1000.0 << " ms" << std::endl;
+  std::cout << "Requests: " << pool.getStats().requests << ", replies: " << pool.getStats().replies
+            << ", worker restarts: " << pool.getStats().restarts << std::endl;
+
+  if (failures == 0) std::cout << "✓ All worker replies verify against the root" << std::endl;
+  else std::cout << "✗ " << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+/**
+ *  @file TileStore2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "TileStore2D.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <tuple>
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ *  Magic number and version of tile store files.
+ */
+#define TILE_MAGIC "CSQVTILE"
+#define TILE_VERSION 1
+
+/**
+ *  Size of the file header.
+ */
+#define TILE_HEADER_SIZE (8 + sizeof(uint32_t) + SHA256_DIGEST_LENGTH + 4 * sizeof(int32_t) + sizeof(uint32_t))
+
+/**
+ *  Orders index entries by zoom level, row and column.
+ */
+static inline bool tile_less_2d(const TileEntry2D &a, const TileEntry2D &b) {
+  return std::tie(a.z, a.y, a.x) < std::tie(b.z, b.y, b.x);
+}
+
+/**
+ *  Returns the width of the tiles of 2^z columns over [lo, hi].
+ */
+static inline int64_t tile_width_2d(int32_t lo, int32_t hi, uint32_t z) {
+  int64_t extent = (int64_t) hi - lo + 1;
+  int64_t n = (int64_t) 1 << z;
+  return std::max<int64_t>(1, (extent + n - 1) / n);
+}
+
+/**
+ *  Returns the rectangle of a tile of the pyramid over an MBR.
+ */
+Rectangle tile_rect_2d(const Rectangle &mbr, uint32_t z, uint32_t x, uint32_t y) {
+  if (z > TILE_MAX_ZOOM) return EMPTY_RECT;
+  int64_t w = tile_width_2d(mbr.lx, mbr.ux, z), h = tile_width_2d(mbr.ly, mbr.uy, z);
+  int64_t lx = mbr.lx + x * w, ly = mbr.ly + y * h;
+  if (lx > mbr.ux || ly > mbr.uy) return EMPTY_RECT;
+  return Rectangle{(int32_t) lx, (int32_t) ly,
+                   (int32_t) std::min<int64_t>(lx + w - 1, mbr.ux),
+                   (int32_t) std::min<int64_t>(ly + h - 1, mbr.uy)};
+}
+
+/**
+ *  Collects the distinct locations of a tree.
+ */
+static void collect_locations_2d(Node2D *node, std::set<std::pair<int32_t, int32_t>> &out) {
+  if (node->getType() == N2D_LEAF) {
+    for (const Point2D &p : static_cast<LeafNode2D*>(node)->getPoints()) out.insert({p.loc.x, p.loc.y});
+    return;
+  }
+  for (Node2D *child : static_cast<IntNode2D*>(node)->getChildren()) collect_locations_2d(child, out);
+}
+
+/**
+ *  Builds a tile store file for the given zoom levels.
+ */
+size_t build_tile_store_2d(Node2D *root, const std::vector<uint32_t> &zooms,
+                           const std::string &path) {
+  if (!root) return 0;
+  Rectangle mbr = root->getRect();
+  std::set<std::pair<int32_t, int32_t>> locations;
+  collect_locations_2d(root, locations);
+  
+  // Non-empty tiles of each zoom level, in index order.
+  std::vector<TileEntry2D> index;
+  for (uint32_t z : zooms) {
+    if (z > TILE_MAX_ZOOM) {
+      std::cerr << "Error building tile store: zoom level " << z << " above " << TILE_MAX_ZOOM << std::endl;
+      return 0;
+    }
+    int64_t w = tile_width_2d(mbr.lx, mbr.ux, z), h = tile_width_2d(mbr.ly, mbr.uy, z);
+    std::set<std::pair<uint32_t, uint32_t>> tiles;
+    for (const auto &loc : locations) {
+      tiles.insert({(uint32_t) (((int64_t) loc.second - mbr.ly) / h),
+                    (uint32_t) (((int64_t) loc.first - mbr.lx) / w)});
+    }
+    for (const auto &t : tiles) index.push_back(TileEntry2D{z, t.second, t.first, 0, 0});
+  }
+  std::sort(index.begin(), index.end(), tile_less_2d);
+  index.erase(std::unique(index.begin(), index.end(),
+    [](const TileEntry2D &a, const TileEntry2D &b) { return !tile_less_2d(a, b) && !tile_less_2d(b, a); }),
+    index.end());
+  
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    std::cerr << "Error building tile store: cannot open " << path << std::endl;
+    return 0;
+  }
+  
+  // The index is written twice: once as a placeholder, then with the offsets.
+  hash_t hash = root->getHash();
+  uint32_t version = TILE_VERSION, count = (uint32_t) index.size();
+  file.write(TILE_MAGIC, 8);
+  file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  file.write(reinterpret_cast<const char*>(hash.data()), hash.size());
+  file.write(reinterpret_cast<const char*>(&mbr.lx), sizeof(int32_t));
+  file.write(reinterpret_cast<const char*>(&mbr.ly), sizeof(int32_t));
+  file.write(reinterpret_cast<const char*>(&mbr.ux), sizeof(int32_t));
+  file.write(reinterpret_cast<const char*>(&mbr.uy), sizeof(int32_t));
+  file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(TileEntry2D));
+  
+  uint64_t offset = TILE_HEADER_SIZE + index.size() * sizeof(TileEntry2D);
+  std::vector<uint8_t> buf;
+  for (TileEntry2D &e : index) {
+    Rectangle q = tile_rect_2d(mbr, e.z, e.x, e.y);
+    VObject2D *vo = range_query_2d(root, q);
+    buf.clear();
+    serialize_vo_2d(vo, buf);
+    delete_vo_2d(vo);
+    e.offset = offset;
+    e.size = (uint32_t) buf.size();
+    file.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+    offset += buf.size();
+  }
+  
+  file.seekp(TILE_HEADER_SIZE);
+  file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(TileEntry2D));
+  if (!file) {
+    std::cerr << "Error building tile store: cannot write " << path << std::endl;
+    return 0;
+  }
+  return index.size();
+}
+
+/**
+ *  Maps a tile store file.
+ */
+bool TileStore2D::open(const std::string &path) {
+  close();
+  
+#ifdef _WIN32
+  // No mmap: the file is read into memory instead.
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return false;
+  std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (bytes.empty()) return false;
+  uint8_t *copy = new uint8_t[bytes.size()];
+  std::memcpy(copy, bytes.data(), bytes.size());
+  data = copy;
+  length = bytes.size();
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+  void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) return false;
+  data = static_cast<const uint8_t*>(map);
+  length = st.st_size;
+#endif
+  
+  // Check the header and that the index and all VOs lie inside the file.
+  uint32_t version, count;
+  if (length < TILE_HEADER_SIZE || std::memcmp(data, TILE_MAGIC, 8) != 0) {
+    close();
+    return false;
+  }
+  const uint8_t *p = data + 8;
+  std::memcpy(&version, p, sizeof(version));
+  p += sizeof(version);
+  std::memcpy(root.data(), p, root.size());
+  p += root.size();
+  std::memcpy(&mbr.lx, p, sizeof(int32_t));
+  std::memcpy(&mbr.ly, p + sizeof(int32_t), sizeof(int32_t));
+  std::memcpy(&mbr.ux, p + 2 * sizeof(int32_t), sizeof(int32_t));
+  std::memcpy(&mbr.uy, p + 3 * sizeof(int32_t), sizeof(int32_t));
+  p += 4 * sizeof(int32_t);
+  std::memcpy(&count, p, sizeof(count));
+  if (version != TILE_VERSION || (length - TILE_HEADER_SIZE) / sizeof(TileEntry2D) < count) {
+    close();
+    return false;
+  }
+  entries = reinterpret_cast<const TileEntry2D*>(data + TILE_HEADER_SIZE);
+  n_entries = count;
+  for (size_t i = 0; i < n_entries; i++) {
+    if (entries[i].offset > length || entries[i].size > length - entries[i].offset) {
+      close();
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ *  Unmaps the file.
+ */
+void TileStore2D::close() {
+  if (data) {
+#ifdef _WIN32
+    delete[] data;
+#else
+    munmap(const_cast<uint8_t*>(data), length);
+#endif
+  }
+  data = nullptr;
+  length = 0;
+  entries = nullptr;
+  n_entries = 0;
+}
+
+/**
+ *  Looks up the serialized VO of a tile.
+ */
+const uint8_t *TileStore2D::lookup(uint32_t z, uint32_t x, uint32_t y, size_t &size) const {
+  size = 0;
+  TileEntry2D key{z, x, y, 0, 0};
+  const TileEntry2D *it = std::lower_bound(entries, entries + n_entries, key, tile_less_2d);
+  if (it == entries + n_entries || it->z != z || it->x != x || it->y != y) return nullptr;
+  size = it->size;
+  return data + it->offset;
+}
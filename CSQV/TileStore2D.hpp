@@ -0,0 +1,112 @@
+/**
+ *  @file TileStore2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Precomputed tile-pyramid store of serialized verification objects.
+ *
+ *  At zoom level z the MBR of the data is split into 2^z × 2^z tiles. An
+ *  offline build serializes the VO of the range query of every non-empty
+ *  tile into one file: a header, a sorted index of (z, x, y, offset, size)
+ *  entries and the VOs. The store maps the file in memory, so serving a
+ *  tile is a binary search over the index and a pointer into the mapping.
+ *  Empty tiles are not stored and are answered with a live range query.
+ *
+ *  File layout (native endian):
+ *    magic "CSQVTILE", u32 version, 32-byte root digest, 4 × i32 MBR,
+ *    u32 number of entries, entries of TileEntry2D, then the VOs.
+ */
+
+#ifndef TILESTORE2D_H
+#define TILESTORE2D_H
+
+#include "Query2D.hpp"
+#include <string>
+#include <vector>
+
+/**
+ *  Maximum zoom level (tile coordinates must fit in 32 bits).
+ */
+#define TILE_MAX_ZOOM 31
+
+/**
+ *  Index entry of a tile.
+ */
+struct TileEntry2D {
+  uint32_t z;      ///< Zoom level
+  uint32_t x;      ///< Column
+  uint32_t y;      ///< Row
+  uint32_t size;   ///< Size of the serialized VO
+  uint64_t offset; ///< Offset of the serialized VO from the start of the file
+};
+
+/**
+ *  Returns the rectangle of a tile of the pyramid over an MBR.
+ *  @param mbr the MBR of the data
+ *  @param z the zoom level
+ *  @param x the column
+ *  @param y the row
+ *  @return the tile rectangle (empty if the tile is outside the MBR)
+ */
+Rectangle tile_rect_2d(const Rectangle &mbr, uint32_t z, uint32_t x, uint32_t y);
+
+/**
+ *  Builds a tile store file for the given zoom levels.
+ *  @param root the root of the 2D MR-tree
+ *  @param zooms the zoom levels
+ *  @param path the output file
+ *  @return the number of tiles stored, or 0 on error
+ */
+size_t build_tile_store_2d(Node2D *root, const std::vector<uint32_t> &zooms,
+                           const std::string &path);
+
+/**
+ *  Read-only view of a tile store file, mapped in memory.
+ */
+class TileStore2D {
+private:
+  const uint8_t *data;        ///< Start of the mapping
+  size_t length;              ///< Length of the mapping
+  hash_t root;                ///< Root digest of the tree of the VOs
+  Rectangle mbr;              ///< MBR of the pyramid
+  const TileEntry2D *entries; ///< Sorted index
+  size_t n_entries;           ///< Number of entries
+
+public:
+  /**
+   *  Creates a closed store.
+   */
+  TileStore2D() : data(nullptr), length(0), root{}, mbr(EMPTY_RECT), entries(nullptr), n_entries(0) {}
+  ~TileStore2D() { close(); }
+  TileStore2D(const TileStore2D &) = delete;
+  TileStore2D &operator=(const TileStore2D &) = delete;
+
+  /**
+   *  Maps a tile store file.
+   *  @param path the file
+   *  @return false if the file cannot be mapped or is malformed
+   */
+  bool open(const std::string &path);
+
+  /**
+   *  Unmaps the file.
+   */
+  void close();
+
+  bool isOpen() const { return data != nullptr; }
+  const hash_t &getRoot() const { return root; }
+  Rectangle getMBR() const { return mbr; }
+  size_t size() const { return n_entries; }
+  size_t sizeInBytes() const { return length; }
+
+  /**
+   *  Looks up the serialized VO of a tile.
+   *  @param z the zoom level
+   *  @param x the column
+   *  @param y the row
+   *  @param size receives the size of the VO
+   *  @return the serialized VO, or nullptr if the tile is empty or not stored
+   */
+  const uint8_t *lookup(uint32_t z, uint32_t x, uint32_t y, size_t &size) const;
+};
+
+#endif
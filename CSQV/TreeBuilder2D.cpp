@@ -0,0 +1,43 @@
+/**
+ *  @file TreeBuilder2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "TreeBuilder2D.hpp"
+
+/**
+ *  Makes an in-memory leaf.
+ */
+bool NodeSink2D::leaf(std::vector<Point2D> points, Entry &out) {
+  out = make_leaf_2d(std::move(points), attrs);
+  return true;
+}
+
+/**
+ *  Makes an in-memory internal node.
+ */
+bool NodeSink2D::internal(std::vector<Entry> children, Entry &out) {
+  out = make_internal_2d(std::move(children));
+  return true;
+}
+
+/**
+ *  Writes a leaf page.
+ */
+bool PageSink2D::leaf(std::vector<Point2D> points, Entry &out) {
+  return writer.writeLeaf(points, std::vector<hash_t>(), out);
+}
+
+/**
+ *  Writes an internal page.
+ */
+bool PageSink2D::internal(std::vector<Entry> children, Entry &out) {
+  return writer.writeInternal(children, out);
+}
+
+/**
+ *  Writes the header of the page file.
+ */
+bool PageSink2D::finish(const Entry &root, uint64_t points, uint32_t height) {
+  return writer.finish(root, points, height);
+}
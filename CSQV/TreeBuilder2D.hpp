@@ -0,0 +1,200 @@
+/**
+ *  @file TreeBuilder2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Push-based builder of MR-trees over points arriving in sort order.
+ *
+ *  Points are added one batch at a time. A leaf is emitted as soon as it
+ *  is full and climbs a stack holding one pending node per level, so the
+ *  builder keeps O(height × capacity) entries; partial nodes are closed by
+ *  finish. Nodes are grouped exactly as build_sorted_2d_tree groups them.
+ *  Where nodes go is up to a sink: NodeSink2D makes in-memory nodes,
+ *  PageSink2D writes pages to a PageWriter2D.
+ */
+
+#ifndef TREEBUILDER2D_H
+#define TREEBUILDER2D_H
+
+#include "Node2D.hpp"
+#include "PageFile2D.hpp"
+#include <vector>
+
+/**
+ *  Sink making in-memory MR-tree nodes.
+ */
+class NodeSink2D {
+private:
+  const AttributeStore *attrs;
+
+public:
+  typedef Node2D *Entry;
+
+  NodeSink2D(const AttributeStore *attrs = nullptr) : attrs(attrs) {}
+  bool leaf(std::vector<Point2D> points, Entry &out);
+  bool internal(std::vector<Entry> children, Entry &out);
+  bool finish(const Entry &, uint64_t, uint32_t) { return true; }
+  static hash_t hashOf(const Entry &e) { return e->getHash(); }
+  static void discard(Entry &e) { delete_2d_tree(e); }
+};
+
+/**
+ *  Sink writing the nodes to a page file.
+ */
+class PageSink2D {
+private:
+  PageWriter2D &writer;
+
+public:
+  typedef PageEntry2D Entry;
+
+  PageSink2D(PageWriter2D &writer) : writer(writer) {}
+  bool leaf(std::vector<Point2D> points, Entry &out);
+  bool internal(std::vector<Entry> children, Entry &out);
+  bool finish(const Entry &root, uint64_t points, uint32_t height);
+  static hash_t hashOf(const Entry &e) { return e.hash; }
+  static void discard(Entry &) {}
+};
+
+/**
+ *  Push-based MR-tree builder.
+ */
+template <typename Sink>
+class TreeBuilder2D {
+public:
+  typedef typename Sink::Entry Entry;
+
+private:
+  Sink sink;
+  size_t capacity;
+  std::vector<Point2D> leaf;               ///< Points of the pending leaf
+  Point2D last;                            ///< Last point added
+  std::vector<std::vector<Entry>> levels;  ///< Pending entries of each level
+  uint64_t count;                          ///< Points added
+  uint32_t height;                         ///< Levels of the finished tree
+  Entry root;
+  bool ok;                                 ///< False after an error
+  bool done;                               ///< True once finished
+
+  /**
+   *  Adds an entry at a level, emitting the pending node if it is full.
+   */
+  void push(size_t level, Entry e) {
+    if (levels.size() <= level) levels.resize(level + 1);
+    levels[level].push_back(e);
+    if (levels[level].size() == capacity) {
+      Entry node;
+      ok = ok && sink.internal(std::move(levels[level]), node);
+      levels[level].clear();
+      if (ok) push(level + 1, node);
+    }
+  }
+
+  void emitLeaf() {
+    Entry e;
+    ok = ok && sink.leaf(std::move(leaf), e);
+    leaf.clear();
+    leaf.reserve(capacity);
+    if (ok) push(0, e);
+  }
+
+public:
+  /**
+   *  Creates a builder.
+   *  @param sink the sink of the nodes
+   *  @param capacity the maximum number of points per leaf and children per node (at least 2)
+   */
+  TreeBuilder2D(Sink sink, size_t capacity)
+  : sink(sink), capacity(capacity), count(0), height(0), root(), ok(capacity >= 2), done(false) {
+    leaf.reserve(capacity);
+  }
+
+  /**
+   *  Frees the pending nodes of an unfinished build. A finished root
+   *  belongs to the caller.
+   */
+  ~TreeBuilder2D() {
+    for (auto &l : levels) {
+      for (Entry &e : l) Sink::discard(e);
+    }
+  }
+
+  TreeBuilder2D(const TreeBuilder2D &) = delete;
+  TreeBuilder2D &operator=(const TreeBuilder2D &) = delete;
+
+  /**
+   *  Adds a point, which must not precede the previous one in sort order.
+   *  @return false if the point is out of order, the builder is finished or the sink failed
+   */
+  bool add(const Point2D &p) {
+    if (!ok || done) return false;
+    if (count > 0 && p < last) return false;
+    leaf.push_back(p);
+    last = p;
+    count++;
+    if (leaf.size() == capacity) emitLeaf();
+    return ok;
+  }
+
+  /**
+   *  Adds a batch of points in sort order.
+   *  @return false if a point is out of order, the builder is finished or the sink failed
+   */
+  bool add(const std::vector<Point2D> &batch) {
+    for (const Point2D &p : batch) {
+      if (!add(p)) return false;
+    }
+    return true;
+  }
+
+  /**
+   *  Closes the partial nodes bottom-up and hands the root to the sink.
+   *  @return false if no point was added or the sink failed
+   */
+  bool finish() {
+    if (!ok || done || count == 0) return false;
+    done = true;
+    if (!leaf.empty()) emitLeaf();
+    for (size_t level = 0; ok && level < levels.size(); level++) {
+      bool top = true;
+      for (size_t up = level + 1; up < levels.size(); up++) top = top && levels[up].empty();
+      if (top && levels[level].size() == 1) {
+        root = levels[level][0];
+        height = (uint32_t) level + 1;
+        levels.clear();
+        return ok = sink.finish(root, count, height);
+      }
+      if (!levels[level].empty()) {
+        Entry node;
+        ok = ok && sink.internal(std::move(levels[level]), node);
+        levels[level].clear();
+        if (ok) push(level + 1, node);
+      }
+    }
+    return ok = false;
+  }
+
+  /**
+   *  Returns the root once finished.
+   */
+  const Entry &getRoot() const { return root; }
+
+  /**
+   *  Returns the root digest once finished.
+   */
+  hash_t getHash() const { return (done && ok) ? Sink::hashOf(root) : hash_t{}; }
+
+  uint64_t size() const { return count; }
+  uint32_t getHeight() const { return height; }
+  bool good() const { return ok; }
+
+  /**
+   *  Returns the number of pending entries (points and children).
+   */
+  size_t pending() const {
+    size_t n = leaf.size();
+    for (const auto &l : levels) n += l.size();
+    return n;
+  }
+};
+
+#endif
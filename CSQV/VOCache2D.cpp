@@ -0,0 +1,111 @@
+/**
+ *  @file VOCache2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "VOCache2D.hpp"
+#include <algorithm>
+
+/**
+ *  Creates the caches.
+ */
+VOCache2D::VOCache2D(size_t query_bytes, size_t subtree_bytes, int32_t quantum)
+: quantum(std::max<int32_t>(quantum, 1)), queries(query_bytes), subtrees(subtree_bytes),
+  subtree_tree(nullptr), subtree_root{} {}
+
+/**
+ *  Snaps a coordinate range outward to the grid, within the int32 range.
+ */
+static void snap_range(int32_t lo, int32_t hi, int32_t quantum, int32_t &out_lo, int32_t &out_hi) {
+  int64_t q = quantum;
+  int64_t l = lo, h = (int64_t) hi + 1;
+  l = (l >= 0) ? l / q * q : -((-l + q - 1) / q) * q;
+  h = (h >= 0) ? (h + q - 1) / q * q : -((-h) / q) * q;
+  out_lo = (int32_t) std::max<int64_t>(l, INT32_MIN);
+  out_hi = (int32_t) std::min<int64_t>(h - 1, INT32_MAX);
+}
+
+/**
+ *  Returns the rectangle a query is snapped to.
+ */
+Rectangle VOCache2D::snap(const Rectangle &q) const {
+  if (quantum == 1) return q;
+  Rectangle r;
+  snap_range(q.lx, q.ux, quantum, r.lx, r.ux);
+  snap_range(q.ly, q.uy, quantum, r.ly, r.uy);
+  return r;
+}
+
+/**
+ *  Appends the encoding of the VO of a subtree, like range_query_2d followed
+ *  by serialize_vo_2d, copying cached leaf and pruned-node encodings. Nodes
+ *  are pruned with the closed overlap test, so that a subtree touching the
+ *  query border only through its matching points is still opened.
+ */
+void VOCache2D::encode(Node2D *node, const Rectangle &query, std::vector<uint8_t> &out,
+                       QueryStats2D *stats) {
+  if (stats) stats->nodes_visited++;
+  
+  bool is_leaf = (node->getType() == N2D_LEAF);
+  bool pruned = !is_leaf && !overlap(node->getRect(), query);
+  if (is_leaf || pruned) {
+    if (stats && is_leaf) stats->points_examined += static_cast<LeafNode2D*>(node)->size();
+    if (stats && pruned) stats->nodes_pruned++;
+    
+    VOSubtreeKey2D key{node, pruned};
+    VOBytes2D bytes = subtrees.get(key);
+    if (!bytes) {
+      VObject2D *vo;
+      if (pruned) {
+        vo = new VPruned2D(node->getRect(), node->getHash());
+      } else {
+        vo = ship_leaf_2d(static_cast<LeafNode2D*>(node));
+      }
+      bytes = std::make_shared<const std::vector<uint8_t>>(serialize_vo_2d(vo));
+      delete_vo_2d(vo);
+      subtrees.put(key, bytes);
+    }
+    out.insert(out.end(), bytes->begin(), bytes->end());
+    return;
+  }
+  
+  IntNode2D *internal = static_cast<IntNode2D*>(node);
+  uint8_t tag = V2D_CONTAINER;
+  uint32_t n = internal->getChildren().size();
+  out.push_back(tag);
+  const uint8_t *ptr = reinterpret_cast<const uint8_t*>(&n);
+  out.insert(out.end(), ptr, ptr + sizeof(n));
+  for (Node2D *child : internal->getChildren()) encode(child, query, out, stats);
+}
+
+/**
+ *  Returns the serialized VO answering a query.
+ */
+VOBytes2D VOCache2D::query(Node2D *root, const Rectangle &q, QueryStats2D *stats) {
+  if (!root) return nullptr;
+  
+  VOQueryKey2D key{root->getHash(), snap(q)};
+  VOBytes2D bytes = queries.get(key);
+  if (bytes) return bytes;
+  
+  // Node addresses are only meaningful for the tree they were cached from.
+  if (subtree_tree != root || subtree_root != key.root) {
+    subtrees.clear();
+    subtree_tree = root;
+    subtree_root = key.root;
+  }
+  
+  std::vector<uint8_t> out;
+  encode(root, key.rect, out, stats);
+  bytes = std::make_shared<const std::vector<uint8_t>>(std::move(out));
+  queries.put(key, bytes);
+  return bytes;
+}
+
+/**
+ *  Empties both caches.
+ */
+void VOCache2D::clear() {
+  queries.clear();
+  subtrees.clear();
+}
@@ -0,0 +1,203 @@
+/**
+ *  @file VOCache2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Server-side caches of serialized verification objects.
+ *
+ *  The query cache maps (root digest, query rectangle snapped outward to a
+ *  grid) to the serialized VO of the snapped rectangle, which also verifies
+ *  the original query: it ships every leaf intersecting the snapped window,
+ *  and the client filters points with the exact rectangle. The subtree cache
+ *  keeps the encodings of frequently emitted leaves and pruned nodes, so
+ *  that query misses are assembled by copying bytes. Both caches are LRU
+ *  with a byte budget, and entries of an older root are never returned.
+ */
+
+#ifndef VOCACHE2D_H
+#define VOCACHE2D_H
+
+#include "Query2D.hpp"
+#include <cstring>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+/**
+ *  A serialized verification object, shared between the cache and its readers.
+ */
+typedef std::shared_ptr<const std::vector<uint8_t>> VOBytes2D;
+
+/**
+ *  Hit-rate metrics of a cache.
+ */
+struct VOCacheStats2D {
+  size_t hits;       ///< Lookups answered by the cache
+  size_t misses;     ///< Lookups not answered by the cache
+  size_t evictions;  ///< Entries evicted to respect the byte budget
+  size_t entries;    ///< Current number of entries
+  size_t bytes;      ///< Current size of the cached values
+
+  VOCacheStats2D() : hits(0), misses(0), evictions(0), entries(0), bytes(0) {}
+
+  double hitRate() const { return (hits + misses) ? (double) hits / (hits + misses) : 0.0; }
+};
+
+/**
+ *  LRU cache of byte strings with a byte budget.
+ */
+template <typename Key, typename KeyHash>
+class LRUCache2D {
+private:
+  typedef std::list<std::pair<Key, VOBytes2D>> List;
+
+  size_t capacity;                                                  ///< Byte budget
+  List order;                                                       ///< Entries, most recently used first
+  std::unordered_map<Key, typename List::iterator, KeyHash> index;  ///< Entries by key
+  VOCacheStats2D stats;
+
+public:
+  LRUCache2D(size_t capacity) : capacity(capacity) {}
+
+  /**
+   *  Returns the value of a key (nullptr on a miss) and marks it as recently used.
+   */
+  VOBytes2D get(const Key &key) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+      stats.misses++;
+      return nullptr;
+    }
+    stats.hits++;
+    order.splice(order.begin(), order, it->second);
+    return it->second->second;
+  }
+
+  /**
+   *  Inserts a value, evicting the least recently used entries if needed.
+   *  Values larger than the whole budget are not cached.
+   */
+  void put(const Key &key, VOBytes2D value) {
+    if (!value || value->size() > capacity) return;
+    auto it = index.find(key);
+    if (it != index.end()) {
+      stats.bytes -= it->second->second->size();
+      order.erase(it->second);
+      index.erase(it);
+    }
+    while (!order.empty() && stats.bytes + value->size() > capacity) {
+      stats.bytes -= order.back().second->size();
+      index.erase(order.back().first);
+      order.pop_back();
+      stats.evictions++;
+    }
+    order.emplace_front(key, value);
+    index[key] = order.begin();
+    stats.bytes += value->size();
+    stats.entries = order.size();
+  }
+
+  /**
+   *  Removes all entries (metrics are kept).
+   */
+  void clear() {
+    order.clear();
+    index.clear();
+    stats.bytes = 0;
+    stats.entries = 0;
+  }
+
+  const VOCacheStats2D &getStats() const { return stats; }
+};
+
+/**
+ *  Key of the query cache.
+ */
+struct VOQueryKey2D {
+  hash_t root;     ///< Root digest of the tree
+  Rectangle rect;  ///< Snapped query rectangle
+
+  bool operator==(const VOQueryKey2D &k) const {
+    return root == k.root && rect.lx == k.rect.lx && rect.ly == k.rect.ly &&
+           rect.ux == k.rect.ux && rect.uy == k.rect.uy;
+  }
+};
+
+struct VOQueryKeyHash2D {
+  size_t operator()(const VOQueryKey2D &k) const {
+    uint64_t h;
+    std::memcpy(&h, k.root.data(), sizeof(h));
+    for (int32_t c : {k.rect.lx, k.rect.ly, k.rect.ux, k.rect.uy}) {
+      h = (h ^ static_cast<uint32_t>(c)) * 0x100000001B3ULL;
+    }
+    return static_cast<size_t>(h);
+  }
+};
+
+/**
+ *  Key of the subtree cache: a node, emitted either pruned or opened.
+ */
+struct VOSubtreeKey2D {
+  const Node2D *node;
+  bool pruned;
+
+  bool operator==(const VOSubtreeKey2D &k) const { return node == k.node && pruned == k.pruned; }
+};
+
+struct VOSubtreeKeyHash2D {
+  size_t operator()(const VOSubtreeKey2D &k) const {
+    return std::hash<const void*>()(k.node) ^ static_cast<size_t>(k.pruned);
+  }
+};
+
+/**
+ *  Two-level cache of serialized verification objects for one tree.
+ */
+class VOCache2D {
+private:
+  int32_t quantum;                                            ///< Grid step queries are snapped to
+  LRUCache2D<VOQueryKey2D, VOQueryKeyHash2D> queries;         ///< Serialized VOs by snapped query
+  LRUCache2D<VOSubtreeKey2D, VOSubtreeKeyHash2D> subtrees;    ///< Encodings of leaves and pruned nodes
+  const Node2D *subtree_tree;                                 ///< Tree the subtree cache refers to
+  hash_t subtree_root;                                        ///< Root digest of that tree
+
+  void encode(Node2D *node, const Rectangle &query, std::vector<uint8_t> &out,
+              QueryStats2D *stats);
+
+public:
+  /**
+   *  Creates the caches.
+   *  @param query_bytes byte budget of the query cache
+   *  @param subtree_bytes byte budget of the subtree cache (0 disables it)
+   *  @param quantum grid step, in coordinate units, queries are snapped to (1 = exact)
+   */
+  VOCache2D(size_t query_bytes, size_t subtree_bytes, int32_t quantum = 1);
+
+  /**
+   *  Returns the rectangle a query is snapped to.
+   *  @param q the query rectangle
+   *  @return the smallest grid-aligned rectangle containing q
+   */
+  Rectangle snap(const Rectangle &q) const;
+
+  /**
+   *  Returns the serialized VO answering a query: from the query cache if
+   *  possible, otherwise built for the snapped rectangle (using the subtree
+   *  cache) and inserted. The client verifies it with deserialize_vo_2d and
+   *  verify_2d on the original rectangle.
+   *  @param root the root of the 2D MR-tree
+   *  @param q the query rectangle
+   *  @param stats optional statistics collector
+   *  @return the serialized VO
+   */
+  VOBytes2D query(Node2D *root, const Rectangle &q, QueryStats2D *stats = nullptr);
+
+  const VOCacheStats2D &getQueryStats() const { return queries.getStats(); }
+  const VOCacheStats2D &getSubtreeStats() const { return subtrees.getStats(); }
+
+  /**
+   *  Empties both caches.
+   */
+  void clear();
+};
+
+#endif
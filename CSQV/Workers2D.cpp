@@ -0,0 +1,340 @@
+/**
+ *  @file Workers2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "Workers2D.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+
+// No POSIX shared memory, fork or Unix sockets: every entry point fails.
+
+bool SharedTree2D::create(const std::string &, const std::string &) {
+  std::cerr << "Error: shared-memory trees need a POSIX system" << std::endl;
+  return false;
+}
+
+bool SharedTree2D::attach(const std::string &) {
+  std::cerr << "Error: shared-memory trees need a POSIX system" << std::endl;
+  return false;
+}
+
+void SharedTree2D::close() {}
+
+bool WorkerPool2D::start(const std::string &, size_t) {
+  std::cerr << "Error: worker processes need a POSIX system" << std::endl;
+  return false;
+}
+
+void WorkerPool2D::stop() {}
+
+bool WorkerPool2D::query(const std::vector<Rectangle> &queries, std::vector<std::vector<uint8_t>> &out,
+                         size_t) {
+  out.assign(queries.size(), std::vector<uint8_t>());
+  return queries.empty();
+}
+
+bool WorkerPool2D::kill(size_t) { return false; }
+
+#else
+
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ *  Size of a request (the query rectangle).
+ */
+#define WORKER2D_REQUEST_SIZE (4 * sizeof(int32_t))
+
+/**
+ *  Reads exactly size bytes; false on end of stream or error.
+ */
+static bool read_all_2d(int fd, void *buf, size_t size) {
+  uint8_t *p = static_cast<uint8_t*>(buf);
+  while (size > 0) {
+    ssize_t n = ::read(fd, p, size);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+/**
+ *  Writes exactly size bytes to a socket, without SIGPIPE if the peer is gone.
+ */
+static bool write_all_2d(int fd, const void *buf, size_t size) {
+  const uint8_t *p = static_cast<const uint8_t*>(buf);
+  while (size > 0) {
+    ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+/**
+ *  Creates a segment holding a copy of a page file.
+ */
+bool SharedTree2D::create(const std::string &name, const std::string &page_file) {
+  close();
+  std::ifstream file(page_file, std::ios::binary | std::ios::ate);
+  if (!file) {
+    std::cerr << "Error: cannot open " << page_file << std::endl;
+    return false;
+  }
+  size_t size = file.tellg();
+  file.seekg(0);
+
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    std::cerr << "Error: cannot create shared memory " << name << ": " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  void *map = (size > 0 && ftruncate(fd, size) == 0)
+              ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    std::cerr << "Error: cannot map shared memory " << name << std::endl;
+    return false;
+  }
+  this->name = name;
+  data = static_cast<uint8_t*>(map);
+  length = size;
+  owner = true;
+
+  if (!file.read(reinterpret_cast<char*>(data), size) || !image.open(data, length)) {
+    std::cerr << "Error: malformed page file " << page_file << std::endl;
+    close();
+    return false;
+  }
+  // The creator only reads the segment from now on, like the workers.
+  mprotect(data, length, PROT_READ);
+  return true;
+}
+
+/**
+ *  Maps an existing segment read-only.
+ */
+bool SharedTree2D::attach(const std::string &name) {
+  close();
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) return false;
+  struct stat st;
+  void *map = (fstat(fd, &st) == 0 && st.st_size > 0)
+              ? mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+  ::close(fd);
+  if (map == MAP_FAILED) return false;
+  this->name = name;
+  data = static_cast<uint8_t*>(map);
+  length = st.st_size;
+  if (!image.open(data, length)) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+/**
+ *  Unmaps the segment, and removes it if it was created here.
+ */
+void SharedTree2D::close() {
+  if (data) munmap(data, length);
+  if (owner) shm_unlink(name.c_str());
+  data = nullptr;
+  length = 0;
+  owner = false;
+  image = PageImage2D();
+}
+
+/**
+ *  Main loop of a worker process: answers requests until the coordinator
+ *  closes its socket.
+ */
+static void worker_main_2d(const std::string &segment, int fd) {
+  SharedTree2D tree;
+  if (!tree.attach(segment)) _exit(1);
+  int32_t q[4];
+  std::vector<uint8_t> reply;
+  while (read_all_2d(fd, q, WORKER2D_REQUEST_SIZE)) {
+    Rectangle query = {q[0], q[1], q[2], q[3]};
+    VObject2D *vo = range_query_paged_2d(tree.getImage(), query);
+    reply.assign(sizeof(uint64_t), 0);
+    serialize_vo_2d(vo, reply);
+    delete_vo_2d(vo);
+    uint64_t size = reply.size() - sizeof(uint64_t);
+    std::memcpy(reply.data(), &size, sizeof(size));
+    if (!write_all_2d(fd, reply.data(), reply.size())) break;
+  }
+  _exit(0);
+}
+
+/**
+ *  Starts worker i, connected to the coordinator by a socket pair.
+ */
+bool WorkerPool2D::spawn(size_t i) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return false;
+  pid_t pid = fork();
+  if (pid < 0) {
+    ::close(fds[0]);
+    ::close(fds[1]);
+    return false;
+  }
+  if (pid == 0) {
+    // The worker keeps only its own end of its own socket.
+    ::close(fds[0]);
+    for (size_t j = 0; j < workers.size(); j++) {
+      if (workers[j].fd >= 0) ::close(workers[j].fd);
+    }
+    worker_main_2d(segment, fds[1]);
+  }
+  ::close(fds[1]);
+  workers[i].pid = pid;
+  workers[i].fd = fds[0];
+  return true;
+}
+
+/**
+ *  Closes the socket of worker i and waits for the process to exit.
+ */
+void WorkerPool2D::reap(size_t i) {
+  if (workers[i].fd >= 0) ::close(workers[i].fd);
+  if (workers[i].pid > 0) waitpid(workers[i].pid, nullptr, 0);
+  workers[i].fd = -1;
+  workers[i].pid = -1;
+}
+
+/**
+ *  Starts the workers.
+ */
+bool WorkerPool2D::start(const std::string &segment, size_t n) {
+  stop();
+  this->segment = segment;
+  workers.assign(n, Worker2D{-1, -1, std::deque<size_t>()});
+  for (size_t i = 0; i < n; i++) {
+    if (!spawn(i)) {
+      std::cerr << "Error: cannot start worker " << i << std::endl;
+      stop();
+      return false;
+    }
+  }
+  return n > 0;
+}
+
+/**
+ *  Stops the workers: closing a socket makes its worker exit.
+ */
+void WorkerPool2D::stop() {
+  for (size_t i = 0; i < workers.size(); i++) reap(i);
+  workers.clear();
+}
+
+/**
+ *  Kills a worker.
+ */
+bool WorkerPool2D::kill(size_t i) {
+  if (i >= workers.size() || workers[i].pid <= 0) return false;
+  return ::kill(workers[i].pid, SIGKILL) == 0;
+}
+
+/**
+ *  Answers a batch of range queries, spreading them over the workers.
+ */
+bool WorkerPool2D::query(const std::vector<Rectangle> &queries, std::vector<std::vector<uint8_t>> &out,
+                         size_t depth) {
+  out.assign(queries.size(), std::vector<uint8_t>());
+  if (workers.empty()) return queries.empty();
+  depth = std::max<size_t>(depth, 1);
+
+  std::deque<size_t> todo;
+  for (size_t i = 0; i < queries.size(); i++) todo.push_back(i);
+  std::vector<size_t> retries(queries.size(), 0);
+  size_t done = 0, failed = 0;
+
+  // A dead worker is restarted and its pending queries go back in the queue.
+  auto recover = [&](size_t w) {
+    for (size_t i : workers[w].pending) {
+      if (retries[i]++ < WORKER2D_MAX_RETRIES) todo.push_front(i);
+      else failed++;
+    }
+    workers[w].pending.clear();
+    reap(w);
+    stats.restarts++;
+    if (!spawn(w)) std::cerr << "Error: cannot restart worker " << w << std::endl;
+  };
+
+  std::vector<pollfd> fds(workers.size());
+  while (done + failed < queries.size()) {
+    // Fill every live worker up to the depth, least loaded first.
+    while (!todo.empty()) {
+      size_t best = workers.size();
+      for (size_t w = 0; w < workers.size(); w++) {
+        if (workers[w].fd >= 0 && workers[w].pending.size() < depth &&
+            (best == workers.size() || workers[w].pending.size() < workers[best].pending.size())) best = w;
+      }
+      if (best == workers.size()) break;
+      size_t i = todo.front();
+      const Rectangle &q = queries[i];
+      int32_t request[4] = {q.lx, q.ly, q.ux, q.uy};
+      workers[best].pending.push_back(i);
+      stats.requests++;
+      todo.pop_front();
+      if (!write_all_2d(workers[best].fd, request, WORKER2D_REQUEST_SIZE)) recover(best);
+    }
+
+    size_t busy = 0;
+    for (size_t w = 0; w < workers.size(); w++) {
+      fds[w] = {workers[w].fd, POLLIN, 0};
+      busy += workers[w].pending.size();
+    }
+    if (busy == 0) {
+      if (todo.empty()) continue;
+      std::cerr << "Error: no worker is running" << std::endl;
+      break;
+    }
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+
+    // Replies come back in request order on each socket.
+    for (size_t w = 0; w < workers.size(); w++) {
+      if (fds[w].fd < 0 || !(fds[w].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+      uint64_t size;
+      if (workers[w].pending.empty() || !read_all_2d(workers[w].fd, &size, sizeof(size))) {
+        recover(w);
+        continue;
+      }
+      std::vector<uint8_t> vo(size);
+      if (!read_all_2d(workers[w].fd, vo.data(), size)) {
+        recover(w);
+        continue;
+      }
+      size_t i = workers[w].pending.front();
+      workers[w].pending.pop_front();
+      stats.replies++;
+      if (size == 0) failed++;
+      else done++;
+      out[i] = std::move(vo);
+    }
+  }
+  return done == queries.size();
+}
+
+#endif
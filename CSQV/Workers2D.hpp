@@ -0,0 +1,154 @@
+/**
+ *  @file Workers2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Multi-process query workers over a tree in POSIX shared memory.
+ *
+ *  A page file (see PageFile2D.hpp) has no pointers, so its image can be
+ *  copied once into a shared-memory segment and queried in place. Worker
+ *  processes map the segment read-only and answer range queries with
+ *  range_query_paged_2d, so the index is never duplicated. A coordinator
+ *  talks to each worker over a local socket, keeps several requests in
+ *  flight per worker, and restarts a worker that dies, sending its
+ *  pending requests again.
+ *
+ *  Wire format (native endian): a request is the query rectangle
+ *  (4 × i32); a reply is a u64 length followed by the VO encoded by
+ *  serialize_vo_2d (length 0 if the query failed).
+ *
+ *  POSIX only: on Windows, create, attach and start fail.
+ */
+
+#ifndef WORKERS2D_H
+#define WORKERS2D_H
+
+#include "PageFile2D.hpp"
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ *  Default number of requests in flight per worker.
+ */
+#define WORKER2D_DEFAULT_DEPTH 8
+
+/**
+ *  Number of times a request is sent again after its worker died.
+ */
+#define WORKER2D_MAX_RETRIES 2
+
+/**
+ *  Page file image in a shared-memory segment.
+ */
+class SharedTree2D {
+private:
+  std::string name;
+  uint8_t *data;
+  size_t length;
+  bool owner;        ///< True if the segment was created here (and is unlinked on close)
+  PageImage2D image;
+
+public:
+  SharedTree2D() : data(nullptr), length(0), owner(false) {}
+  ~SharedTree2D() { close(); }
+  SharedTree2D(const SharedTree2D &) = delete;
+  SharedTree2D &operator=(const SharedTree2D &) = delete;
+
+  /**
+   *  Creates a segment holding a copy of a page file.
+   *  @param name the segment name (e.g. "/csqv-tree")
+   *  @param page_file the page file
+   *  @return false if the file is malformed or the segment cannot be created
+   */
+  bool create(const std::string &name, const std::string &page_file);
+
+  /**
+   *  Maps an existing segment read-only.
+   *  @param name the segment name
+   *  @return false if the segment cannot be mapped or is malformed
+   */
+  bool attach(const std::string &name);
+
+  /**
+   *  Unmaps the segment, and removes it if it was created here.
+   */
+  void close();
+
+  bool isOpen() const { return image.isOpen(); }
+  const PageImage2D &getImage() const { return image; }
+  const std::string &getName() const { return name; }
+  size_t sizeInBytes() const { return length; }
+};
+
+/**
+ *  Statistics of a worker pool.
+ */
+struct WorkerPoolStats2D {
+  size_t requests; ///< Requests sent, retries included
+  size_t replies;  ///< Replies received
+  size_t restarts; ///< Workers restarted after dying
+};
+
+/**
+ *  Coordinator of worker processes answering queries on a shared tree.
+ */
+class WorkerPool2D {
+private:
+  /**
+   *  A worker process and the queries it has not answered yet, in order.
+   */
+  struct Worker2D {
+    int pid;
+    int fd;
+    std::deque<size_t> pending;
+  };
+
+  std::string segment;
+  std::vector<Worker2D> workers;
+  WorkerPoolStats2D stats;
+
+  bool spawn(size_t i);
+  void reap(size_t i);
+
+public:
+  WorkerPool2D() : stats{0, 0, 0} {}
+  ~WorkerPool2D() { stop(); }
+  WorkerPool2D(const WorkerPool2D &) = delete;
+  WorkerPool2D &operator=(const WorkerPool2D &) = delete;
+
+  /**
+   *  Starts the workers.
+   *  @param segment the name of the shared tree segment
+   *  @param n the number of workers
+   *  @return false if a worker cannot be started
+   */
+  bool start(const std::string &segment, size_t n);
+
+  /**
+   *  Stops the workers and waits for them to exit.
+   */
+  void stop();
+
+  /**
+   *  Answers a batch of range queries, spreading them over the workers.
+   *  A query whose worker dies is sent to the restarted worker, up to
+   *  WORKER2D_MAX_RETRIES times.
+   *  @param queries the query rectangles
+   *  @param out receives the encoded VO of each query (empty if it failed)
+   *  @param depth the maximum number of requests in flight per worker
+   *  @return false if some query failed
+   */
+  bool query(const std::vector<Rectangle> &queries, std::vector<std::vector<uint8_t>> &out,
+             size_t depth = WORKER2D_DEFAULT_DEPTH);
+
+  /**
+   *  Kills a worker, for fault-injection tests; it is restarted by the next query.
+   *  @return false if there is no such worker
+   */
+  bool kill(size_t i);
+
+  size_t countWorkers() const { return workers.size(); }
+  const WorkerPoolStats2D &getStats() const { return stats; }
+};
+
+#endif
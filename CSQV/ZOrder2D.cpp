@@ -0,0 +1,163 @@
+/**
+ *  @file ZOrder2D.cpp
+ *  @author Modified for 2D Range Query System
+ */
+
+#include "ZOrder2D.hpp"
+#include "libmorton/morton.h"
+#include <algorithm>
+#include <queue>
+
+/**
+ *  Bits of the x-coordinate (even positions) in a 2D Morton key.
+ */
+#define Z_X_BITS 0x5555555555555555ULL
+
+/**
+ *  Bits of the y-coordinate (odd positions) in a 2D Morton key.
+ */
+#define Z_Y_BITS 0xAAAAAAAAAAAAAAAAULL
+
+/**
+ *  Computes the Z-order key of a location.
+ */
+uint64_t z_encode_2d(int32_t x, int32_t y) {
+  return libmorton::morton2D_64_encode(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+}
+
+/**
+ *  Returns the bits below `bit` belonging to the same dimension as `bit`.
+ */
+static inline uint64_t z_lower_same_dim(unsigned bit) {
+  uint64_t dim = (bit % 2 == 0) ? Z_X_BITS : Z_Y_BITS;
+  return dim & ((uint64_t(1) << bit) - 1);
+}
+
+/**
+ *  Index of the most significant bit where zmin and zmax differ.
+ */
+static inline unsigned z_split_bit(uint64_t zmin, uint64_t zmax) {
+  return 63 - __builtin_clzll(zmin ^ zmax);
+}
+
+/**
+ *  LITMAX: sets the split bit to 0 and the lower bits of its dimension to 1.
+ */
+uint64_t z_litmax(uint64_t zmin, uint64_t zmax) {
+  if (zmin == zmax) return zmax;
+  unsigned bit = z_split_bit(zmin, zmax);
+  return (zmax & ~(uint64_t(1) << bit)) | z_lower_same_dim(bit);
+}
+
+/**
+ *  BIGMIN: sets the split bit to 1 and the lower bits of its dimension to 0.
+ */
+uint64_t z_bigmin(uint64_t zmin, uint64_t zmax) {
+  if (zmin == zmax) return zmin;
+  unsigned bit = z_split_bit(zmin, zmax);
+  return (zmin | (uint64_t(1) << bit)) & ~z_lower_same_dim(bit);
+}
+
+/**
+ *  A box of the Z-order space, given by the keys of its corners.
+ */
+struct ZBox {
+  uint64_t zmin;        ///< Key of the lower corner
+  uint64_t zmax;        ///< Key of the upper corner
+  unsigned __int128 waste; ///< Number of keys of [zmin, zmax] outside the box
+
+  bool operator<(const ZBox &b) const { return waste < b.waste; }
+};
+
+/**
+ *  Creates a box from the keys of its corners.
+ */
+static ZBox make_zbox(uint64_t zmin, uint64_t zmax) {
+  uint_fast32_t lx, ly, ux, uy;
+  libmorton::morton2D_64_decode(zmin, lx, ly);
+  libmorton::morton2D_64_decode(zmax, ux, uy);
+  unsigned __int128 area = (unsigned __int128)(ux - lx + 1) * (uy - ly + 1);
+  unsigned __int128 span = (unsigned __int128)(zmax - zmin) + 1;
+  return ZBox{zmin, zmax, span - area};
+}
+
+/**
+ *  Decomposes a rectangle into Z-intervals.
+ *  Coordinates are unsigned in key space, so a rectangle crossing zero
+ *  is first split into its negative and non-negative parts.
+ */
+std::vector<KeyRange> z_decompose_2d(const Rectangle &q, size_t max_intervals) {
+  std::vector<KeyRange> out;
+  if (q.lx > q.ux || q.ly > q.uy) return out;
+  max_intervals = std::max<size_t>(max_intervals, 1);
+
+  std::vector<std::pair<int32_t, int32_t>> xs, ys;
+  if (q.lx < 0 && q.ux >= 0) xs = {{0, q.ux}, {q.lx, -1}};
+  else xs = {{q.lx, q.ux}};
+  if (q.ly < 0 && q.uy >= 0) ys = {{0, q.uy}, {q.ly, -1}};
+  else ys = {{q.ly, q.uy}};
+
+  std::priority_queue<ZBox> work;
+  for (const auto &x : xs) {
+    for (const auto &y : ys) {
+      work.push(make_zbox(z_encode_2d(x.first, y.first), z_encode_2d(x.second, y.second)));
+    }
+  }
+
+  // Split the box with the most false positives first.
+  while (!work.empty() && work.top().waste > 0 && work.size() < max_intervals) {
+    ZBox b = work.top();
+    work.pop();
+    work.push(make_zbox(b.zmin, z_litmax(b.zmin, b.zmax)));
+    work.push(make_zbox(z_bigmin(b.zmin, b.zmax), b.zmax));
+  }
+
+  while (!work.empty()) {
+    out.push_back({work.top().zmin, work.top().zmax});
+    work.pop();
+  }
+  std::sort(out.begin(), out.end(),
+    [](const KeyRange &a, const KeyRange &b) { return a.lo < b.lo; });
+
+  // Merge intervals that touch.
+  std::vector<KeyRange> merged;
+  for (const KeyRange &r : out) {
+    if (!merged.empty() && merged.back().hi + 1 == r.lo) merged.back().hi = r.hi;
+    else merged.push_back(r);
+  }
+  return merged;
+}
+
+/**
+ *  Performs a rectangle query on a Z-keyed Merkle B+-tree.
+ */
+MBProof2D mb_rect_query_2d(const MBTree2D &tree, const Rectangle &q,
+                           size_t max_intervals, QueryStats2D *stats) {
+  return mb_ranges_query_2d(tree, z_decompose_2d(q, max_intervals), stats);
+}
+
+/**
+ *  Verifies a rectangle query on a Z-keyed Merkle B+-tree.
+ *  Points of the intervals falling outside the rectangle are discarded.
+ */
+MBResult2D verify_mb_rect_2d(const MBProof2D &proof, const Rectangle &q,
+                             size_t max_intervals, QueryStats2D *stats) {
+  MBResult2D res = verify_mb_ranges_2d(proof, z_decompose_2d(q, max_intervals));
+  if (!res.valid || proof.key_type != MBT_KEY_Z) {
+    res.valid = false;
+    return res;
+  }
+
+  size_t kept = 0;
+  for (size_t i = 0; i < res.points.size(); i++) {
+    if (contains(res.points[i], q)) {
+      res.points[kept] = res.points[i];
+      if (!res.digests.empty()) res.digests[kept] = res.digests[i];
+      kept++;
+    }
+  }
+  res.points.resize(kept);
+  if (!res.digests.empty()) res.digests.resize(kept);
+  if (stats) stats->points_returned += kept;
+  return res;
+}
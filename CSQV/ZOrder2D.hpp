@@ -0,0 +1,86 @@
+/**
+ *  @file ZOrder2D.hpp
+ *  @author Modified for 2D Range Query System
+ *
+ *  Decomposition of 2D rectangles into intervals of Morton (Z-order) keys
+ */
+
+#ifndef ZORDER2D_H
+#define ZORDER2D_H
+
+#include "Geometry.hpp"
+#include "MBTree2D.hpp"
+#include <vector>
+
+/**
+ *  Default maximum number of Z-intervals per query rectangle.
+ */
+#define DEFAULT_MAX_INTERVALS 64
+
+/**
+ *  Computes the Z-order key of a location, reinterpreting coordinates as
+ *  unsigned 32-bit integers (x on even bits, y on odd bits).
+ *  @param x the x-coordinate
+ *  @param y the y-coordinate
+ *  @return the Morton key
+ */
+uint64_t z_encode_2d(int32_t x, int32_t y);
+
+/**
+ *  LITMAX: the largest key of the box [zmin, zmax] lying below the split
+ *  hyperplane of its most significant differing bit.
+ *  @param zmin key of the lower corner of the box
+ *  @param zmax key of the upper corner of the box
+ *  @return the largest key of the lower half of the box
+ */
+uint64_t z_litmax(uint64_t zmin, uint64_t zmax);
+
+/**
+ *  BIGMIN: the smallest key of the box [zmin, zmax] lying above the split
+ *  hyperplane of its most significant differing bit.
+ *  @param zmin key of the lower corner of the box
+ *  @param zmax key of the upper corner of the box
+ *  @return the smallest key of the upper half of the box
+ */
+uint64_t z_bigmin(uint64_t zmin, uint64_t zmax);
+
+/**
+ *  Decomposes a rectangle into sorted, disjoint Z-intervals whose union
+ *  covers every key of the rectangle. Intervals are split with LITMAX/BIGMIN,
+ *  always splitting the one with the most keys outside the rectangle, until
+ *  all intervals are exact or max_intervals is reached; the remaining keys
+ *  outside the rectangle are false positives filtered by the client.
+ *  @param q the query rectangle
+ *  @param max_intervals the maximum number of intervals
+ *  @return the Z-intervals
+ */
+std::vector<KeyRange> z_decompose_2d(const Rectangle &q,
+                                     size_t max_intervals = DEFAULT_MAX_INTERVALS);
+
+/**
+ *  Performs a rectangle query on a Z-keyed Merkle B+-tree: the rectangle
+ *  is decomposed into Z-intervals which are scanned with one proof.
+ *  @param tree a Merkle B+-tree keyed on MBT_KEY_Z
+ *  @param q the query rectangle
+ *  @param max_intervals the maximum number of intervals
+ *  @param stats optional statistics collector
+ *  @return the proof
+ */
+MBProof2D mb_rect_query_2d(const MBTree2D &tree, const Rectangle &q,
+                           size_t max_intervals = DEFAULT_MAX_INTERVALS,
+                           QueryStats2D *stats = nullptr);
+
+/**
+ *  Verifies a rectangle query on a Z-keyed Merkle B+-tree. The verifier
+ *  recomputes the decomposition, so max_intervals must match the query.
+ *  @param proof the proof
+ *  @param q the query rectangle
+ *  @param max_intervals the maximum number of intervals
+ *  @param stats optional statistics collector
+ *  @return the verification result, with the points inside the rectangle
+ */
+MBResult2D verify_mb_rect_2d(const MBProof2D &proof, const Rectangle &q,
+                             size_t max_intervals = DEFAULT_MAX_INTERVALS,
+                             QueryStats2D *stats = nullptr);
+
+#endif